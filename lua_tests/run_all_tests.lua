@@ -33,7 +33,8 @@ local extended_tests = {
     "test_algo_extended.lua", -- Cellular automata, erosion, maze, dungeon generation
     "test_geo_extended.lua",  -- Bresenham, bezier, flood fill, shapes, distances
     "test_dialog_extended.lua",-- All dialog widgets and layout methods
-    "test_items.lua"          -- Items namespace, search, info lookup
+    "test_items.lua",         -- Items namespace, search, info lookup
+    "test_grid.lua"           -- Grid userdata, typed algo/noise/geo results
 }
 
 -- Original basic tests (kept for compatibility)
@@ -30,6 +30,7 @@ local test_files = {
     "test_geo_extended.lua",
     "test_dialog_extended.lua",
     "test_items.lua",
+    "test_grid.lua",
     
     -- Compatibility
     "test_noise.lua",
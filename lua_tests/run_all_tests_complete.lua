@@ -37,6 +37,7 @@ local test_files = {
     { name = "test_geo_extended.lua", category = "Extended API" },
     { name = "test_dialog_extended.lua", category = "Extended API" },
     { name = "test_items.lua", category = "Extended API" },
+    { name = "test_grid.lua", category = "Extended API" },
     
     -- Compatibility Tests
     { name = "test_noise.lua", category = "Compatibility" },
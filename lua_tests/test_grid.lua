@@ -0,0 +1,109 @@
+-- @Title: Test Grid API
+-- @Description: Verification tests for the typed Grid userdata and its use by algo/noise/geo.
+local framework = require("framework")
+
+framework.test("Grid construction", function()
+    local g = Grid(8, 4)
+    framework.assert(g.width == 8, "width should be 8")
+    framework.assert(g.height == 4, "height should be 4")
+    framework.assert(g.type == "i32", "default type should be i32")
+
+    local f = Grid.new(3, 3, "f32")
+    framework.assert(f.type == "f32", "Grid.new should accept a type")
+
+    local ok = pcall(function() return Grid(0, 5) end)
+    framework.assert(not ok, "zero-sized grid should error")
+    ok = pcall(function() return Grid(4, 4, "u64") end)
+    framework.assert(not ok, "unknown type should error")
+end)
+
+framework.test("Grid cell access", function()
+    local g = Grid(4, 4, "u8")
+    g:set(2, 3, 7)
+    framework.assert(g:get(2, 3) == 7, "get should return stored value")
+    framework.assert(g:get(1, 1) == 0, "cells start at zero")
+
+    g:set(1, 1, 300)
+    framework.assert(g:get(1, 1) == 255, "u8 should saturate")
+    g:set(1, 2, -5)
+    framework.assert(g:get(1, 2) == 0, "u8 should clamp negatives")
+
+    g:fill(9)
+    framework.assert(g:get(4, 4) == 9, "fill should set every cell")
+
+    local ok = pcall(function() return g:get(5, 1) end)
+    framework.assert(not ok, "out of range get should error")
+end)
+
+framework.test("Grid table conversion", function()
+    local g = Grid.fromTable({ { 1, 2, 3 }, { 4, 5, 6 } })
+    framework.assert(g.width == 3 and g.height == 2, "fromTable should take table dimensions")
+    framework.assert(g:get(3, 2) == 6, "fromTable should copy values")
+
+    local t = g:toTable()
+    framework.assert(type(t) == "table" and t[2][1] == 4, "toTable should round-trip")
+
+    local c = g:clone()
+    c:set(1, 1, 42)
+    framework.assert(g:get(1, 1) == 1, "clone should not share cells")
+end)
+
+framework.test("Grid fillNoise", function()
+    local g = Grid(64, 64, "f32"):fillNoise({ seed = 1234, frequency = 0.05, min = 0, max = 1 })
+    local v = g:get(10, 10)
+    framework.assert(v >= 0 and v <= 1, "fillNoise should honour min/max")
+
+    local same = noise.generateGrid(0, 0, 63, 63, { seed = 1234, frequency = 0.05, asGrid = true })
+    framework.assert(same.type == "f32", "generateGrid asGrid should return an f32 Grid")
+    framework.assert(math.abs((same:get(10, 10) + 1) * 0.5 - v) < 0.0001, "fillNoise and generateGrid should sample the same points")
+end)
+
+framework.test("algo accepts and returns Grid", function()
+    local cave = algo.generateCave(40, 30, { seed = 42, asGrid = true })
+    framework.assert(cave.type == "u8", "generateCave asGrid should default to u8")
+    framework.assert(cave.width == 40 and cave.height == 30, "cave grid dimensions")
+
+    local smoothed = algo.cellularAutomata(cave, { iterations = 2 })
+    framework.assert(smoothed.type == "u8", "cellularAutomata should return a Grid for Grid input")
+
+    local heights = Grid(32, 32, "f32"):fillNoise({ seed = 7, min = 0, max = 1 })
+    local eroded = algo.thermalErode(heights, { iterations = 5 })
+    framework.assert(eroded.type == "f32", "thermalErode should keep the Grid type")
+
+    local maze = algo.generateMaze(21, 21, { seed = 1, asGrid = "i32" })
+    framework.assert(maze.type == "i32", "asGrid should accept a type name")
+
+    local tableCave = algo.generateCave(10, 10, { seed = 42 })
+    framework.assert(type(tableCave) == "table", "without asGrid generators still return tables")
+end)
+
+framework.test("geo floodFill with Grid", function()
+    local g = Grid(5, 5, "u8")
+    local filled = geo.floodFill(g, 1, 1, 3)
+    framework.assert(filled:get(5, 5) == 3, "floodFill should fill connected cells")
+    framework.assert(g:get(5, 5) == 0, "floodFill should not modify its input")
+
+    local positions = geo.getFloodFillPositions(g, 1, 1)
+    framework.assert(#positions == 25, "getFloodFillPositions should accept a Grid")
+end)
+
+framework.test("app.paintGrid", function()
+    framework.assert(type(app.paintGrid) == "function", "app.paintGrid should be function")
+    if not app.hasMap() then
+        return
+    end
+
+    local g = Grid(8, 8, "u8")
+    local origin = Position(100, 100, 7)
+    framework.assert(app.paintGrid(g, origin, {}) == 0, "an empty palette should change nothing")
+
+    local ok = pcall(function() return app.paintGrid(g, origin, { [0] = "no such brush" }) end)
+    framework.assert(not ok, "unknown brush names should error")
+
+    ok = pcall(function()
+        app.transaction("paint", function() app.paintGrid(g, origin, {}) end)
+    end)
+    framework.assert(not ok, "paintGrid should refuse to run inside a transaction")
+end)
+
+framework.summary()
@@ -90,4 +90,17 @@ framework.test("item properties", function()
     end)
 end)
 
+framework.test("item index follows in-place edits", function()
+    if not app.hasMap() then return end
+    
+    -- No transaction: the tile is edited in place
+    local tile = app.map:getOrCreateTile(100, 104, 7)
+    local before = app.map:countItems(2160)
+    local item = tile:addItem(2160)
+    framework.assert(app.map:countItems(2160) == before + 1, "countItems should include an item added in place")
+    
+    tile:removeItem(item)
+    framework.assert(app.map:countItems(2160) == before, "countItems should drop an item removed in place")
+end)
+
 framework.summary()
@@ -32,6 +32,7 @@
 #include "rendering/core/light_source_manager.h"
 #include "rendering/core/forced_light_zone.h"
 #include "rendering/core/custom_item_light.h"
+#include "rendering/core/sprite_disk_cache.h"
 
 #include "game/sprites.h"
 #include "editor/editor.h"
@@ -56,6 +57,7 @@
 #include "game/creature.h"
 
 #include "ingame_preview/ingame_preview_manager.h"
+#include "io/otbm/map_diff_otbm.h"
 
 #include <wx/snglinst.h>
 #include <wx/stdpaths.h>
@@ -64,12 +66,17 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <thread>
 #include <chrono>
+#include <filesystem>
 
 #include "../brushes/icon/editor_icon.xpm"
 
 wxIMPLEMENT_APP_NO_MAIN(Application);
 
 int main(int argc, char** argv) {
+	// Map diff and merge run headless, without starting the editor
+	if (const int exit_code = MapDiffOTBM::RunCommandLine(argc, argv); exit_code >= 0) {
+		return exit_code;
+	}
 	return wxEntry(argc, argv);
 }
 
@@ -364,10 +371,21 @@ bool Application::OnInit() {
 	}
 #endif
 
-	FileName save_failed_file = FileSystem::GetLocalDataDirectory();
-	save_failed_file.SetName(".saving.txt");
-	if (save_failed_file.FileExists()) {
-		std::ifstream f(nstr(save_failed_file.GetFullPath()).c_str(), std::ios::in);
+	// Every map being saved writes its own ".saving-<id>.txt" runfile
+	std::vector<std::string> save_failed_files;
+	{
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(nstr(FileSystem::GetLocalDataDirectory()), ec)) {
+			const std::string name = entry.path().filename().string();
+			if (name.starts_with(".saving") && name.ends_with(".txt")) {
+				save_failed_files.push_back(entry.path().string());
+			}
+		}
+	}
+
+	bool recovered = false;
+	for (const std::string& save_failed_file : save_failed_files) {
+		std::ifstream f(save_failed_file.c_str(), std::ios::in);
 
 		std::string backup_otbm, backup_house, backup_spawn;
 
@@ -377,7 +395,7 @@ bool Application::OnInit() {
 
 		// Remove the file
 		f.close();
-		std::remove(nstr(save_failed_file.GetFullPath()).c_str());
+		std::remove(save_failed_file.c_str());
 
 		// Query file retrieval if possible
 		if (!backup_otbm.empty()) {
@@ -409,10 +427,13 @@ bool Application::OnInit() {
 
 				// Load the map
 				g_gui.LoadMap(wxstr(backup_otbm.substr(0, backup_otbm.size() - 1)));
-				return true;
+				recovered = true;
 			}
 		}
 	}
+	if (recovered) {
+		return true;
+	}
 	// Keep track of first event loop entry
 	m_startup = true;
 	return true;
@@ -483,6 +504,7 @@ void Application::Unload() {
 
 	g_gui.CloseAllEditors();
 	g_version.UnloadVersion();
+	SpriteDiskCache::waitForSaves();
 	g_hotkeys.SaveHotkeys();
 	g_gui.root->SaveRecentFiles();
 	ClientVersion::saveVersions();
@@ -76,6 +76,12 @@ GeneralPage::GeneralPage(wxWindow* parent) : ScrollablePreferencesPage(parent) {
 		"Create a backup when saving maps so you have a recovery point if something goes wrong.",
 		g_settings.getBoolean(Config::ALWAYS_MAKE_BACKUP)
 	);
+	use_action_journal_chkbox = PreferencesLayout::AddCheckBoxRow(
+		safety_section,
+		"Journal changes between saves",
+		"Record every edit next to the map so unsaved work can be recovered after a crash. Applies to maps opened or saved afterwards.",
+		g_settings.getBoolean(Config::USE_ACTION_JOURNAL)
+	);
 	enable_tileset_editing_chkbox = PreferencesLayout::AddCheckBoxRow(
 		safety_section,
 		"Enable tileset editing",
@@ -197,6 +203,7 @@ void GeneralPage::UpdatePositionPreview() {
 void GeneralPage::Apply() {
 	g_settings.setInteger(Config::WELCOME_DIALOG, show_welcome_dialog_chkbox->GetValue());
 	g_settings.setInteger(Config::ALWAYS_MAKE_BACKUP, always_make_backup_chkbox->GetValue());
+	g_settings.setInteger(Config::USE_ACTION_JOURNAL, use_action_journal_chkbox->GetValue());
 	g_settings.setInteger(Config::USE_UPDATER, update_check_on_startup_chkbox->GetValue());
 	g_settings.setInteger(Config::ONLY_ONE_INSTANCE, only_one_instance_chkbox->GetValue());
 	g_settings.setInteger(Config::UNDO_SIZE, undo_size_spin->GetValue());
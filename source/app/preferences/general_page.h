@@ -20,6 +20,7 @@ private:
 
 	wxCheckBox* show_welcome_dialog_chkbox = nullptr;
 	wxCheckBox* always_make_backup_chkbox = nullptr;
+	wxCheckBox* use_action_journal_chkbox = nullptr;
 	wxCheckBox* update_check_on_startup_chkbox = nullptr;
 	wxCheckBox* only_one_instance_chkbox = nullptr;
 	wxCheckBox* enable_tileset_editing_chkbox = nullptr;
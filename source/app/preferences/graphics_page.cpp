@@ -165,6 +165,12 @@ GraphicsPage::GraphicsPage(wxWindow* parent) : ScrollablePreferencesPage(parent)
 		"Load sprites into memory up front for faster browsing and rendering at the cost of higher RAM use.",
 		g_settings.getBoolean(Config::USE_MEMCACHED_SPRITES)
 	);
+	sprite_disk_cache_chkbox = PreferencesLayout::AddCheckBoxRow(
+		performance_section,
+		"Keep decoded sprites on disk",
+		"Store recently used sprites decoded between sessions so the map shows fully textured right after loading a client version.",
+		g_settings.getBoolean(Config::SPRITE_DISK_CACHE)
+	);
 	PreferencesLayout::AddNotice(
 		performance_section,
 		"Changing sprite caching requires an application restart before the new loading mode takes effect.",
@@ -201,6 +207,7 @@ void GraphicsPage::Apply() {
 		must_restart = true;
 	}
 	g_settings.setInteger(Config::USE_MEMCACHED_SPRITES_TO_SAVE, use_memcached_chkbox->GetValue());
+	g_settings.setInteger(Config::SPRITE_DISK_CACHE, sprite_disk_cache_chkbox->GetValue());
 
 	g_settings.setInteger(Config::ANTI_ALIASING, anti_aliasing_chkbox->GetValue());
 	g_settings.setString(Config::SCREEN_SHADER, nstr(screen_shader_choice->GetStringSelection()));
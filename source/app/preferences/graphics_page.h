@@ -18,6 +18,7 @@ private:
 	wxCheckBox* hide_items_when_zoomed_chkbox = nullptr;
 	wxCheckBox* icon_selection_shadow_chkbox = nullptr;
 	wxCheckBox* use_memcached_chkbox = nullptr;
+	wxCheckBox* sprite_disk_cache_chkbox = nullptr;
 	wxCheckBox* anti_aliasing_chkbox = nullptr;
 
 	wxChoice* screen_shader_choice = nullptr;
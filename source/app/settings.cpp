@@ -361,7 +361,9 @@ void Settings::IO(IOMode mode) {
 	Bool(BORDERIZE_DRAG, true);
 	Int(BORDERIZE_DRAG_THRESHOLD, 6000);
 	Int(BORDERIZE_PASTE_THRESHOLD, 10000);
+	Int(FLOOD_FILL_LIMIT, 4194304); // tiles, a 2048x2048 region
 	Bool(ALWAYS_MAKE_BACKUP, false);
+	Bool(USE_ACTION_JOURNAL, true);
 	Bool(USE_AUTOMAGIC, true);
 	Bool(PRESERVE_MANUAL_BORDERS, true);
 	Bool(HOUSE_BRUSH_REMOVE_ITEMS, false);
@@ -405,6 +407,7 @@ void Settings::IO(IOMode mode) {
 	Int(TEXTURE_CLEAN_PULSE, 15);
 	Int(TEXTURE_LONGEVITY, 20);
 	Int(TEXTURE_CLEAN_THRESHOLD, 2500);
+	Int(ATLAS_VRAM_BUDGET, 1024); // MB, rounded down to whole 64 MB atlas layers
 	Int(SOFTWARE_CLEAN_THRESHOLD, 1800);
 	Int(SOFTWARE_CLEAN_SIZE, 500);
 	Int(ICON_BACKGROUND, 0);
@@ -413,6 +416,7 @@ void Settings::IO(IOMode mode) {
 	String(SCREENSHOT_DIRECTORY, "");
 	String(SCREENSHOT_FORMAT, "png");
 	IntToSave(USE_MEMCACHED_SPRITES, 0); // This is special, keeping as IntToSave for now
+	Bool(SPRITE_DISK_CACHE, true);
 	Int(MINIMAP_UPDATE_DELAY, 333);
 	Bool(MINIMAP_VIEW_BOX, true);
 	String(MINIMAP_EXPORT_DIR, "");
@@ -37,9 +37,11 @@ namespace Config {
 		TEXTURE_CLEAN_PULSE,
 		TEXTURE_CLEAN_THRESHOLD,
 		TEXTURE_LONGEVITY,
+		ATLAS_VRAM_BUDGET,
 		HARD_REFRESH_RATE,
 		USE_MEMCACHED_SPRITES,
 		USE_MEMCACHED_SPRITES_TO_SAVE,
+		SPRITE_DISK_CACHE,
 		SOFTWARE_CLEAN_THRESHOLD,
 		SOFTWARE_CLEAN_SIZE,
 		TRANSPARENT_FLOORS,
@@ -87,8 +89,10 @@ namespace Config {
 		BORDERIZE_DRAG,
 		BORDERIZE_DRAG_THRESHOLD,
 		BORDERIZE_PASTE_THRESHOLD,
+		FLOOD_FILL_LIMIT,
 		ICON_BACKGROUND,
 		ALWAYS_MAKE_BACKUP,
+		USE_ACTION_JOURNAL,
 		USE_AUTOMAGIC,
 		PRESERVE_MANUAL_BORDERS,
 		HOUSE_BRUSH_REMOVE_ITEMS,
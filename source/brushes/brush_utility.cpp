@@ -11,20 +11,88 @@
 #include "brushes/ground/ground_brush.h"
 #include "map/map.h"
 #include "map/tile.h"
+#include "map/map_region.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
-#include <stack>
+#include <limits>
+#include <unordered_map>
 #include <unordered_set>
 
 #ifndef M_PI
 	#define M_PI 3.14159265358979323846
 #endif
 
-std::vector<bool> BrushUtility::processed;
-int BrushUtility::countMaxFills = 0;
-int BrushUtility::fill_width = 100;
-int BrushUtility::fill_height = 100;
+namespace {
+	// Visited tiles of one fill as 64-tile row words, so a span costs one
+	// lookup per word instead of one per tile.
+	class FillMask {
+	public:
+		bool test(int x, int y) {
+			const uint64_t* word = find(x, y);
+			return word && ((*word >> (x & 63)) & 1);
+		}
+
+		void setSpan(int y, int x0, int x1) {
+			for (int x = x0; x <= x1;) {
+				const int last = std::min(x1, x | 63);
+				const int count = last - x + 1;
+				const uint64_t bits = count == 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1) << (x & 63);
+				words[key(x, y)] |= bits;
+				x = last + 1;
+			}
+			// Inserting may rehash; drop the cached word pointer
+			cached_key = ~uint64_t(0);
+			cached_word = nullptr;
+		}
+
+	private:
+		static uint64_t key(int x, int y) {
+			return (static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32) | static_cast<uint32_t>(x >> 6);
+		}
+
+		const uint64_t* find(int x, int y) {
+			const uint64_t k = key(x, y);
+			if (k != cached_key) {
+				auto it = words.find(k);
+				cached_key = k;
+				cached_word = it != words.end() ? &it->second : nullptr;
+			}
+			return cached_word;
+		}
+
+		std::unordered_map<uint64_t, uint64_t> words;
+		uint64_t cached_key = ~uint64_t(0);
+		const uint64_t* cached_word = nullptr;
+	};
+
+	// Reads tiles of one floor along a row, fetching each 4x4 MapNode once.
+	class RowReader {
+	public:
+		RowReader(Map* map, int z) :
+			map(map), z(z) { }
+
+		const Tile* get(int x, int y) {
+			const int leaf_x = x >> 2;
+			const int leaf_y = y >> 2;
+			if (leaf_x != cached_x || leaf_y != cached_y) {
+				cached_x = leaf_x;
+				cached_y = leaf_y;
+				MapNode* node = map->getLeaf(x, y);
+				floor = node ? node->getFloor(z) : nullptr;
+			}
+			return floor ? floor->locs[(x & 3) * 4 + (y & 3)].get() : nullptr;
+		}
+
+	private:
+		Map* map;
+		int z;
+		int cached_x = std::numeric_limits<int>::min();
+		int cached_y = std::numeric_limits<int>::min();
+		Floor* floor = nullptr;
+	};
+}
 
 void BrushUtility::GetTilesToDraw(int mouse_map_x, int mouse_map_y, int floor, std::vector<Position>* tilestodraw, std::vector<Position>* tilestoborder, bool fill, const FillArea& fill_area) {
 	if (fill) {
@@ -57,32 +125,59 @@ void BrushUtility::GetTilesToDraw(int mouse_map_x, int mouse_map_y, int floor, s
 			}
 		}
 
-		fill_width = fill_area.width;
-		fill_height = fill_area.height;
-		processed.assign(fill_width * fill_height, false);
-		countMaxFills = 0;
-		const size_t draw_size_before = tilestodraw ? tilestodraw->size() : 0;
-		FloodFill(&g_gui.GetCurrentMap(), position, fill_width / 2, fill_height / 2, fill_width, fill_height, oldBrush, tilestodraw);
+		Map& map = g_gui.GetCurrentMap();
+		int min_x = 1;
+		int min_y = 1;
+		int max_x = map.getWidth() - 1;
+		int max_y = map.getHeight() - 1;
+		if (!oldBrush) {
+			// Empty space has no natural edge; stay within the requested box
+			min_x = std::max(min_x, mouse_map_x - fill_area.width / 2 + 1);
+			min_y = std::max(min_y, mouse_map_y - fill_area.height / 2 + 1);
+			max_x = std::min(max_x, mouse_map_x + fill_area.width / 2 - 1);
+			max_y = std::min(max_y, mouse_map_y + fill_area.height / 2 - 1);
+		}
+
+		std::vector<FillSpan> spans;
+		if (!FloodFill(&map, position, min_x, min_y, max_x, max_y, fill_area.max_tiles, oldBrush, spans)) {
+			g_gui.SetStatusText(wxString::Format("Fill area is larger than the flood fill limit (%d tiles).", fill_area.max_tiles));
+			return;
+		}
+
+		if (tilestodraw) {
+			for (const FillSpan& span : spans) {
+				for (int x = span.x0; x <= span.x1; ++x) {
+					tilestodraw->push_back(Position(x, span.y, floor));
+				}
+			}
+		}
 
 		// Auto-magic borders need the perimeter of the filled region to recompute neighbours
 		// (mountain/grass/water borders, etc.). The non-fill branch builds this naturally
-		// from the footprint loop; for flood-fill we expand each filled tile by its 3x3
-		// neighbourhood with dedup.
-		if (tilestoborder && tilestodraw) {
-			std::unordered_set<int64_t> border_seen;
-			const auto borderKey = [](int x, int y) -> int64_t {
-				return (static_cast<int64_t>(static_cast<uint32_t>(y)) << 32) | static_cast<uint32_t>(x);
-			};
-			for (size_t i = draw_size_before; i < tilestodraw->size(); ++i) {
-				const Position& p = (*tilestodraw)[i];
+		// from the footprint loop; for flood-fill every span is grown by one tile in each
+		// direction and the overlapping row intervals are merged.
+		if (tilestoborder) {
+			std::vector<FillSpan> grown;
+			grown.reserve(spans.size() * 3);
+			for (const FillSpan& span : spans) {
 				for (int dy = -1; dy <= 1; ++dy) {
-					for (int dx = -1; dx <= 1; ++dx) {
-						const int nx = p.x + dx;
-						const int ny = p.y + dy;
-						if (border_seen.insert(borderKey(nx, ny)).second) {
-							tilestoborder->push_back(Position(nx, ny, floor));
-						}
-					}
+					grown.push_back({ span.y + dy, span.x0 - 1, span.x1 + 1 });
+				}
+			}
+			std::ranges::sort(grown, [](const FillSpan& a, const FillSpan& b) {
+				return a.y != b.y ? a.y < b.y : a.x0 < b.x0;
+			});
+
+			size_t i = 0;
+			while (i < grown.size()) {
+				const int y = grown[i].y;
+				int x0 = grown[i].x0;
+				int x1 = grown[i].x1;
+				for (++i; i < grown.size() && grown[i].y == y && grown[i].x0 <= x1 + 1; ++i) {
+					x1 = std::max(x1, grown[i].x1);
+				}
+				for (int x = x0; x <= x1; ++x) {
+					tilestoborder->push_back(Position(x, y, floor));
 				}
 			}
 		}
@@ -114,59 +209,77 @@ void BrushUtility::GetTilesToDraw(int mouse_map_x, int mouse_map_y, int floor, s
 	}
 }
 
-bool BrushUtility::FloodFill(Map* map, const Position& center, int start_x, int start_y, int fw, int fh, GroundBrush* brush, std::vector<Position>* positions) {
-	struct Cell { int x, y; };
-	std::stack<Cell> stack;
-	stack.push({start_x, start_y});
+bool BrushUtility::FloodFill(Map* map, const Position& center, int min_x, int min_y, int max_x, int max_y, int max_tiles, GroundBrush* brush, std::vector<FillSpan>& spans) {
+	RowReader reader(map, center.z);
+	FillMask visited;
 
-	int maxFills = fw * fh;
+	const auto matches = [&](int x, int y) {
+		const Tile* tile = reader.get(x, y);
+		if (!brush) {
+			return !tile || !tile->ground;
+		}
+		if (!tile) {
+			return false;
+		}
+		const GroundBrush* groundBrush = tile->getGroundBrush();
+		return groundBrush && groundBrush->getID() == brush->getID();
+	};
+	const auto fillable = [&](int x, int y) {
+		return !visited.test(x, y) && matches(x, y);
+	};
 
-	while (!stack.empty()) {
-		auto [x, y] = stack.top();
-		stack.pop();
+	struct Seed {
+		int x, y;
+	};
+	std::vector<Seed> seeds;
+	seeds.push_back({ center.x, center.y });
 
-		if (x <= 0 || y <= 0 || x >= fw || y >= fh) {
-			continue;
-		}
+	int64_t filled = 0;
+	while (!seeds.empty()) {
+		const Seed seed = seeds.back();
+		seeds.pop_back();
 
-		if (processed[GetFillIndex(x, y)]) {
+		if (seed.x < min_x || seed.y < min_y || seed.x > max_x || seed.y > max_y || !fillable(seed.x, seed.y)) {
 			continue;
 		}
 
-		processed[GetFillIndex(x, y)] = true;
-
-		int px = (center.x + x) - (fw / 2);
-		int py = (center.y + y) - (fh / 2);
-		if (px <= 0 || py <= 0 || px >= map->getWidth() || py >= map->getHeight()) {
-			continue;
+		// Grow the seed into the widest run of matching tiles on its row
+		int x0 = seed.x;
+		while (x0 > min_x && fillable(x0 - 1, seed.y)) {
+			--x0;
+		}
+		int x1 = seed.x;
+		while (x1 < max_x && fillable(x1 + 1, seed.y)) {
+			++x1;
 		}
 
-		Tile* tile = map->getTile(px, py, center.z);
-		if ((tile && tile->ground && !brush) || (!tile && brush)) {
-			continue;
+		visited.setSpan(seed.y, x0, x1);
+		spans.push_back({ seed.y, x0, x1 });
+		filled += x1 - x0 + 1;
+		if (filled > max_tiles) {
+			return false;
 		}
 
-		if (tile && brush) {
-			GroundBrush* groundBrush = tile->getGroundBrush();
-			if (!groundBrush || groundBrush->getID() != brush->getID()) {
+		// One seed per matching run on the rows above and below
+		for (const int y : { seed.y - 1, seed.y + 1 }) {
+			if (y < min_y || y > max_y) {
 				continue;
 			}
+			bool in_run = false;
+			for (int x = x0; x <= x1; ++x) {
+				if (fillable(x, y)) {
+					if (!in_run) {
+						seeds.push_back({ x, y });
+						in_run = true;
+					}
+				} else {
+					in_run = false;
+				}
+			}
 		}
-
-		positions->push_back(Position(px, py, center.z));
-
-		countMaxFills++;
-		if (countMaxFills > maxFills) {
-			return true;
-		}
-
-		stack.push({x - 1, y});
-		stack.push({x, y - 1});
-		stack.push({x + 1, y});
-		stack.push({x, y + 1});
 	}
 
-	return false;
+	return true;
 }
 
 Position BrushUtility::SnapToAngle(const Position& a, const Position& b, int snap_degrees) {
@@ -12,8 +12,12 @@ class Map;
 class GroundBrush;
 
 struct FillArea {
+	// Fills over empty tiles are clipped to this box around the click (usually
+	// the visible area); ground regions may span the whole floor.
 	int width = 100;
 	int height = 100;
+	// Regions with more tiles than this are not filled at all.
+	int max_tiles = 4194304;
 };
 
 class BrushUtility {
@@ -36,17 +40,16 @@ public:
 	static Position SnapToAngle(const Position& a, const Position& b, int snap_degrees = 45);
 
 private:
-	static bool FloodFill(Map* map, const Position& center, int x, int y, int fill_width, int fill_height, GroundBrush* brush, std::vector<Position>* positions);
-
-	static int fill_width;
-	static int fill_height;
-
-	static inline int GetFillIndex(int x, int y) {
-		return x + fill_width * y;
-	}
-
-	static std::vector<bool> processed;
-	static int countMaxFills;
+	struct FillSpan {
+		int y;
+		int x0;
+		int x1; // inclusive
+	};
+
+	// Scanline fill over the tiles of center.z whose ground brush is `brush`
+	// (or that have no ground when brush is null), limited to the given box.
+	// Returns false when the region has more than max_tiles tiles.
+	static bool FloodFill(Map* map, const Position& center, int min_x, int min_y, int max_x, int max_y, int max_tiles, GroundBrush* brush, std::vector<FillSpan>& spans);
 };
 
 #endif
@@ -59,7 +59,7 @@ void CarpetBrush::undraw(BaseMap* map, Tile* tile) {
 	// With DISABLE_CARPET_INTERACTION on, this brush only touches its own
 	// carpets, so different carpet brushes can stack on the same tile.
 	const bool isolated = g_settings.getBoolean(Config::DISABLE_CARPET_INTERACTION);
-	std::erase_if(tile->items, [this, isolated](const auto& item) {
+	tile->items.eraseIf([this, isolated](const auto& item) {
 		if (!item->isCarpet() || item->getCarpetBrush() == nullptr) {
 			return false;
 		}
@@ -57,12 +57,12 @@ uint16_t CarpetBrushItems::getRandomItem(BorderType alignment) const {
 	return 0;
 }
 
-uint16_t CarpetBrushItems::pickFromGroup(const CarpetGroup& group) {
+uint16_t CarpetBrushItems::pickFromGroup(const CarpetGroup& group, std::mt19937& rng) {
 	if (group.total_chance <= 0 || group.items.empty()) {
 		return 0;
 	}
 
-	int32_t chance = random(1, group.total_chance);
+	int32_t chance = random(rng, 1, group.total_chance);
 	for (const auto& item : group.items) {
 		if (chance <= item.chance) {
 			return item.id;
@@ -42,7 +42,7 @@ public:
 	}
 
 	// Helper to pick from a specific group
-	static uint16_t pickFromGroup(const CarpetGroup& group);
+	static uint16_t pickFromGroup(const CarpetGroup& group, std::mt19937& rng = getRandomGenerator());
 
 	// Using std::array instead of C-style array for better safety
 	std::array<CarpetGroup, 14> m_groups;
@@ -45,7 +45,7 @@ uint32_t AutoBorder::getTileId(int direction) const {
 	return tiles[direction][0].id;
 }
 
-uint32_t AutoBorder::getRandomTileId(int direction) const {
+uint32_t AutoBorder::getRandomTileId(int direction, std::mt19937& rng) const {
 	if (direction < 0 || direction >= 13 || tiles[direction].empty()) {
 		return 0;
 	}
@@ -64,7 +64,7 @@ uint32_t AutoBorder::getRandomTileId(int direction) const {
 		return items[0].id;
 	}
 
-	int roll = std::rand() % totalChance;
+	int roll = random(rng, 0, totalChance - 1);
 	int cumulative = 0;
 	for (const auto& item : items) {
 		cumulative += item.chance;
@@ -75,7 +75,7 @@ public:
 	 * @brief Returns a random item ID for a given direction based on chance weights.
 	 * Falls back to the first item if only one exists.
 	 */
-	uint32_t getRandomTileId(int direction) const;
+	uint32_t getRandomTileId(int direction, std::mt19937& rng = getRandomGenerator()) const;
 
 	/**
 	 * @brief Checks if a given item ID exists in any direction of this border.
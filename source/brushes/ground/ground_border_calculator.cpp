@@ -314,7 +314,7 @@ namespace {
 
 		// Same border cleanup policy as the normal pipeline.
 		const bool preserveManual = g_settings.getBoolean(Config::PRESERVE_MANUAL_BORDERS);
-		std::erase_if(tile->items, [preserveManual](const std::unique_ptr<Item>& item) {
+		tile->items.eraseIf([preserveManual](const std::unique_ptr<Item>& item) {
 			if (!item->isBorder()) return false;
 			return preserveManual ? item->isAutoPlaced() : true;
 		});
@@ -418,6 +418,39 @@ namespace {
 			}
 		}
 	}
+
+	// FNV-1a over what the traditional pipeline reads: the ground brushes of
+	// the tile and its 8 neighbours and the border settings.
+	uint32_t borderInputHash(const GroundBrush* borderBrush, const std::pair<bool, GroundBrush*> (&neighbours)[8], bool preserveManual, bool carpetLike) {
+		uint32_t hash = 2166136261u;
+		auto mix = [&hash](uint32_t value) {
+			hash = (hash ^ value) * 16777619u;
+		};
+		mix((preserveManual ? 1u : 0u) | (carpetLike ? 2u : 0u));
+		mix(borderBrush ? borderBrush->getID() : 0);
+		for (const auto& [visited, brush] : neighbours) {
+			mix(brush ? brush->getID() : 0);
+		}
+		return hash;
+	}
+
+	// Completes an input hash with what the pipeline leaves on the tile: the
+	// optional border flag and the border items. A tile whose stored
+	// signature still matches already carries the borders a new pass would
+	// stamp, so the pass can be skipped. 0 is reserved for "unknown".
+	uint32_t borderSignature(uint32_t inputHash, const Tile* tile) {
+		uint32_t hash = inputHash;
+		auto mix = [&hash](uint32_t value) {
+			hash = (hash ^ value) * 16777619u;
+		};
+		mix(tile->hasOptionalBorder() ? 1u : 0u);
+		for (const auto& item : tile->items) {
+			if (item->isBorder()) {
+				mix((uint32_t(item->getID()) << 1) | (item->isAutoPlaced() ? 1u : 0u));
+			}
+		}
+		return hash != 0 ? hash : 1;
+	}
 } // namespace
 
 void GroundBorderCalculator::calculate(BaseMap* map, Tile* tile) {
@@ -435,6 +468,7 @@ void GroundBorderCalculator::calculate(BaseMap* map, Tile* tile) {
 	// brush (edge pieces or filled ground) use the carpet pipeline. Everything
 	// else runs the traditional auto-border below, untouched.
 	if (g_settings.getBoolean(Config::CARPET_FILL_BORDERS) && isCarpetFillTile(tile)) {
+		tile->borderSignature = 0;
 		calculateCarpetFill(map, tile);
 		return;
 	}
@@ -467,6 +501,14 @@ void GroundBorderCalculator::calculate(BaseMap* map, Tile* tile) {
 		neighbours[i] = { false, extractGroundBrushFromTile(map, nx, ny, z) };
 	}
 
+	// Nothing this pass reads has changed since it last ran on the tile
+	const bool preserveManual = g_settings.getBoolean(Config::PRESERVE_MANUAL_BORDERS);
+	const bool carpetLike = g_settings.getBoolean(Config::CARPET_LIKE_GROUND_BORDERS);
+	const uint32_t inputHash = borderInputHash(borderBrush, neighbours, preserveManual, carpetLike);
+	if (tile->borderSignature != 0 && tile->borderSignature == borderSignature(inputHash, tile)) {
+		return;
+	}
+
 	static std::vector<const GroundBrush::BorderBlock*> specificList;
 	specificList.clear();
 
@@ -713,8 +755,7 @@ void GroundBorderCalculator::calculate(BaseMap* map, Tile* tile) {
 	// Clean borders before recomputing. If the user opted in to preserving manual
 	// borders (the default), only auto-placed borders are wiped; otherwise we fall
 	// back to the legacy behavior of clearing everything flagged as a border.
-	const bool preserveManual = g_settings.getBoolean(Config::PRESERVE_MANUAL_BORDERS);
-	std::erase_if(tile->items, [preserveManual](const std::unique_ptr<Item>& item) {
+	tile->items.eraseIf([preserveManual](const std::unique_ptr<Item>& item) {
 		if (!item->isBorder()) return false;
 		return preserveManual ? item->isAutoPlaced() : true;
 	});
@@ -741,8 +782,6 @@ void GroundBorderCalculator::calculate(BaseMap* map, Tile* tile) {
 	// pipeline: ONE BorderType per cluster (via ground_carpet_like_table) and
 	// only one sprite gets stamped on the tile. This produces clean silhouettes
 	// like the carpet brush instead of the legacy ground compositing behavior.
-	const bool carpetLike = g_settings.getBoolean(Config::CARPET_LIKE_GROUND_BORDERS);
-
 	while (!borderList.empty()) {
 		GroundBrush::BorderCluster& borderCluster = borderList.back();
 		if (!borderCluster.border) {
@@ -865,4 +904,6 @@ void GroundBorderCalculator::calculate(BaseMap* map, Tile* tile) {
 			}
 		}
 	}
+
+	tile->borderSignature = borderSignature(inputHash, tile);
 }
@@ -76,7 +76,7 @@ void GroundBrush::undraw(BaseMap* map, Tile* tile) {
 	ASSERT(tile);
 	if (carpet_fill && g_settings.getBoolean(Config::CARPET_FILL_BORDERS)) {
 		// Carpet Fill margin tiles carry edge pieces instead of this ground.
-		std::erase_if(tile->items, [this](const std::unique_ptr<Item>& item) {
+		tile->items.eraseIf([this](const std::unique_ptr<Item>& item) {
 			return item->isBorder() && getCarpetPieceOwner(item->getID()) == this;
 		});
 	}
@@ -132,11 +132,11 @@ void GroundBrush::draw(BaseMap* map, Tile* tile, void* parameter) {
 	TerrainPlacement::placeBrushItem(*tile, getRandomGroundItemId());
 }
 
-uint16_t GroundBrush::getRandomGroundItemId() const {
+uint16_t GroundBrush::getRandomGroundItemId(std::mt19937& rng) const {
 	if (border_items.empty()) {
 		return 0;
 	}
-	int chance = random(1, total_chance);
+	int chance = random(rng, 1, total_chance);
 	for (const auto& item_block : border_items) {
 		if (chance < item_block.chance) {
 			return item_block.id;
@@ -85,7 +85,7 @@ public:
 	}
 
 	// Random center ground id using the <item chance> weights.
-	uint16_t getRandomGroundItemId() const;
+	uint16_t getRandomGroundItemId(std::mt19937& rng = getRandomGenerator()) const;
 
 	// Carpet Fill support: reverse index from edge-piece item ids to the ground
 	// brush whose outer border owns them. Margin tiles keep their old ground,
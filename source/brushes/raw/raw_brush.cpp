@@ -65,7 +65,7 @@ void RAWBrush::undraw(BaseMap* map, Tile* tile) {
 	if (tile->ground && tile->ground->getID() == item_id) {
 		tile->ground = nullptr;
 	}
-	std::erase_if(tile->items, [brush_item_id = item_id](const auto& item) {
+	tile->items.eraseIf([brush_item_id = item_id](const auto& item) {
 		return item->getID() == brush_item_id;
 	});
 }
@@ -78,7 +78,7 @@ void RAWBrush::draw(BaseMap* map, Tile* tile, void* parameter) {
 
 	bool b = parameter ? *reinterpret_cast<bool*>(parameter) : false;
 	if ((g_settings.getInteger(Config::RAW_LIKE_SIMONE) && !b) && definition.hasFlag(ItemFlag::AlwaysOnBottom) && definition.attribute(ItemAttributeKey::AlwaysOnTopOrder) == 2) {
-		std::erase_if(tile->items, [topOrder = static_cast<int>(definition.attribute(ItemAttributeKey::AlwaysOnTopOrder))](const auto& item) {
+		tile->items.eraseIf([topOrder = static_cast<int>(definition.attribute(ItemAttributeKey::AlwaysOnTopOrder))](const auto& item) {
 			return item->getTopOrder() == topOrder;
 		});
 	}
@@ -47,7 +47,7 @@ bool TableBrush::canDraw(BaseMap* map, const Position& position) const {
 }
 
 void TableBrush::undraw(BaseMap* map, Tile* t) {
-	std::erase_if(t->items, [this](const auto& item) {
+	t->items.eraseIf([this](const auto& item) {
 		return item->isTable() && item->getTableBrush() == this;
 	});
 }
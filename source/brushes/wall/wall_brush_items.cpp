@@ -31,7 +31,7 @@ void WallBrushItems::addDoorItem(int alignment, uint16_t id, ::DoorType type, bo
 	door_items[alignment].push_back(item);
 }
 
-uint16_t WallBrushItems::getRandomWallId(int alignment) const {
+uint16_t WallBrushItems::getRandomWallId(int alignment, std::mt19937& rng) const {
 	if (alignment < 0 || alignment >= 17) {
 		return 0;
 	}
@@ -44,7 +44,7 @@ uint16_t WallBrushItems::getRandomWallId(int alignment) const {
 		return wn.items.front().id;
 	}
 
-	int chance = random(1, wn.total_chance);
+	int chance = random(rng, 1, wn.total_chance);
 	for (const auto& item : wn.items) {
 		if (chance <= item.chance) {
 			return item.id;
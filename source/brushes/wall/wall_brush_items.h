@@ -35,7 +35,7 @@ public:
 	void addWallItem(int alignment, uint16_t id, int chance);
 	void addDoorItem(int alignment, uint16_t id, ::DoorType type, bool locked);
 
-	[[nodiscard]] uint16_t getRandomWallId(int alignment) const;
+	[[nodiscard]] uint16_t getRandomWallId(int alignment, std::mt19937& rng = getRandomGenerator()) const;
 	[[nodiscard]] bool hasWall(uint16_t id, int alignment) const;
 	[[nodiscard]] bool hasDoor(uint16_t id, int alignment) const;
 	[[nodiscard]] ::DoorType getDoorTypeFromID(uint16_t id) const;
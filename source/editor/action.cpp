@@ -127,6 +127,13 @@ Action::~Action() {
 	changes.clear();
 }
 
+void Action::appendChanges(Action& other) {
+	ASSERT(!commited && !other.commited);
+	changes.reserve(changes.size() + other.changes.size());
+	std::ranges::move(other.changes, std::back_inserter(changes));
+	other.changes.clear();
+}
+
 size_t Action::approx_memsize() const {
 	uint32_t mem = sizeof(*this);
 	mem += changes.size() * (sizeof(Change) + sizeof(Tile) + sizeof(Item) + 6 /* approx overhead*/);
@@ -142,7 +149,18 @@ size_t Action::memsize() const {
 	return mem;
 }
 
+bool Action::addChange(std::unique_ptr<Tile> tile, const Tile* current) {
+	// Brushes and auto-borders frequently rebuild a tile exactly as it was;
+	// committing those would only grow the undo stack and dirty the map.
+	if (current && tile->contentHash() == current->contentHash() && tile->isContentEqual(current)) {
+		return false;
+	}
+	changes.push_back(std::make_unique<Change>(std::move(tile)));
+	return true;
+}
+
 void Action::commit(DirtyList* dirty_list) {
+	DirtyList minimap_dirty;
 	editor.selection.start(Selection::INTERNAL);
 	ChangeList::const_iterator it = changes.begin();
 	while (it != changes.end()) {
@@ -246,7 +264,7 @@ void Action::commit(DirtyList* dirty_list) {
 					dirty_list->AddChange(c);
 				}
 				if (type != ACTION_SELECT) {
-					g_minimap.MarkTileDirty(editor.map, pos);
+					minimap_dirty.AddPosition(pos.x, pos.y, pos.z);
 				}
 				break;
 			}
@@ -303,6 +321,7 @@ void Action::commit(DirtyList* dirty_list) {
 		}
 		++it;
 	}
+	g_minimap.MarkNodesDirty(editor.map, minimap_dirty);
 	editor.selection.finish(Selection::INTERNAL);
 	commited = true;
 }
@@ -312,6 +331,7 @@ void Action::undo(DirtyList* dirty_list) {
 		return;
 	}
 
+	DirtyList minimap_dirty;
 	editor.selection.start(Selection::INTERNAL);
 	ChangeList::reverse_iterator it = changes.rbegin();
 
@@ -435,7 +455,7 @@ void Action::undo(DirtyList* dirty_list) {
 					dirty_list->AddChange(c);
 				}
 				if (type != ACTION_SELECT) {
-					g_minimap.MarkTileDirty(editor.map, pos);
+					minimap_dirty.AddPosition(pos.x, pos.y, pos.z);
 				}
 				break;
 			}
@@ -493,6 +513,7 @@ void Action::undo(DirtyList* dirty_list) {
 		}
 		++it;
 	}
+	g_minimap.MarkNodesDirty(editor.map, minimap_dirty);
 	editor.selection.finish(Selection::INTERNAL);
 	commited = false;
 }
@@ -82,6 +82,9 @@ public:
 	ChangeType getType() const {
 		return type;
 	}
+	const Position& getPosition() const {
+		return position;
+	}
 	const Tile* getTile() const;
 	const HouseExitChangeData* getHouseExitData() const;
 	const WaypointChangeData* getWaypointData() const;
@@ -114,6 +117,7 @@ enum ActionIdentifier {
 	ACTION_GENERATE_DUNGEON,
 	ACTION_LUA_SCRIPT,
 	ACTION_ROTATE_SELECTION,
+	ACTION_RECOVER_JOURNAL,
 };
 
 class Action {
@@ -123,6 +127,11 @@ public:
 	void addChange(std::unique_ptr<Change> t) {
 		changes.push_back(std::move(t));
 	}
+	// Adds a tile change unless the new tile has the same content as the
+	// current tile it was copied from. Returns whether the change was kept.
+	bool addChange(std::unique_ptr<Tile> tile, const Tile* current);
+	// Moves all changes of another uncommitted action to the end of this one.
+	void appendChanges(Action& other);
 
 	// Get memory footprint
 	size_t approx_memsize() const;
@@ -25,6 +25,8 @@
 #include "map/map.h"
 #include "boost/range/adaptor/reversed.hpp"
 
+#include <algorithm>
+
 #include "game/creature.h"
 #include "game/spawn.h"
 
@@ -73,6 +75,7 @@ std::string ActionQueue::getActionName(size_t index) const {
 		case ACTION_CHANGE_PROPERTIES: return "Change Properties";
 		case ACTION_LUA_SCRIPT: return "Lua Script";
 		case ACTION_ROTATE_SELECTION: return "Rotate Selection";
+		case ACTION_RECOVER_JOURNAL: return "Recover Journal";
 		default: return "Unknown";
 	}
 }
@@ -93,6 +96,7 @@ void ActionQueue::addBatch(std::unique_ptr<BatchAction> batch, int stacking_dela
 
 	// Commit any uncommited actions...
 	batch->commit();
+	journal(*batch);
 
 	// Update title and notify state change if map changed
 	if (editor.map.doChange()) {
@@ -154,6 +158,7 @@ void ActionQueue::undo() {
 		current--;
 		BatchAction* batch = actions[current].get();
 		batch->undo();
+		journal(*batch);
 		editor.notifyStateChange();
 		g_luaScripts.emit("actionChange");
 	}
@@ -163,6 +168,7 @@ void ActionQueue::redo() {
 	if (current < actions.size()) {
 		BatchAction* batch = actions[current].get();
 		batch->redo();
+		journal(*batch);
 		current++;
 		editor.notifyStateChange();
 		g_luaScripts.emit("actionChange");
@@ -172,5 +178,26 @@ void ActionQueue::redo() {
 void ActionQueue::clear() {
 	actions.clear();
 	current = 0;
+	// Queues are cleared after changes that bypassed them
+	editor.journal.recordUntracked();
 	g_luaScripts.emit("actionChange");
 }
+
+void ActionQueue::journal(const BatchAction& batch) {
+	if (!editor.journal.isOpen()) {
+		return;
+	}
+
+	std::vector<Position> positions;
+	for (const auto& action : batch.batch) {
+		for (const auto& change : action->changes) {
+			if (change->getType() == CHANGE_TILE) {
+				positions.push_back(change->getPosition());
+			}
+		}
+	}
+	std::sort(positions.begin(), positions.end());
+	positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+	editor.journal.recordTiles(editor.map, positions);
+}
@@ -64,6 +64,9 @@ public:
 	std::string getActionName(size_t index) const;
 
 protected:
+	// Appends the current state of the tiles a batch touched to the editor's journal
+	void journal(const BatchAction& batch);
+
 	size_t current;
 	size_t memory_size;
 	Editor& editor;
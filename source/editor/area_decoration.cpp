@@ -28,6 +28,7 @@
 #include "map/tile_operations.h"
 #include "ui/gui.h"
 #include "util/file_system.h"
+#include "util/parallel.h"
 
 #include <algorithm>
 #include <cmath>
@@ -471,47 +472,29 @@ std::vector<Position> AreaDefinition::getPositionsFromSelection(Map& map) const
 }
 
 //=============================================================================
-// SpatialHashGrid Implementation
+// PlacementGrid Implementation
 //=============================================================================
 
-SpatialHashGrid::SpatialHashGrid(int cellSize) : m_cellSize(cellSize) {}
-
-void SpatialHashGrid::insert(const Position& pos, size_t itemIndex) {
-	int cx = pos.x / m_cellSize;
-	int cy = pos.y / m_cellSize;
-	uint64_t cellHash = (static_cast<uint64_t>(cx) << 32) | static_cast<uint64_t>(cy);
-	m_cells[cellHash].push_back({pos, itemIndex});
-}
-
-std::vector<size_t> SpatialHashGrid::queryRadius(const Position& center, int radius) const {
-	std::vector<size_t> result;
-
-	int cellRadius = (radius / m_cellSize) + 1;
-	int cx = center.x / m_cellSize;
-	int cy = center.y / m_cellSize;
-
-	for (int dy = -cellRadius; dy <= cellRadius; ++dy) {
-		for (int dx = -cellRadius; dx <= cellRadius; ++dx) {
-			uint64_t cellHash = (static_cast<uint64_t>(cx + dx) << 32) |
-			                    static_cast<uint64_t>(cy + dy);
-			auto it = m_cells.find(cellHash);
-			if (it != m_cells.end()) {
-				for (const auto& entry : it->second) {
-					int dist = std::max(std::abs(entry.first.x - center.x),
-					                    std::abs(entry.first.y - center.y));
-					if (dist <= radius) {
-						result.push_back(entry.second);
-					}
-				}
-			}
-		}
-	}
+PlacementGrid::PlacementGrid(int cellSize) : m_cellSize(std::max(1, cellSize)), m_heads(1, -1) {}
 
-	return result;
+void PlacementGrid::reset(const Position& minPos, const Position& maxPos) {
+	m_originX = minPos.x;
+	m_originY = minPos.y;
+	m_cellsX = std::max(1, (maxPos.x - minPos.x) / m_cellSize + 1);
+	m_cellsY = std::max(1, (maxPos.y - minPos.y) / m_cellSize + 1);
+	m_heads.assign(static_cast<size_t>(m_cellsX) * m_cellsY, -1);
+	m_entries.clear();
+}
+
+void PlacementGrid::insert(const Position& pos, size_t itemIndex) {
+	int32_t& head = m_heads[static_cast<size_t>(cellY(pos.y)) * m_cellsX + cellX(pos.x)];
+	m_entries.push_back({ pos, static_cast<uint32_t>(itemIndex), head });
+	head = static_cast<int32_t>(m_entries.size() - 1);
 }
 
-void SpatialHashGrid::clear() {
-	m_cells.clear();
+void PlacementGrid::clear() {
+	std::fill(m_heads.begin(), m_heads.end(), -1);
+	m_entries.clear();
 }
 
 //=============================================================================
@@ -547,7 +530,7 @@ std::vector<const PreviewItem*> PreviewManager::getPreviewItemsAt(const Position
 //=============================================================================
 
 DecorationEngine::DecorationEngine(Editor* editor)
-	: m_editor(editor), m_spatialHash(8) {
+	: m_editor(editor), m_spatialHash(8), m_clusterCenters(8) {
 }
 
 DecorationEngine::~DecorationEngine() {
@@ -606,7 +589,7 @@ bool DecorationEngine::generatePreview(uint64_t seed) {
 		return false;
 	}
 
-	m_spatialHash.clear();
+	resetSpatialIndex(tiles);
 	buildFriendDistanceCache(tiles);
 
 	switch (m_preset.distribution.mode) {
@@ -678,7 +661,7 @@ bool DecorationEngine::generatePreviewVirtual(int width, int height, uint16_t gr
 		}
 	}
 
-	m_spatialHash.clear();
+	resetSpatialIndex(tiles);
 	buildFriendDistanceCache(tiles);
 
 	switch (m_preset.distribution.mode) {
@@ -719,6 +702,7 @@ void DecorationEngine::clearPreview() {
 	m_previewState.clear();
 	m_spatialHash.clear();
 	m_clusterCenters.clear();
+	m_tileFacts = {};
 	m_friendDistanceCache.clear();
 	m_virtualPreview = false;
 	m_previewWasCapped = false;
@@ -728,18 +712,22 @@ bool DecorationEngine::checkClusterCenterSpacing(const Position& pos, int minDis
 	if (minDistance <= 0) {
 		return true;
 	}
-	for (const auto& center : m_clusterCenters) {
-		if (center.z != pos.z) {
-			continue;
-		}
-		int dx = std::abs(center.x - pos.x);
-		int dy = std::abs(center.y - pos.y);
-		int dist = std::max(dx, dy);
-		if (dist < minDistance) {
-			return false;
-		}
+	return m_clusterCenters.forEachInRadius(pos, minDistance - 1, [&](const Position& center, size_t) {
+		return center.z != pos.z;
+	});
+}
+
+void DecorationEngine::resetSpatialIndex(const std::vector<std::pair<Position, uint16_t>>& tiles) {
+	Position minPos = tiles.front().first;
+	Position maxPos = tiles.front().first;
+	for (const auto& tile : tiles) {
+		minPos.x = std::min(minPos.x, tile.first.x);
+		minPos.y = std::min(minPos.y, tile.first.y);
+		maxPos.x = std::max(maxPos.x, tile.first.x);
+		maxPos.y = std::max(maxPos.y, tile.first.y);
 	}
-	return true;
+	m_spatialHash.reset(minPos, maxPos);
+	m_clusterCenters.reset(minPos, maxPos);
 }
 
 void DecorationEngine::buildFriendDistanceCache(const std::vector<std::pair<Position, uint16_t>>& tiles) {
@@ -1057,17 +1045,20 @@ bool DecorationEngine::collectTileData(std::vector<std::pair<Position, uint16_t>
 }
 
 bool DecorationEngine::checkSpacing(const Position& pos, uint16_t itemId) const {
+	return checkSpacing(pos, itemId, m_spatialHash, m_previewState.items);
+}
+
+bool DecorationEngine::checkSpacing(const Position& pos, uint16_t itemId, const PlacementGrid& grid,
+                                    const std::vector<PreviewItem>& items) const {
 	const SpacingConfig& spacing = m_preset.spacing;
 
 	int maxRadius = std::max(spacing.minDistance, spacing.minSameItemDistance);
-	auto nearby = m_spatialHash.queryRadius(pos, maxRadius);
+	return grid.forEachInRadius(pos, maxRadius, [&](const Position&, size_t idx) {
+		if (idx >= items.size()) return true;
 
-	for (size_t idx : nearby) {
-		if (idx >= m_previewState.items.size()) continue;
+		const PreviewItem& existing = items[idx];
 
-		const PreviewItem& existing = m_previewState.items[idx];
-
-		if (existing.position.z != pos.z) continue;
+		if (existing.position.z != pos.z) return true;
 
 		int dx = std::abs(pos.x - existing.position.x);
 		int dy = std::abs(pos.y - existing.position.y);
@@ -1083,30 +1074,57 @@ bool DecorationEngine::checkSpacing(const Position& pos, uint16_t itemId) const
 			return false;
 		}
 
-		if (itemId == existing.itemId && distance < spacing.minSameItemDistance) {
-			return false;
-		}
-	}
-
-	return true;
+		return !(itemId == existing.itemId && distance < spacing.minSameItemDistance);
+	});
 }
 
 bool DecorationEngine::validateTilePlacement(const Position& pos, uint16_t itemId) const {
 	if (m_virtualPreview) return true;
 	if (!m_editor) return false;
 
-	Map& map = m_editor->map;
-	Tile* tile = map.getTile(pos);
-
-	if (!tile) return false;
+	const uint8_t facts = tileFactsAt(pos);
+	if (!(facts & TileFacts::Exists)) return false;
 
-	if (m_preset.skipBlockedTiles && tile->isBlocking()) {
+	if (m_preset.skipBlockedTiles && (facts & TileFacts::Blocking)) {
 		return false;
 	}
 
 	return true;
 }
 
+uint8_t DecorationEngine::readTileFacts(const Tile* tile) {
+	if (!tile) return 0;
+	uint8_t flags = TileFacts::Exists;
+	if (tile->isBlocking()) flags |= TileFacts::Blocking;
+	if (tile->ground) flags |= TileFacts::HasGround;
+	if (!tile->items.empty()) flags |= TileFacts::HasItems;
+	return flags;
+}
+
+void DecorationEngine::captureTileFacts(const Position& minPos, const Position& maxPos) {
+	const int width = maxPos.x - minPos.x + 1;
+	const int height = maxPos.y - minPos.y + 1;
+	std::vector<uint8_t> flags(static_cast<size_t>(width) * height, 0);
+	for (int y = minPos.y; y <= maxPos.y; ++y) {
+		for (int x = minPos.x; x <= maxPos.x; ++x) {
+			flags[static_cast<size_t>(y - minPos.y) * width + (x - minPos.x)] = readTileFacts(m_editor->map.getTile(x, y, minPos.z));
+		}
+	}
+
+	m_tileFacts.minX = minPos.x;
+	m_tileFacts.minY = minPos.y;
+	m_tileFacts.width = width;
+	m_tileFacts.height = height;
+	m_tileFacts.flags = std::move(flags);
+}
+
+uint8_t DecorationEngine::tileFactsAt(const Position& pos) const {
+	if (m_tileFacts.covers(pos)) {
+		return m_tileFacts.flags[static_cast<size_t>(pos.y - m_tileFacts.minY) * m_tileFacts.width + (pos.x - m_tileFacts.minX)];
+	}
+	return readTileFacts(m_editor->map.getTile(pos));
+}
+
 // Roll a random orientation (0-3 turns) and follow the item's rotateTo chain.
 // Items that are not rotatable keep their original id.
 static uint16_t randomRotatedItemId(uint16_t itemId, std::mt19937& rng) {
@@ -1127,7 +1145,8 @@ static uint16_t randomRotatedItemId(uint16_t itemId, std::mt19937& rng) {
 }
 
 bool DecorationEngine::buildPlacementItems(const Position& basePos, const ItemEntry& entry,
-                                           const FloorRule* rule, std::vector<PreviewItem>& outItems) {
+                                           const FloorRule* rule, std::mt19937& rng,
+                                           std::vector<PreviewItem>& outItems) const {
 	outItems.clear();
 
 	// Helper to add border item on top of placed items at a position
@@ -1147,7 +1166,7 @@ bool DecorationEngine::buildPlacementItems(const Position& basePos, const ItemEn
 
 		PreviewItem previewItem;
 		previewItem.position = basePos;
-		previewItem.itemId = entry.randomRotation ? randomRotatedItemId(entry.itemId, m_rng) : entry.itemId;
+		previewItem.itemId = entry.randomRotation ? randomRotatedItemId(entry.itemId, rng) : entry.itemId;
 		previewItem.sourceRule = rule;
 		outItems.push_back(previewItem);
 
@@ -1167,20 +1186,18 @@ bool DecorationEngine::buildPlacementItems(const Position& basePos, const ItemEn
 			if (tile.itemIds.empty()) continue;
 			Position pos = origin + tile.offset;
 
-			// Skip tiles without ground when requireGround is active
-			if (rule && rule->requireGround && !m_virtualPreview && m_editor) {
-				Tile* mapTile = m_editor->map.getTile(pos);
-				if (!mapTile || !mapTile->ground) {
+			if (!m_virtualPreview && m_editor) {
+				const uint8_t facts = tileFactsAt(pos);
+
+				// Skip tiles without ground when requireGround is active
+				if (rule && rule->requireGround && !(facts & TileFacts::HasGround)) {
 					continue;
 				}
-			}
 
-			// Reject the whole cluster if any target tile already has items stacked
-			// on the ground — we only overwrite bare ground, never existing borders
-			// or decorations placed by the user.
-			if (!m_virtualPreview && m_editor) {
-				Tile* mapTile = m_editor->map.getTile(pos);
-				if (mapTile && !mapTile->items.empty()) {
+				// Reject the whole cluster if any target tile already has items stacked
+				// on the ground — we only overwrite bare ground, never existing borders
+				// or decorations placed by the user.
+				if (facts & TileFacts::HasItems) {
 					return false;
 				}
 			}
@@ -1203,7 +1220,7 @@ bool DecorationEngine::buildPlacementItems(const Position& basePos, const ItemEn
 				if (id == 0) continue;
 				PreviewItem previewItem;
 				previewItem.position = pos;
-				previewItem.itemId = entry.randomRotation ? randomRotatedItemId(id, m_rng) : id;
+				previewItem.itemId = entry.randomRotation ? randomRotatedItemId(id, rng) : id;
 				previewItem.sourceRule = rule;
 				outItems.push_back(previewItem);
 				addedAny = true;
@@ -1238,8 +1255,8 @@ bool DecorationEngine::buildPlacementItems(const Position& basePos, const ItemEn
 	for (int i = 1; i < count; ++i) {
 		bool placed = false;
 		for (int attempt = 0; attempt < 20; ++attempt) {
-			int dx = offsetDist(m_rng);
-			int dy = offsetDist(m_rng);
+			int dx = offsetDist(rng);
+			int dy = offsetDist(rng);
 			if (dx == 0 && dy == 0) continue;
 
 			bool tooClose = false;
@@ -1297,7 +1314,7 @@ void DecorationEngine::commitPlacement(const std::vector<PreviewItem>& placement
 	}
 }
 
-const ItemEntry* DecorationEngine::selectItemFromRule(const FloorRule* rule) {
+const ItemEntry* DecorationEngine::selectItemFromRule(const FloorRule* rule, std::mt19937& rng) const {
 	if (!rule || rule->items.empty()) return nullptr;
 
 	int totalWeight = 0;
@@ -1308,7 +1325,7 @@ const ItemEntry* DecorationEngine::selectItemFromRule(const FloorRule* rule) {
 	if (totalWeight <= 0) return nullptr;
 
 	std::uniform_int_distribution<int> dist(0, totalWeight - 1);
-	int roll = dist(m_rng);
+	int roll = dist(rng);
 
 	int cumulative = 0;
 	for (const auto& item : rule->items) {
@@ -1321,7 +1338,197 @@ const ItemEntry* DecorationEngine::selectItemFromRule(const FloorRule* rule) {
 	return &rule->items.back();
 }
 
+namespace {
+	// Below this many tiles the sequential pass is faster than the setup
+	constexpr size_t PARALLEL_MIN_TILES = 16384;
+	// Smallest block edge handed to one worker
+	constexpr int PARALLEL_MIN_BLOCK = 32;
+
+	struct BlockResult {
+		std::vector<std::vector<PreviewItem>> placements;
+		std::vector<Position> clusterCenters;
+	};
+}
+
+int DecorationEngine::placementExtent() const {
+	int extent = 0;
+	for (const auto& rule : m_preset.floorRules) {
+		if (!rule.enabled || rule.isClusterRule()) continue;
+		for (const auto& entry : rule.items) {
+			int entryExtent = 0;
+			for (const auto& tile : entry.compositeTiles) {
+				entryExtent = std::max({entryExtent, std::abs(tile.offset.x), std::abs(tile.offset.y)});
+			}
+			if (entry.isClusterEntry()) {
+				entryExtent += std::max(0, entry.clusterRadius);
+			}
+			extent = std::max(extent, entryExtent);
+		}
+	}
+	return extent;
+}
+
+bool DecorationEngine::canGenerateInParallel(const std::vector<std::pair<Position, uint16_t>>& tiles) const {
+	if (tiles.size() < PARALLEL_MIN_TILES) return false;
+
+	// Caps depend on the order placements are made in, which only the
+	// sequential pass keeps
+	if (m_preset.maxItemsTotal >= 0) return false;
+	for (const auto& rule : m_preset.floorRules) {
+		if (rule.enabled && !rule.isClusterRule() && rule.maxPlacements >= 0) {
+			return false;
+		}
+	}
+
+	const int z = tiles.front().first.z;
+	return std::all_of(tiles.begin(), tiles.end(), [z](const auto& tile) { return tile.first.z == z; });
+}
+
+// Splits the area into square blocks wider than the distance at which two
+// placements can affect each other, then runs the blocks in four waves of a
+// 2x2 colouring. Blocks of one wave never interact, so each worker only
+// reads what earlier waves committed plus its own block. Every block draws
+// from its own generator seeded by the preview seed and the block
+// coordinates, so the result does not depend on the thread count.
+void DecorationEngine::generatePureRandomParallel(const std::vector<std::pair<Position, uint16_t>>& tiles) {
+	Position minPos = tiles.front().first;
+	Position maxPos = tiles.front().first;
+	for (const auto& tile : tiles) {
+		minPos.x = std::min(minPos.x, tile.first.x);
+		minPos.y = std::min(minPos.y, tile.first.y);
+		maxPos.x = std::max(maxPos.x, tile.first.x);
+		maxPos.y = std::max(maxPos.y, tile.first.y);
+	}
+
+	const int extent = placementExtent();
+	if (!m_virtualPreview && m_editor) {
+		captureTileFacts(Position(minPos.x - extent, minPos.y - extent, minPos.z), Position(maxPos.x + extent, maxPos.y + extent, minPos.z));
+	}
+
+	int clusterReach = 0;
+	for (const auto& rule : m_preset.floorRules) {
+		if (!rule.enabled || rule.isClusterRule()) continue;
+		for (const auto& entry : rule.items) {
+			if (entry.isClusterEntry()) {
+				clusterReach = std::max(clusterReach, std::max(0, entry.clusterRadius) + std::max(0, entry.clusterMinDistance));
+			}
+		}
+	}
+	const int spacingReach = std::max(m_preset.spacing.minDistance, m_preset.spacing.minSameItemDistance);
+	const int blockSize = std::max(PARALLEL_MIN_BLOCK, std::max(2 * extent + spacingReach, clusterReach) + 1);
+
+	const int blocksX = (maxPos.x - minPos.x) / blockSize + 1;
+	const int blocksY = (maxPos.y - minPos.y) / blockSize + 1;
+	std::vector<std::vector<size_t>> blockTiles(static_cast<size_t>(blocksX) * blocksY);
+	for (size_t i = 0; i < tiles.size(); ++i) {
+		const Position& pos = tiles[i].first;
+		blockTiles[static_cast<size_t>((pos.y - minPos.y) / blockSize) * blocksX + (pos.x - minPos.x) / blockSize].push_back(i);
+	}
+
+	auto runBlock = [&](int bx, int by, BlockResult& result) {
+		std::vector<size_t> indices = blockTiles[static_cast<size_t>(by) * blocksX + bx];
+		if (indices.empty()) return;
+
+		std::seed_seq seq {
+			static_cast<uint32_t>(m_currentSeed), static_cast<uint32_t>(m_currentSeed >> 32),
+			static_cast<uint32_t>(bx), static_cast<uint32_t>(by)
+		};
+		std::mt19937 rng(seq);
+		std::shuffle(indices.begin(), indices.end(), rng);
+
+		const Position blockMin(minPos.x + bx * blockSize - extent, minPos.y + by * blockSize - extent, minPos.z);
+		const Position blockMax(blockMin.x + blockSize + 2 * extent, blockMin.y + blockSize + 2 * extent, minPos.z);
+		PlacementGrid localHash(8);
+		PlacementGrid localCenters(8);
+		localHash.reset(blockMin, blockMax);
+		localCenters.reset(blockMin, blockMax);
+		std::vector<PreviewItem> localItems;
+
+		std::vector<const FloorRule*> matchingRules;
+		std::vector<PreviewItem> placementItems;
+		std::uniform_real_distribution<float> densityDist(0.0f, 1.0f);
+
+		for (size_t idx : indices) {
+			const Position& pos = tiles[idx].first;
+
+			m_preset.getMatchingRules(tiles[idx].second, matchingRules);
+			for (const FloorRule* rule : matchingRules) {
+				if (densityDist(rng) > applyFriendBias(rule, pos, rule->density)) {
+					continue;
+				}
+
+				const ItemEntry* selected = selectItemFromRule(rule, rng);
+				if (!selected) continue;
+
+				const bool isClusterEntry = selected->isClusterEntry();
+				if (isClusterEntry) {
+					const int centerMinDist = std::max(0, selected->clusterRadius) + std::max(0, selected->clusterMinDistance);
+					if (!checkClusterCenterSpacing(pos, centerMinDist)) {
+						continue;
+					}
+					if (centerMinDist > 0 && !localCenters.forEachInRadius(pos, centerMinDist - 1, [](const Position&, size_t) { return false; })) {
+						continue;
+					}
+				}
+
+				if (!buildPlacementItems(pos, *selected, rule, rng, placementItems)) {
+					continue;
+				}
+
+				const bool spaced = std::all_of(placementItems.begin(), placementItems.end(), [&](const PreviewItem& item) {
+					return checkSpacing(item.position, item.itemId, m_spatialHash, m_previewState.items) && checkSpacing(item.position, item.itemId, localHash, localItems);
+				});
+				if (!spaced) {
+					continue;
+				}
+
+				for (const auto& item : placementItems) {
+					localItems.push_back(item);
+					localHash.insert(item.position, localItems.size() - 1);
+				}
+				if (isClusterEntry) {
+					localCenters.insert(pos, 0);
+					result.clusterCenters.push_back(pos);
+				}
+				result.placements.push_back(placementItems);
+			}
+		}
+	};
+
+	for (int wave = 0; wave < 4; ++wave) {
+		std::vector<std::pair<int, int>> blocks;
+		for (int by = wave / 2; by < blocksY; by += 2) {
+			for (int bx = wave % 2; bx < blocksX; bx += 2) {
+				blocks.emplace_back(bx, by);
+			}
+		}
+		if (blocks.empty()) continue;
+
+		std::vector<BlockResult> results(blocks.size());
+		parallelFor(0, blocks.size(), 1, [&](size_t start, size_t end) {
+			for (size_t i = start; i < end; ++i) {
+				runBlock(blocks[i].first, blocks[i].second, results[i]);
+			}
+		});
+
+		// Merge in block order so the preview is the same on every machine
+		for (const auto& result : results) {
+			for (const auto& placement : result.placements) {
+				commitPlacement(placement);
+			}
+			for (const auto& center : result.clusterCenters) {
+				m_clusterCenters.insert(center, 0);
+			}
+		}
+	}
+}
+
 void DecorationEngine::generatePureRandom(const std::vector<std::pair<Position, uint16_t>>& tiles) {
+	if (canGenerateInParallel(tiles)) {
+		generatePureRandomParallel(tiles);
+		return;
+	}
+
 	std::unordered_map<const FloorRule*, int> rulePlacements;
 	std::vector<const FloorRule*> matchingRules;
 
@@ -1360,7 +1567,7 @@ void DecorationEngine::generatePureRandom(const std::vector<std::pair<Position,
 				continue;
 			}
 
-			const ItemEntry* selected = selectItemFromRule(rule);
+			const ItemEntry* selected = selectItemFromRule(rule, m_rng);
 			if (!selected) continue;
 
 			bool isClusterEntry = selected->isClusterEntry();
@@ -1374,7 +1581,7 @@ void DecorationEngine::generatePureRandom(const std::vector<std::pair<Position,
 			}
 
 			std::vector<PreviewItem> placementItems;
-			if (!buildPlacementItems(pos, *selected, rule, placementItems)) {
+			if (!buildPlacementItems(pos, *selected, rule, m_rng, placementItems)) {
 				continue;
 			}
 
@@ -1389,7 +1596,7 @@ void DecorationEngine::generatePureRandom(const std::vector<std::pair<Position,
 
 			commitPlacement(placementItems);
 			if (isClusterEntry) {
-				m_clusterCenters.push_back(pos);
+				m_clusterCenters.insert(pos, 0);
 			}
 			rulePlacements[rule]++;
 		}
@@ -1466,7 +1673,7 @@ void DecorationEngine::generateClustered(const std::vector<std::pair<Position, u
 				continue;
 			}
 
-			const ItemEntry* selected = selectItemFromRule(rule);
+			const ItemEntry* selected = selectItemFromRule(rule, m_rng);
 			if (!selected) continue;
 
 			bool isClusterEntry = selected->isClusterEntry();
@@ -1480,7 +1687,7 @@ void DecorationEngine::generateClustered(const std::vector<std::pair<Position, u
 			}
 
 			std::vector<PreviewItem> placementItems;
-			if (!buildPlacementItems(pos, *selected, rule, placementItems)) {
+			if (!buildPlacementItems(pos, *selected, rule, m_rng, placementItems)) {
 				continue;
 			}
 
@@ -1495,7 +1702,7 @@ void DecorationEngine::generateClustered(const std::vector<std::pair<Position, u
 
 			commitPlacement(placementItems);
 			if (isClusterEntry) {
-				m_clusterCenters.push_back(pos);
+				m_clusterCenters.insert(pos, 0);
 			}
 			rulePlacements[rule]++;
 		}
@@ -1573,7 +1780,7 @@ void DecorationEngine::generateGridBased(const std::vector<std::pair<Position, u
 					continue;
 				}
 
-				const ItemEntry* selected = selectItemFromRule(rule);
+				const ItemEntry* selected = selectItemFromRule(rule, m_rng);
 				if (!selected) continue;
 
 				bool isClusterEntry = selected->isClusterEntry();
@@ -1587,7 +1794,7 @@ void DecorationEngine::generateGridBased(const std::vector<std::pair<Position, u
 				}
 
 				std::vector<PreviewItem> placementItems;
-				if (!buildPlacementItems(pos, *selected, rule, placementItems)) {
+				if (!buildPlacementItems(pos, *selected, rule, m_rng, placementItems)) {
 					continue;
 				}
 
@@ -1602,7 +1809,7 @@ void DecorationEngine::generateGridBased(const std::vector<std::pair<Position, u
 
 				commitPlacement(placementItems);
 				if (isClusterEntry) {
-					m_clusterCenters.push_back(pos);
+					m_clusterCenters.insert(pos, 0);
 				}
 				rulePlacements[rule]++;
 			}
@@ -1734,7 +1941,7 @@ void DecorationEngine::generateClusterCentered(const std::vector<std::pair<Posit
 
 		// The center position is where the center tile maps to in the world
 		// Items from rule.items are placed at this center position
-		const ItemEntry* selected = selectItemFromRule(&rule);
+		const ItemEntry* selected = selectItemFromRule(&rule, m_rng);
 		if (!selected) continue;
 
 		// For composite items with their own center point, adjust the base position
@@ -1760,7 +1967,7 @@ void DecorationEngine::generateClusterCentered(const std::vector<std::pair<Posit
 
 		// Build placement items at adjusted base position
 		std::vector<PreviewItem> placementItems;
-		if (!buildPlacementItems(basePos, *selected, &rule, placementItems)) {
+		if (!buildPlacementItems(basePos, *selected, &rule, m_rng, placementItems)) {
 			continue;
 		}
 
@@ -1893,7 +2100,7 @@ void DecorationEngine::generateClusterRandom(const std::vector<std::pair<Positio
 			}
 
 			// Pick a random item from rule.items
-			const ItemEntry* selected = selectItemFromRule(&rule);
+			const ItemEntry* selected = selectItemFromRule(&rule, m_rng);
 			if (!selected) continue;
 
 			// For composite items with their own center point, adjust the base position
@@ -1915,7 +2122,7 @@ void DecorationEngine::generateClusterRandom(const std::vector<std::pair<Positio
 
 			// Build placement items at this cluster tile position
 			std::vector<PreviewItem> tileItems;
-			if (!buildPlacementItems(basePos, *selected, &rule, tileItems)) {
+			if (!buildPlacementItems(basePos, *selected, &rule, m_rng, tileItems)) {
 				continue;
 			}
 
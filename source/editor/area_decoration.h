@@ -19,6 +19,8 @@
 #define RME_AREA_DECORATION_H
 
 #include "map/position.h"
+#include <algorithm>
+#include <cstdlib>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -345,19 +347,64 @@ private:
 };
 
 //=============================================================================
-// SpatialHashGrid - For efficient spacing checks
+// PlacementGrid - Uniform grid for spacing checks
 //=============================================================================
-class SpatialHashGrid {
+// Buckets are intrusive lists threaded through one entry array, so inserting
+// never allocates per cell and queries never allocate at all. Points outside
+// the bounds fall into the nearest edge cell, which keeps queries exact.
+class PlacementGrid {
 public:
-	SpatialHashGrid(int cellSize = 8);
+	PlacementGrid(int cellSize = 8);
 
+	// Covers minPos..maxPos (x/y) and drops all entries
+	void reset(const Position& minPos, const Position& maxPos);
 	void insert(const Position& pos, size_t itemIndex);
-	std::vector<size_t> queryRadius(const Position& center, int radius) const;
 	void clear();
 
+	// Calls fn(position, itemIndex) for every entry within Chebyshev distance
+	// radius of center. fn returns false to stop; the query then returns false.
+	template <typename Fn>
+	bool forEachInRadius(const Position& center, int radius, Fn&& fn) const {
+		const int minCx = cellX(center.x - radius);
+		const int maxCx = cellX(center.x + radius);
+		const int minCy = cellY(center.y - radius);
+		const int maxCy = cellY(center.y + radius);
+		for (int cy = minCy; cy <= maxCy; ++cy) {
+			for (int cx = minCx; cx <= maxCx; ++cx) {
+				for (int32_t e = m_heads[static_cast<size_t>(cy) * m_cellsX + cx]; e >= 0; e = m_entries[e].next) {
+					const Entry& entry = m_entries[e];
+					if (std::max(std::abs(entry.pos.x - center.x), std::abs(entry.pos.y - center.y)) <= radius) {
+						if (!fn(entry.pos, static_cast<size_t>(entry.index))) {
+							return false;
+						}
+					}
+				}
+			}
+		}
+		return true;
+	}
+
 private:
+	struct Entry {
+		Position pos;
+		uint32_t index;
+		int32_t next;
+	};
+
+	int cellX(int x) const {
+		return std::clamp((x - m_originX) / m_cellSize, 0, m_cellsX - 1);
+	}
+	int cellY(int y) const {
+		return std::clamp((y - m_originY) / m_cellSize, 0, m_cellsY - 1);
+	}
+
 	int m_cellSize;
-	std::unordered_map<uint64_t, std::vector<std::pair<Position, size_t>>> m_cells;
+	int m_originX = 0;
+	int m_originY = 0;
+	int m_cellsX = 1;
+	int m_cellsY = 1;
+	std::vector<int32_t> m_heads;
+	std::vector<Entry> m_entries;
 };
 
 //=============================================================================
@@ -390,10 +437,31 @@ private:
 	AreaDefinition m_area;
 	DecorationPreset m_preset;
 	PreviewState m_previewState;
-	SpatialHashGrid m_spatialHash;
+	PlacementGrid m_spatialHash;
+	PlacementGrid m_clusterCenters;
 	std::string m_lastError;
 	std::vector<AppliedItem> m_lastAppliedItems;
-	std::vector<Position> m_clusterCenters;
+
+	// Tile facts the placement checks read, captured on the main thread so the
+	// parallel pass never touches the map (its lookups are not thread-safe)
+	struct TileFacts {
+		enum : uint8_t {
+			Exists = 1 << 0,
+			Blocking = 1 << 1,
+			HasGround = 1 << 2,
+			HasItems = 1 << 3,
+		};
+		int minX = 0;
+		int minY = 0;
+		int width = 0;
+		int height = 0;
+		std::vector<uint8_t> flags;
+
+		bool covers(const Position& pos) const {
+			return pos.x >= minX && pos.y >= minY && pos.x < minX + width && pos.y < minY + height;
+		}
+	};
+	TileFacts m_tileFacts;
 	struct FriendDistanceLayer {
 		int minX = 0;
 		int minY = 0;
@@ -409,18 +477,28 @@ private:
 	bool m_previewWasCapped = false;
 
 	bool collectTileData(std::vector<std::pair<Position, uint16_t>>& outTiles);
+	void captureTileFacts(const Position& minPos, const Position& maxPos);
+	uint8_t tileFactsAt(const Position& pos) const;
+	static uint8_t readTileFacts(const Tile* tile);
 	bool checkSpacing(const Position& pos, uint16_t itemId) const;
+	bool checkSpacing(const Position& pos, uint16_t itemId, const PlacementGrid& grid,
+	                  const std::vector<PreviewItem>& items) const;
 	bool validateTilePlacement(const Position& pos, uint16_t itemId) const;
 	bool buildPlacementItems(const Position& basePos, const ItemEntry& entry,
-	                         const FloorRule* rule, std::vector<PreviewItem>& outItems);
+	                         const FloorRule* rule, std::mt19937& rng,
+	                         std::vector<PreviewItem>& outItems) const;
 	bool checkSpacingForPlacement(const std::vector<PreviewItem>& placementItems) const;
 	void commitPlacement(const std::vector<PreviewItem>& placementItems);
 	bool checkClusterCenterSpacing(const Position& pos, int minDistance) const;
+	int placementExtent() const;
+	void resetSpatialIndex(const std::vector<std::pair<Position, uint16_t>>& tiles);
 	void buildFriendDistanceCache(const std::vector<std::pair<Position, uint16_t>>& tiles);
 	float applyFriendBias(const FloorRule* rule, const Position& pos, float baseDensity) const;
 	int getFriendDistance(uint32_t friendKey, const Position& pos) const;
 
 	void generatePureRandom(const std::vector<std::pair<Position, uint16_t>>& tiles);
+	bool canGenerateInParallel(const std::vector<std::pair<Position, uint16_t>>& tiles) const;
+	void generatePureRandomParallel(const std::vector<std::pair<Position, uint16_t>>& tiles);
 	void generateClustered(const std::vector<std::pair<Position, uint16_t>>& tiles);
 	void generateGridBased(const std::vector<std::pair<Position, uint16_t>>& tiles);
 
@@ -429,7 +507,7 @@ private:
 	void generateClusterRandom(const std::vector<std::pair<Position, uint16_t>>& tiles,
 	                            const FloorRule& rule);
 
-	const ItemEntry* selectItemFromRule(const FloorRule* rule);
+	const ItemEntry* selectItemFromRule(const FloorRule* rule, std::mt19937& rng) const;
 };
 
 //=============================================================================
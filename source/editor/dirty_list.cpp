@@ -19,8 +19,17 @@
 #include "editor/dirty_list.h"
 #include "editor/action.h"
 
+#include <algorithm>
+#include <bit>
+
+namespace {
+	constexpr uint32_t NO_CELL = 0xFFFFFFFF;
+}
+
 DirtyList::DirtyList() :
-	owner(0) {
+	owner(0),
+	last_key(NO_CELL),
+	last_idx(0) {
 	;
 }
 
@@ -28,47 +37,120 @@ DirtyList::~DirtyList() {
 	;
 }
 
-void DirtyList::AddPosition(int x, int y, int z) {
-	uint32_t m = ((x >> 2) << 18) | ((y >> 2) << 4);
-	ValueType fi = { m, 0 };
-	SetType::iterator s = iset.find(fi);
-	if (s != iset.end()) {
-		ValueType v = *s;
-		iset.erase(s);
-		v.floors = (1 << z) | v.floors;
-		iset.insert(v);
-	} else {
-		ValueType v = { m, (uint32_t)(1 << z) };
-		iset.insert(v);
+DirtyList::CellBits& DirtyList::getCell(uint32_t key) {
+	if (key == last_key) {
+		return cells[last_idx];
+	}
+
+	auto [it, inserted] = cell_index.try_emplace(key, static_cast<uint32_t>(cells.size()));
+	if (inserted) {
+		cells.emplace_back().key = key;
 	}
+	last_key = key;
+	last_idx = it->second;
+	return cells[last_idx];
 }
 
-void DirtyList::AddChange(Change* c) {
-	ichanges.push_back(c);
+void DirtyList::AddPosition(int x, int y, int z) {
+	const int node_x = x >> NODE_SHIFT;
+	const int node_y = y >> NODE_SHIFT;
+	CellBits& cell = getCell(makeKey(node_x >> CELL_NODE_SHIFT, node_y >> CELL_NODE_SHIFT));
+
+	const uint32_t bit = ((node_x & (CELL_NODES - 1)) << CELL_NODE_SHIFT) | (node_y & (CELL_NODES - 1));
+	cell.nodes[bit >> 6] |= uint64_t(1) << (bit & 63);
+	cell.floors[bit] |= uint32_t(1) << z;
 }
 
-DirtyList::SetType& DirtyList::GetPosList() {
-	return iset;
+void DirtyList::AddChange(Change* c) {
+	ichanges.push_back(c);
 }
 
 DirtyList::ChangeList& DirtyList::GetChanges() {
 	return ichanges;
 }
 
-int DirtyList::DecodeNodeX(const ValueType& value) {
-	return static_cast<int>((value.pos >> 18) << 2);
+std::vector<const DirtyList::CellBits*> DirtyList::sortedCells() const {
+	std::vector<const CellBits*> sorted;
+	sorted.reserve(cells.size());
+	for (const CellBits& cell : cells) {
+		sorted.push_back(&cell);
+	}
+	std::ranges::sort(sorted, {}, &CellBits::key);
+	return sorted;
 }
 
-int DirtyList::DecodeNodeY(const ValueType& value) {
-	return static_cast<int>(((value.pos >> 4) & 0x3FFF) << 2);
+void DirtyList::ForEachNode(const Visitor& visitor) const {
+	for (const CellBits* cell : sortedCells()) {
+		const int base_x = static_cast<int>(cell->key >> 16) << CELL_NODE_SHIFT;
+		const int base_y = static_cast<int>(cell->key & 0xFFFF) << CELL_NODE_SHIFT;
+		for (size_t word = 0; word < cell->nodes.size(); ++word) {
+			uint64_t bits = cell->nodes[word];
+			while (bits) {
+				const uint32_t bit = static_cast<uint32_t>(word * 64 + std::countr_zero(bits));
+				bits &= bits - 1;
+				const int node_x = base_x + static_cast<int>(bit >> CELL_NODE_SHIFT);
+				const int node_y = base_y + static_cast<int>(bit & (CELL_NODES - 1));
+				visitor(node_x << NODE_SHIFT, node_y << NODE_SHIFT, cell->floors[bit]);
+			}
+		}
+	}
 }
 
-uint32_t DirtyList::DecodeFloorsMask(const ValueType& value) {
-	return value.floors;
-}
+void DirtyList::ForEachNodeRect(const RectVisitor& visitor) const {
+	for (const CellBits* cell : sortedCells()) {
+		const int base_x = static_cast<int>(cell->key >> 16) << CELL_NODE_SHIFT;
+		const int base_y = static_cast<int>(cell->key & 0xFFFF) << CELL_NODE_SHIFT;
+
+		// Greedy cover of the cell: grow each rect along x while the floors mask
+		// matches, then along y while the whole row still matches.
+		std::array<uint64_t, 4> pending = cell->nodes;
+		auto isPending = [&pending](uint32_t bit) {
+			return (pending[bit >> 6] >> (bit & 63)) & 1;
+		};
+		auto at = [](int lx, int ly) {
+			return static_cast<uint32_t>((lx << CELL_NODE_SHIFT) | ly);
+		};
+
+		for (int ly = 0; ly < CELL_NODES; ++ly) {
+			for (int lx = 0; lx < CELL_NODES; ++lx) {
+				if (!isPending(at(lx, ly))) {
+					continue;
+				}
+				const uint32_t floors = cell->floors[at(lx, ly)];
+
+				int width = 1;
+				while (lx + width < CELL_NODES && isPending(at(lx + width, ly)) && cell->floors[at(lx + width, ly)] == floors) {
+					++width;
+				}
+
+				int height = 1;
+				while (ly + height < CELL_NODES) {
+					bool row_matches = true;
+					for (int i = 0; i < width && row_matches; ++i) {
+						const uint32_t bit = at(lx + i, ly + height);
+						row_matches = isPending(bit) && cell->floors[bit] == floors;
+					}
+					if (!row_matches) {
+						break;
+					}
+					++height;
+				}
+
+				for (int j = 0; j < height; ++j) {
+					for (int i = 0; i < width; ++i) {
+						const uint32_t bit = at(lx + i, ly + j);
+						pending[bit >> 6] &= ~(uint64_t(1) << (bit & 63));
+					}
+				}
 
-void DirtyList::ForEachNodeRect(const Visitor& visitor) const {
-	for (const auto& value : iset) {
-		visitor(DecodeNodeX(value), DecodeNodeY(value), DecodeFloorsMask(value));
+				visitor(NodeRect {
+					.x = (base_x + lx) << NODE_SHIFT,
+					.y = (base_y + ly) << NODE_SHIFT,
+					.width = width << NODE_SHIFT,
+					.height = height << NODE_SHIFT,
+					.floors = floors,
+				});
+			}
+		}
 	}
 }
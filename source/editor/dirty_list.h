@@ -18,52 +18,78 @@
 #ifndef RME_EDITOR_DIRTY_LIST_H
 #define RME_EDITOR_DIRTY_LIST_H
 
+#include <array>
 #include <vector>
-#include <set>
 #include <cstdint>
 #include <functional>
+#include <unordered_map>
 
 class Change;
 
-// A dirty list represents a list of all tiles that was changed in an action
+// A dirty list represents a list of all tiles that was changed in an action.
+//
+// Tiles are tracked per map node (4x4 tiles) together with the mask of floors
+// touched on that node. Nodes are grouped into 16x16-node cells, each holding a
+// 256-bit occupancy mask and the per-node floor masks, so marking a tile is a
+// couple of bit operations instead of a tree insertion.
 class DirtyList {
 public:
 	DirtyList();
 	~DirtyList();
 
-	struct ValueType {
-		uint32_t pos;
+	// A rectangle of dirty nodes sharing the same floors mask. Coordinates and
+	// sizes are in tiles, aligned to node boundaries.
+	struct NodeRect {
+		int x;
+		int y;
+		int width;
+		int height;
 		uint32_t floors;
 	};
 
 	uint32_t owner;
 
-protected:
-	struct Comparator {
-		bool operator()(const ValueType& a, const ValueType& b) const {
-			return a.pos < b.pos;
-		}
-	};
-
-public:
-	using SetType = std::set<ValueType, Comparator>;
 	using ChangeList = std::vector<Change*>;
 	using Visitor = std::function<void(int node_x, int node_y, uint32_t floors_mask)>;
+	using RectVisitor = std::function<void(const NodeRect& rect)>;
 
 	void AddPosition(int x, int y, int z);
 	void AddChange(Change* c);
 	bool Empty() const {
-		return iset.empty() && ichanges.empty();
+		return cells.empty() && ichanges.empty();
 	}
-	SetType& GetPosList();
 	ChangeList& GetChanges();
-	static int DecodeNodeX(const ValueType& value);
-	static int DecodeNodeY(const ValueType& value);
-	static uint32_t DecodeFloorsMask(const ValueType& value);
-	void ForEachNodeRect(const Visitor& visitor) const;
+
+	// Visits every dirty node cell by cell: cells ordered by x, then y, and the
+	// nodes of a cell by x, then y. This is not a global x/y order. Node
+	// coordinates are the tile coordinates of the node's top-left corner.
+	void ForEachNode(const Visitor& visitor) const;
+	// Visits the dirty nodes coalesced into rectangles of equal floor masks.
+	// Rectangles never cross a cell boundary.
+	void ForEachNodeRect(const RectVisitor& visitor) const;
 
 protected:
-	SetType iset;
+	static constexpr int NODE_SHIFT = 2; // 4x4 tiles per node
+	static constexpr int CELL_NODE_SHIFT = 4; // 16x16 nodes per cell
+	static constexpr int CELL_NODES = 1 << CELL_NODE_SHIFT;
+
+	struct CellBits {
+		uint32_t key = 0;
+		// Bit (local_x * 16 + local_y) is set for each dirty node.
+		std::array<uint64_t, 4> nodes {};
+		std::array<uint32_t, CELL_NODES * CELL_NODES> floors {};
+	};
+
+	static uint32_t makeKey(int cell_x, int cell_y) {
+		return (static_cast<uint32_t>(cell_x) << 16) | static_cast<uint32_t>(cell_y & 0xFFFF);
+	}
+	CellBits& getCell(uint32_t key);
+	std::vector<const CellBits*> sortedCells() const;
+
+	std::vector<CellBits> cells;
+	std::unordered_map<uint32_t, uint32_t> cell_index;
+	uint32_t last_key;
+	uint32_t last_idx;
 	ChangeList ichanges;
 };
 
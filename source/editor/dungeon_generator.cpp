@@ -18,17 +18,17 @@
 #include "app/main.h"
 #include "editor/dungeon_generator.h"
 #include "editor/editor.h"
-#include "editor/action.h"
-#include "editor/action_queue.h"
+#include "editor/operations/draw_operations.h"
 #include "map/map.h"
 #include "map/tile.h"
-#include "map/tile_operations.h"
 #include "game/item.h"
 #include "ui/gui.h"
 #include "util/file_system.h"
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <map>
 #include <numeric>
 #include <queue>
 #include <unordered_set>
@@ -1118,48 +1118,45 @@ bool DungeonGenerator::applyChanges(const std::vector<std::pair<Position, uint16
 		return false;
 	}
 
-	Map& map = m_editor->map;
-	auto batch = m_editor->actionQueue->createBatch(ACTION_DRAW);
-	auto action = m_editor->actionQueue->createAction(batch.get());
-
-	std::unordered_map<uint64_t, std::vector<const std::pair<Position, uint16_t>*>> changesByPos;
+	// Stack the ids of every position in generation order and measure the
+	// area they cover. Everything is generated on a single floor.
+	std::unordered_map<uint64_t, std::vector<uint16_t>> stacks;
+	int minX = std::numeric_limits<int>::max();
+	int minY = std::numeric_limits<int>::max();
+	int maxX = std::numeric_limits<int>::min();
+	int maxY = std::numeric_limits<int>::min();
 	for (const auto& change : tileChanges) {
-		uint64_t hash = posHash(change.first.x, change.first.y) ^ (static_cast<uint64_t>(change.first.z) << 48);
-		changesByPos[hash].push_back(&change);
+		stacks[posHash(change.first.x, change.first.y)].push_back(change.second);
+		minX = std::min(minX, change.first.x);
+		minY = std::min(minY, change.first.y);
+		maxX = std::max(maxX, change.first.x);
+		maxY = std::max(maxY, change.first.y);
 	}
 
-	for (const auto& [hash, changes] : changesByPos) {
-		const Position& pos = changes[0]->first;
-		Tile* existingTile = map.getTile(pos);
-		std::unique_ptr<Tile> newTile;
-
-		if (existingTile) {
-			newTile = TileOperations::deepCopy(existingTile, map);
-		} else {
-			newTile = std::make_unique<Tile>(pos.x, pos.y, pos.z);
+	// Hand the area to the grid painter with one palette entry per distinct
+	// stack. Presets place their own borders, so no borderize pass.
+	GridPaint paint;
+	paint.origin = Position(minX, minY, tileChanges.front().first.z);
+	paint.width = maxX - minX + 1;
+	paint.height = maxY - minY + 1;
+	paint.cells.assign(static_cast<size_t>(paint.width) * paint.height, -1);
+	paint.borderize = false;
+
+	std::map<std::vector<uint16_t>, int32_t> paletteIndex;
+	for (auto& [hash, ids] : stacks) {
+		const int x = static_cast<int32_t>(hash >> 32);
+		const int y = static_cast<int32_t>(hash & 0xFFFFFFFF);
+		auto [it, inserted] = paletteIndex.try_emplace(ids, static_cast<int32_t>(paint.palette.size()));
+		if (inserted) {
+			paint.palette.push_back({ nullptr, std::move(ids) });
 		}
-
-		for (const auto* change : changes) {
-			auto item = Item::Create(change->second);
-			if (item) {
-				if (item->isGroundTile()) {
-					newTile->ground = std::move(item);
-				} else {
-					newTile->addItem(std::move(item));
-				}
-			}
-		}
-
-		action->addChange(std::make_unique<Change>(std::move(newTile)));
+		paint.cells[static_cast<size_t>(y - minY) * paint.width + (x - minX)] = it->second;
 	}
 
-	if (action->size() == 0) {
+	if (DrawOperations::paintGrid(*m_editor, paint) == 0) {
 		m_lastError = "No tile changes were produced";
 		return false;
 	}
-
-	batch->addAndCommitAction(std::move(action));
-	m_editor->addBatch(std::move(batch));
 	return true;
 }
 
@@ -81,6 +81,12 @@ Editor::~Editor() {
 		live_manager.CloseServer();
 	}
 
+	// A save still being written is finished and reported first. Should it
+	// have failed, the journal is kept: it holds the edits the map file lacks.
+	if (!background_save.wait().empty()) {
+		journal.detach();
+	}
+
 	UnnamedRenderingLock();
 	selection.clear();
 	spdlog::info("Editor destroyed [Editor={}]", (void*)this);
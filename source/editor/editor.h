@@ -28,6 +28,8 @@
 #include "editor/operations/selection_operations.h"
 #include "map/operations/map_processor.h"
 #include "editor/persistence/editor_persistence.h"
+#include "editor/persistence/background_save.h"
+#include "editor/persistence/action_journal.h"
 
 #include <memory>
 
@@ -59,6 +61,11 @@ public:
 	GroundBrush* replace_brush;
 	Map map; // The map that is being edited
 	Map* getMap() { return &map; }
+	// Crash recovery between saves. Declared before background_save so a save
+	// still being written is finished before the journal goes away.
+	ActionJournal journal;
+	// Writes saved maps to disk while editing goes on
+	BackgroundSave background_save;
 
 	std::function<void()> onStateChange;
 	void notifyStateChange();
@@ -253,8 +253,9 @@ void EditorManager::SaveCurrentMap(FileName fileName, bool showdialog) {
 
 			EditorPersistence::saveMap(*editor, fileName, showdialog);
 
-			if (!editor->map.hasChanged()) {
-				g_status.SetStatusText("Map saved successfully.");
+			// The files are written in the background, which reports the outcome
+			if (editor->background_save.isRunning()) {
+				g_status.SetStatusText("Writing map to disk...");
 			}
 
 			const std::string& path = editor->map.getFilename();
@@ -487,6 +488,34 @@ bool EditorManager::LoadMap(const FileName& fileName, const MapLoadOptions& load
 	spdlog::info("EditorManager::LoadMap - Adding recent file...");
 	g_gui.root->AddRecentFile(fileName);
 
+	if (g_settings.getBoolean(Config::USE_ACTION_JOURNAL)) {
+		// A journal left next to the map means the editor crashed before saving
+		Editor& loaded = *mapTab->GetEditor();
+		const std::string map_filename = loaded.map.getFilename();
+		ActionJournal::Recovery recovery;
+		bool recovered = false;
+		if (ActionJournal::Exists(map_filename)) {
+			long ret = DialogUtil::PopupDialog(
+				"Recover Unsaved Changes",
+				"The editor was closed without saving \"" + wxstr(map_filename) + "\".\n\nDo you want to restore the changes made since the last save?",
+				wxYES | wxNO
+			);
+			if (ret == wxID_YES) {
+				recovered = ActionJournal::Replay(loaded, map_filename, recovery);
+			}
+		}
+
+		if (!recovered) {
+			loaded.journal.open(map_filename);
+		} else if (recovery.incomplete) {
+			DialogUtil::PopupDialog(
+				"Recover Unsaved Changes",
+				wxString::Format("Restored %zu tiles. Some map-wide operations could not be recorded and are missing.", recovery.tiles),
+				wxOK
+			);
+		}
+	}
+
 	spdlog::info("EditorManager::LoadMap - FitToMap...");
 	mapTab->GetView()->FitToMap();
 	spdlog::info("EditorManager::LoadMap - UpdateTitle...");
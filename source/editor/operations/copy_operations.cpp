@@ -189,7 +189,9 @@ void CopyOperations::paste(Editor& editor, CopyBuffer& buffer, const Position& t
 		}
 
 		TileLocation* dest_location = editor.map.createTileL(pos);
-		std::unique_ptr<Tile> copy_tile = TileOperations::deepCopy(buffer_tile, editor.map);
+		// Shares the buffer's items: pasting the same buffer again, and keeping
+		// the pastes in the undo history, doesn't copy them
+		std::unique_ptr<Tile> copy_tile = TileOperations::sharedCopy(buffer_tile, dest_location, editor.map);
 		Tile* old_dest_tile = dest_location->get();
 		std::unique_ptr<Tile> new_dest_tile_ptr;
 		copy_tile->setLocation(dest_location);
@@ -207,23 +209,13 @@ void CopyOperations::paste(Editor& editor, CopyBuffer& buffer, const Position& t
 			new_dest_tile_ptr = std::move(copy_tile);
 		}
 
-		// Add all surrounding tiles to the map, so they get borders
-		editor.map.createTile(pos.x - 1, pos.y - 1, pos.z);
-		editor.map.createTile(pos.x, pos.y - 1, pos.z);
-		editor.map.createTile(pos.x + 1, pos.y - 1, pos.z);
-		editor.map.createTile(pos.x - 1, pos.y, pos.z);
-		editor.map.createTile(pos.x + 1, pos.y, pos.z);
-		editor.map.createTile(pos.x - 1, pos.y + 1, pos.z);
-		editor.map.createTile(pos.x, pos.y + 1, pos.z);
-		editor.map.createTile(pos.x + 1, pos.y + 1, pos.z);
-
 		action->addChange(std::make_unique<Change>(std::move(new_dest_tile_ptr)));
 	}
 	batchAction->addAndCommitAction(std::move(action));
 
 	if (g_settings.getInteger(Config::USE_AUTOMAGIC) && g_settings.getInteger(Config::BORDERIZE_PASTE)) {
 		action = editor.actionQueue->createAction(batchAction.get());
-		TileList borderize_tiles;
+		PositionList borderize_positions;
 		Map& map = editor.map;
 
 		// Go through all modified (selected) tiles (might be slow)
@@ -233,57 +225,34 @@ void CopyOperations::paste(Editor& editor, CopyBuffer& buffer, const Position& t
 			if (pos.z < 0 || pos.z >= MAP_LAYERS) {
 				continue;
 			}
-			// Go through all neighbours
-			Tile* t;
-			t = map.getTile(pos.x - 1, pos.y - 1, pos.z);
-			if (t && !t->isSelected()) {
-				borderize_tiles.push_back(t);
-				add_me = true;
-			}
-			t = map.getTile(pos.x, pos.y - 1, pos.z);
-			if (t && !t->isSelected()) {
-				borderize_tiles.push_back(t);
-				add_me = true;
-			}
-			t = map.getTile(pos.x + 1, pos.y - 1, pos.z);
-			if (t && !t->isSelected()) {
-				borderize_tiles.push_back(t);
-				add_me = true;
-			}
-			t = map.getTile(pos.x - 1, pos.y, pos.z);
-			if (t && !t->isSelected()) {
-				borderize_tiles.push_back(t);
-				add_me = true;
-			}
-			t = map.getTile(pos.x + 1, pos.y, pos.z);
-			if (t && !t->isSelected()) {
-				borderize_tiles.push_back(t);
-				add_me = true;
-			}
-			t = map.getTile(pos.x - 1, pos.y + 1, pos.z);
-			if (t && !t->isSelected()) {
-				borderize_tiles.push_back(t);
-				add_me = true;
-			}
-			t = map.getTile(pos.x, pos.y + 1, pos.z);
-			if (t && !t->isSelected()) {
-				borderize_tiles.push_back(t);
-				add_me = true;
-			}
-			t = map.getTile(pos.x + 1, pos.y + 1, pos.z);
-			if (t && !t->isSelected()) {
-				borderize_tiles.push_back(t);
-				add_me = true;
+			// Go through all neighbours, including the empty ones that may
+			// receive a border from the pasted ground
+			for (int dy = -1; dy <= 1; ++dy) {
+				for (int dx = -1; dx <= 1; ++dx) {
+					if (dx == 0 && dy == 0) {
+						continue;
+					}
+					const Position neighbour(pos.x + dx, pos.y + dy, pos.z);
+					if (!neighbour.isValid()) {
+						continue;
+					}
+					const Tile* t = map.getTile(neighbour);
+					if (!t || !t->isSelected()) {
+						borderize_positions.push_back(neighbour);
+						add_me = true;
+					}
+				}
 			}
 			if (add_me) {
-				borderize_tiles.push_back(map.getTile(pos));
+				borderize_positions.push_back(pos);
 			}
 		}
 		// Remove duplicates
-		borderize_tiles.sort();
-		borderize_tiles.unique();
+		borderize_positions.sort();
+		borderize_positions.unique();
 
-		for (Tile* tile : borderize_tiles) {
+		for (const Position& pos : borderize_positions) {
+			Tile* tile = map.getTile(pos);
 			if (tile) {
 				std::unique_ptr<Tile> newTile = TileOperations::deepCopy(tile, editor.map);
 				TileOperations::borderize(newTile.get(), &map);
@@ -293,7 +262,14 @@ void CopyOperations::paste(Editor& editor, CopyBuffer& buffer, const Position& t
 				}
 
 				TileOperations::wallize(newTile.get(), &map);
-				action->addChange(std::make_unique<Change>(std::move(newTile)));
+				action->addChange(std::move(newTile), tile);
+			} else {
+				// Only materialize empty neighbours that actually gain a border
+				std::unique_ptr<Tile> newTile(map.allocator(map.createTileL(pos)));
+				TileOperations::borderize(newTile.get(), &map);
+				if (!newTile->empty()) {
+					action->addChange(std::make_unique<Change>(std::move(newTile)));
+				}
 			}
 		}
 
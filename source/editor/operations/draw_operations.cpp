@@ -68,7 +68,7 @@ namespace {
 				if (tile) {
 					std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
 					brush->undraw(&editor.map, new_tile.get());
-					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+					action->addChange(std::move(new_tile), tile);
 				}
 				tilestoborder.push_back(pos);
 				continue;
@@ -90,7 +90,7 @@ namespace {
 						SelectionOperations::removeDuplicateWalls(buffer_tile, new_tile.get());
 						SelectionOperations::doSurroundingBorders(brush, tilestoborder, buffer_tile, new_tile.get());
 						TileOperations::merge(new_tile.get(), buffer_tile);
-						action->addChange(std::make_unique<Change>(std::move(new_tile)));
+						action->addChange(std::move(new_tile), tile);
 					}
 				} else {
 					std::unique_ptr<Tile> new_tile(editor.map.allocator(location));
@@ -115,7 +115,7 @@ namespace {
 						SelectionOperations::removeDuplicateWalls(buffer_tile, new_tile.get());
 						SelectionOperations::doSurroundingBorders(brush, tilestoborder, buffer_tile, new_tile.get());
 						TileOperations::merge(new_tile.get(), buffer_tile);
-						action->addChange(std::make_unique<Change>(std::move(new_tile)));
+						action->addChange(std::move(new_tile), tile);
 					}
 				}
 			}
@@ -135,7 +135,7 @@ namespace {
 					std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
 					TileOperations::borderize(new_tile.get(), &editor.map);
 					TileOperations::wallize(new_tile.get(), &editor.map);
-					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+					action->addChange(std::move(new_tile), tile);
 				}
 			}
 			batch->addAndCommitAction(std::move(action));
@@ -143,11 +143,30 @@ namespace {
 		editor.addBatch(std::move(batch), 2);
 	}
 
+	// Strokes touching more tiles than this (flood fills) are committed in
+	// chunks of this size behind a progress bar, which keeps the UI painting.
+	constexpr size_t LARGE_DRAW_CHUNK = 16384;
+
 	template <typename T>
 	void drawGroundOrEraserImpl(Editor& editor, T* brush, const PositionVector& tilestodraw, PositionVector& tilestoborder, bool alt, bool dodraw) {
 		std::unique_ptr<BatchAction> batch = editor.actionQueue->createBatch(ACTION_DRAW);
 		std::unique_ptr<Action> action = editor.actionQueue->createAction(batch.get());
 
+		const size_t total_work = tilestodraw.size() + tilestoborder.size();
+		const bool chunked = total_work > LARGE_DRAW_CHUNK;
+		size_t work_done = 0;
+		if (chunked) {
+			g_gui.CreateLoadBar("Drawing...");
+		}
+		const auto advance = [&]() {
+			if (!chunked || ++work_done % LARGE_DRAW_CHUNK != 0) {
+				return;
+			}
+			batch->addAndCommitAction(std::move(action));
+			action = editor.actionQueue->createAction(batch.get());
+			g_gui.SetLoadDone(static_cast<int32_t>(std::min<size_t>(99, work_done * 100 / total_work)));
+		};
+
 		std::pair<bool, GroundBrush*> param_obj;
 		std::pair<bool, GroundBrush*>* param = nullptr;
 		if constexpr (std::is_same_v<T, GroundBrush>) {
@@ -178,12 +197,13 @@ namespace {
 					brush->undraw(&editor.map, new_tile.get());
 					tilestoborder.push_back(drawPos);
 				}
-				action->addChange(std::make_unique<Change>(std::move(new_tile)));
+				action->addChange(std::move(new_tile), tile);
 			} else if (dodraw) {
 				std::unique_ptr<Tile> new_tile(editor.map.allocator(location));
 				brush->draw(&editor.map, new_tile.get(), param);
 				action->addChange(std::make_unique<Change>(std::move(new_tile)));
 			}
+			advance();
 		}
 
 		// Commit changes to map
@@ -203,7 +223,7 @@ namespace {
 						TileOperations::carpetize(new_tile.get(), &editor.map);
 					}
 					TileOperations::borderize(new_tile.get(), &editor.map);
-					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+					action->addChange(std::move(new_tile), tile);
 				} else {
 					std::unique_ptr<Tile> new_tile(editor.map.allocator(location));
 					if (brush->template is<EraserBrush>()) {
@@ -217,10 +237,14 @@ namespace {
 						action->addChange(std::make_unique<Change>(std::move(new_tile)));
 					}
 				}
+				advance();
 			}
 			batch->addAndCommitAction(std::move(action));
 		}
 
+		if (chunked) {
+			g_gui.DestroyLoadBar();
+		}
 		editor.addBatch(std::move(batch), 2);
 	}
 
@@ -279,7 +303,7 @@ namespace {
 					} else {
 						brush->undraw(&editor.map, new_tile.get());
 					}
-					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+					action->addChange(std::move(new_tile), tile);
 				} else if (dodraw) {
 					std::unique_ptr<Tile> new_tile(editor.map.allocator(location));
 					brush->draw(&editor.map, new_tile.get(), nullptr);
@@ -298,8 +322,7 @@ namespace {
 					if (tile) {
 						std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
 						TileOperations::wallize(new_tile.get(), &editor.map);
-						// if(*tile == *new_tile) delete new_tile;
-						action->addChange(std::make_unique<Change>(std::move(new_tile)));
+						action->addChange(std::move(new_tile), tile);
 					}
 				}
 				batch->addAndCommitAction(std::move(action));
@@ -309,6 +332,46 @@ namespace {
 		editor.addBatch(std::move(batch), 2);
 	}
 
+	// Calls fn(floor_x, floor_y, min_x, min_y, end_x, end_y) once per 4x4 map
+	// node overlapping the area, with the part of the area inside that node.
+	// Working a node at a time resolves each leaf and floor once, not per tile.
+	template <typename Fn>
+	void forEachNodeBlock(int x0, int y0, int width, int height, Fn&& fn) {
+		const int x1 = x0 + width;
+		const int y1 = y0 + height;
+		for (int ny = y0 & ~3; ny < y1; ny += 4) {
+			for (int nx = x0 & ~3; nx < x1; nx += 4) {
+				fn(nx, ny, std::max(nx, x0), std::max(ny, y0), std::min(nx + 4, x1), std::min(ny + 4, y1));
+			}
+		}
+	}
+
+	void applyGridPaintEntry(Editor& editor, const GridPaintEntry& entry, Tile* tile, bool automagic) {
+		if (entry.brush) {
+			if (entry.brush->is<GroundBrush>() && automagic) {
+				if (g_settings.getBoolean(Config::PRESERVE_MANUAL_BORDERS)) {
+					TileOperations::cleanAutoBorders(tile);
+				} else {
+					TileOperations::cleanBorders(tile);
+				}
+			} else if (entry.brush->is<WallBrush>()) {
+				TileOperations::cleanWalls(tile, entry.brush->as<WallBrush>());
+			}
+			entry.brush->draw(&editor.map, tile, nullptr);
+		}
+		for (uint16_t id : entry.items) {
+			auto item = Item::Create(id);
+			if (!item) {
+				continue;
+			}
+			if (item->isGroundTile()) {
+				tile->ground = std::move(item);
+			} else {
+				tile->addItem(std::move(item));
+			}
+		}
+	}
+
 } // namespace
 
 void DrawOperations::draw(Editor& editor, Position offset, bool alt, bool dodraw) {
@@ -567,12 +630,12 @@ void DrawOperations::draw(Editor& editor, const PositionVector& tilestodraw, boo
 					std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
 					brush->draw(&editor.map, new_tile.get());
 					TileOperations::borderize(new_tile.get(), &editor.map);
-					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+					action->addChange(std::move(new_tile), tile);
 				} else if (!dodraw && tile->hasOptionalBorder()) {
 					std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
 					brush->undraw(&editor.map, new_tile.get());
 					TileOperations::borderize(new_tile.get(), &editor.map);
-					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+					action->addChange(std::move(new_tile), tile);
 				}
 			} else if (dodraw) {
 				std::unique_ptr<Tile> new_tile(editor.map.allocator(location));
@@ -684,7 +747,7 @@ void DrawOperations::draw(Editor& editor, const PositionVector& tilestodraw, boo
 				} else {
 					brush->undraw(&editor.map, new_tile.get());
 				}
-				action->addChange(std::make_unique<Change>(std::move(new_tile)));
+				action->addChange(std::move(new_tile), tile);
 			} else if (dodraw) {
 				std::unique_ptr<Tile> new_tile(editor.map.allocator(location));
 				brush->draw(&editor.map, new_tile.get(), &alt);
@@ -719,7 +782,7 @@ void DrawOperations::draw(Editor& editor, const PositionVector& tilestodraw, Pos
 				} else {
 					brush->undraw(&editor.map, new_tile.get());
 				}
-				action->addChange(std::make_unique<Change>(std::move(new_tile)));
+				action->addChange(std::move(new_tile), tile);
 			} else if (dodraw) {
 				std::unique_ptr<Tile> new_tile(editor.map.allocator(location));
 				brush->draw(&editor.map, new_tile.get(), nullptr);
@@ -744,13 +807,13 @@ void DrawOperations::draw(Editor& editor, const PositionVector& tilestodraw, Pos
 				if (tile && tile->hasTable()) {
 					std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
 					TileOperations::tableize(new_tile.get(), &editor.map);
-					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+					action->addChange(std::move(new_tile), tile);
 				}
 			} else if (brush->is<CarpetBrush>()) {
 				if (tile && tile->hasCarpet()) {
 					std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
 					TileOperations::carpetize(new_tile.get(), &editor.map, carpetOnlyBrush);
-					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+					action->addChange(std::move(new_tile), tile);
 				}
 			}
 		}
@@ -779,7 +842,7 @@ void DrawOperations::draw(Editor& editor, const PositionVector& tilestodraw, Pos
 				} else {
 					door_brush->undraw(&editor.map, new_tile.get());
 				}
-				action->addChange(std::make_unique<Change>(std::move(new_tile)));
+				action->addChange(std::move(new_tile), tile);
 			} else if (dodraw) {
 				std::unique_ptr<Tile> new_tile(editor.map.allocator(location));
 				door_brush->draw(&editor.map, new_tile.get(), &alt);
@@ -798,8 +861,7 @@ void DrawOperations::draw(Editor& editor, const PositionVector& tilestodraw, Pos
 				if (tile) {
 					std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
 					TileOperations::wallize(new_tile.get(), &editor.map);
-					// if(*tile == *new_tile) delete new_tile;
-					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+					action->addChange(std::move(new_tile), tile);
 				}
 			}
 			batch->addAndCommitAction(std::move(action));
@@ -818,7 +880,7 @@ void DrawOperations::draw(Editor& editor, const PositionVector& tilestodraw, Pos
 				} else {
 					brush->undraw(&editor.map, new_tile.get());
 				}
-				action->addChange(std::make_unique<Change>(std::move(new_tile)));
+				action->addChange(std::move(new_tile), tile);
 			} else if (dodraw) {
 				std::unique_ptr<Tile> new_tile(editor.map.allocator(location));
 				brush->draw(&editor.map, new_tile.get());
@@ -850,7 +912,7 @@ void DrawOperations::eraseGroundWithBorders(Editor& editor, const PositionVector
 			TileOperations::cleanBorders(new_tile.get());
 		}
 		new_tile->ground = nullptr;
-		action->addChange(std::make_unique<Change>(std::move(new_tile)));
+		action->addChange(std::move(new_tile), tile);
 		erased.push_back(pos);
 	}
 	if (erased.empty()) {
@@ -877,7 +939,7 @@ void DrawOperations::eraseGroundWithBorders(Editor& editor, const PositionVector
 				if (border_tile) {
 					std::unique_ptr<Tile> border_copy = TileOperations::deepCopy(border_tile, editor.map);
 					TileOperations::borderize(border_copy.get(), &editor.map);
-					action->addChange(std::make_unique<Change>(std::move(border_copy)));
+					action->addChange(std::move(border_copy), border_tile);
 				}
 			}
 		}
@@ -886,3 +948,146 @@ void DrawOperations::eraseGroundWithBorders(Editor& editor, const PositionVector
 
 	editor.addBatch(std::move(batch), 2);
 }
+
+size_t DrawOperations::paintGrid(Editor& editor, const GridPaint& paint) {
+	if (paint.width <= 0 || paint.height <= 0 || paint.cells.size() < static_cast<size_t>(paint.width) * paint.height) {
+		return 0;
+	}
+
+	const int z = paint.origin.z;
+	const bool automagic = g_settings.getInteger(Config::USE_AUTOMAGIC);
+	const bool do_borders = paint.borderize && automagic;
+	const bool do_walls = do_borders && std::ranges::any_of(paint.palette, [](const GridPaintEntry& entry) {
+		return entry.brush && entry.brush->is<WallBrush>();
+	});
+
+	// Clip the grid to the map; cells outside it are dropped.
+	const int x0 = std::max(0, paint.origin.x);
+	const int y0 = std::max(0, paint.origin.y);
+	const int x1 = std::min(paint.origin.x + paint.width, MAP_MAX_WIDTH + 1);
+	const int y1 = std::min(paint.origin.y + paint.height, MAP_MAX_HEIGHT + 1);
+	if (x0 >= x1 || y0 >= y1 || z < 0 || z > MAP_MAX_LAYER) {
+		return 0;
+	}
+
+	const auto entryAt = [&](int x, int y) -> const GridPaintEntry* {
+		const int32_t index = paint.cells[static_cast<size_t>(y - paint.origin.y) * paint.width + (x - paint.origin.x)];
+		if (index < 0 || static_cast<size_t>(index) >= paint.palette.size()) {
+			return nullptr;
+		}
+		const GridPaintEntry& entry = paint.palette[index];
+		return entry.brush || !entry.items.empty() ? &entry : nullptr;
+	};
+
+	// Every changed tile and its 8 neighbours get borderized afterwards. The
+	// mask covers the clipped area grown by one tile on each side.
+	const int mask_x = x0 - 1;
+	const int mask_y = y0 - 1;
+	const int mask_w = x1 - x0 + 2;
+	const int mask_h = y1 - y0 + 2;
+	std::vector<uint8_t> border_mask;
+	if (do_borders) {
+		border_mask.assign(static_cast<size_t>(mask_w) * mask_h, 0);
+	}
+
+	std::unique_ptr<BatchAction> batch = editor.actionQueue->createBatch(ACTION_DRAW);
+	std::unique_ptr<Action> action = editor.actionQueue->createAction(batch.get());
+
+	const size_t total_work = static_cast<size_t>(x1 - x0) * (y1 - y0) * (do_borders ? 2 : 1);
+	const bool chunked = total_work > LARGE_DRAW_CHUNK;
+	size_t work_done = 0;
+	if (chunked) {
+		g_gui.CreateLoadBar("Painting grid...");
+	}
+	const auto advance = [&]() {
+		if (!chunked || ++work_done % LARGE_DRAW_CHUNK != 0) {
+			return;
+		}
+		batch->addAndCommitAction(std::move(action));
+		action = editor.actionQueue->createAction(batch.get());
+		g_gui.SetLoadDone(static_cast<int32_t>(std::min<size_t>(99, work_done * 100 / total_work)));
+	};
+
+	size_t changed = 0;
+	forEachNodeBlock(x0, y0, x1 - x0, y1 - y0, [&](int nx, int ny, int min_x, int min_y, int end_x, int end_y) {
+		Floor* floor = nullptr;
+		for (int x = min_x; x < end_x; ++x) {
+			for (int y = min_y; y < end_y; ++y) {
+				advance();
+				const GridPaintEntry* entry = entryAt(x, y);
+				if (!entry) {
+					continue;
+				}
+				if (!floor) {
+					floor = editor.map.createLeaf(nx, ny)->createFloor(nx, ny, z);
+				}
+				TileLocation* location = &floor->locs[(x & 3) * 4 + (y & 3)];
+				Tile* tile = location->get();
+
+				std::unique_ptr<Tile> new_tile = tile ? TileOperations::deepCopy(tile, location, editor.map) : editor.map.allocator(location);
+				applyGridPaintEntry(editor, *entry, new_tile.get(), automagic);
+
+				if (tile) {
+					if (!action->addChange(std::move(new_tile), tile)) {
+						continue;
+					}
+				} else if (new_tile->empty()) {
+					continue;
+				} else {
+					action->addChange(std::make_unique<Change>(std::move(new_tile)));
+				}
+				++changed;
+
+				if (do_borders) {
+					for (int dy = 0; dy < 3; ++dy) {
+						uint8_t* row = border_mask.data() + static_cast<size_t>(y - mask_y - 1 + dy) * mask_w + (x - mask_x - 1);
+						row[0] = row[1] = row[2] = 1;
+					}
+				}
+			}
+		}
+	});
+	batch->addAndCommitAction(std::move(action));
+
+	if (do_borders && changed > 0) {
+		action = editor.actionQueue->createAction(batch.get());
+		forEachNodeBlock(mask_x, mask_y, mask_w, mask_h, [&](int nx, int ny, int min_x, int min_y, int end_x, int end_y) {
+			Floor* floor = nullptr;
+			for (int x = min_x; x < end_x; ++x) {
+				for (int y = min_y; y < end_y; ++y) {
+					advance();
+					if (!border_mask[static_cast<size_t>(y - mask_y) * mask_w + (x - mask_x)] || x < 0 || y < 0 || x > MAP_MAX_WIDTH || y > MAP_MAX_HEIGHT) {
+						continue;
+					}
+					if (!floor) {
+						floor = editor.map.createLeaf(nx, ny)->createFloor(nx, ny, z);
+					}
+					TileLocation* location = &floor->locs[(x & 3) * 4 + (y & 3)];
+					Tile* tile = location->get();
+					if (tile) {
+						std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, location, editor.map);
+						if (do_walls) {
+							TileOperations::wallize(new_tile.get(), &editor.map);
+						}
+						TileOperations::borderize(new_tile.get(), &editor.map);
+						action->addChange(std::move(new_tile), tile);
+					} else {
+						std::unique_ptr<Tile> new_tile = editor.map.allocator(location);
+						TileOperations::borderize(new_tile.get(), &editor.map);
+						if (!new_tile->empty()) {
+							action->addChange(std::make_unique<Change>(std::move(new_tile)));
+						}
+					}
+				}
+			}
+		});
+		batch->addAndCommitAction(std::move(action));
+	}
+
+	if (chunked) {
+		g_gui.DestroyLoadBar();
+	}
+	// A generated area is its own undo step, never merged into a stroke
+	editor.addBatch(std::move(batch));
+	return changed;
+}
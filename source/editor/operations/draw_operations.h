@@ -3,10 +3,31 @@
 
 #include "app/rme_forward_declarations.h"
 #include "map/position.h"
+#include <cstdint>
+#include <vector>
 // We don't want partial define of Editor, so forward declare or include?
 // Ideally forward declare to avoid circular dependency if Editor includes this.
 class Editor;
 
+// What one palette index of a grid paint puts on a tile: an optional ground
+// or wall brush, then raw items stacked in order (ground items replace the
+// ground).
+struct GridPaintEntry {
+	Brush* brush = nullptr;
+	std::vector<uint16_t> items;
+};
+
+// A width x height block of palette indices whose first cell lands on
+// origin. Cells holding an index without a palette entry are left alone.
+struct GridPaint {
+	Position origin;
+	int width = 0;
+	int height = 0;
+	std::vector<int32_t> cells; // Row-major, width * height
+	std::vector<GridPaintEntry> palette;
+	bool borderize = true; // Only honoured with USE_AUTOMAGIC enabled
+};
+
 class DrawOperations {
 public:
 	static void draw(Editor& editor, Position offset, bool alt, bool dodraw);
@@ -20,6 +41,13 @@ public:
 	// canvas shortcut, which passes the current brush footprint. Positions without ground
 	// are skipped; no-op if none of them has ground.
 	static void eraseGroundWithBorders(Editor& editor, const PositionVector& positions);
+
+	// Paints a whole grid as one undoable batch. Tiles are created a map node
+	// at a time, grounds are placed without per-tile border work, and the
+	// painted area plus a one-tile ring is borderized (and wallized, when a
+	// wall brush is used) in a single pass afterwards. Returns the number of
+	// tiles that actually changed.
+	static size_t paintGrid(Editor& editor, const GridPaint& paint);
 };
 
 #endif
@@ -0,0 +1,433 @@
+//////////////////////////////////////////////////////////////////////
+// This file is part of Remere's Map Editor
+//////////////////////////////////////////////////////////////////////
+
+#include "app/main.h"
+#include "editor/persistence/action_journal.h"
+
+#include "editor/action.h"
+#include "editor/action_queue.h"
+#include "editor/editor.h"
+#include "game/creature.h"
+#include "game/creatures.h"
+#include "game/spawn.h"
+#include "io/iomap_otbm.h"
+#include "io/otbm/tile_serialization_otbm.h"
+#include "map/map.h"
+#include "map/tile.h"
+#include "map/tile_operations.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <spdlog/spdlog.h>
+
+namespace {
+	constexpr char JOURNAL_MAGIC[4] = { 'R', 'M', 'E', 'J' };
+	constexpr uint32_t JOURNAL_VERSION = 1;
+	constexpr long JOURNAL_HEADER_SIZE = sizeof(JOURNAL_MAGIC) + sizeof(JOURNAL_VERSION);
+	// Anything larger is treated as a corrupt length
+	constexpr uint32_t MAX_RECORD_SIZE = 1u << 30;
+
+	// Node types inside a tiles record
+	enum : uint8_t {
+		JOURNAL_ROOT = 0,
+		JOURNAL_TILE = 1,
+	};
+
+	enum : uint8_t {
+		JOURNAL_TILE_SPAWN = 1 << 0,
+		JOURNAL_TILE_CREATURE = 1 << 1,
+	};
+
+	bool writeHeader(FILE* file) {
+		fwrite(JOURNAL_MAGIC, 1, sizeof(JOURNAL_MAGIC), file);
+		fwrite(&JOURNAL_VERSION, sizeof(JOURNAL_VERSION), 1, file);
+		return ferror(file) == 0;
+	}
+}
+
+ActionJournal::~ActionJournal() {
+	// Destruction is a clean close, the journal is only needed after a crash
+	discard();
+}
+
+std::string ActionJournal::PathFor(const std::string& map_filename) {
+	return map_filename + ".journal";
+}
+
+bool ActionJournal::Exists(const std::string& map_filename) {
+	return !map_filename.empty() && wxFileExists(wxstr(PathFor(map_filename)));
+}
+
+bool ActionJournal::open(const std::string& map_filename) {
+	discard();
+
+	path = PathFor(map_filename);
+	file.reset(fopen(path.c_str(), "wb"));
+	if (!file || !writeHeader(file.get())) {
+		spdlog::warn("ActionJournal: could not create {}", path);
+		file.reset();
+		std::remove(path.c_str());
+		path.clear();
+		return false;
+	}
+	fflush(file.get());
+
+	this->map_filename = map_filename;
+	next_checkpoint = 1;
+	checkpoints.clear();
+	return true;
+}
+
+void ActionJournal::discard() {
+	if (!path.empty()) {
+		file.reset();
+		std::remove(path.c_str());
+	}
+	path.clear();
+	map_filename.clear();
+	checkpoints.clear();
+}
+
+std::string ActionJournal::detach() {
+	std::string detached = std::move(path);
+	file.reset();
+	path.clear();
+	map_filename.clear();
+	checkpoints.clear();
+	return detached;
+}
+
+uint32_t ActionJournal::Checksum(const uint8_t* data, size_t size) {
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+bool ActionJournal::append(RecordKind kind, const uint8_t* data, size_t size) {
+	if (!file) {
+		return false;
+	}
+
+	const uint8_t kind_byte = kind;
+	const uint32_t record_size = static_cast<uint32_t>(size);
+	const uint32_t checksum = Checksum(data, size);
+	fwrite(&kind_byte, 1, 1, file.get());
+	fwrite(&record_size, sizeof(record_size), 1, file.get());
+	fwrite(&checksum, sizeof(checksum), 1, file.get());
+	if (size > 0) {
+		fwrite(data, 1, size, file.get());
+	}
+	fflush(file.get());
+
+	if (ferror(file.get()) != 0) {
+		// Keep what was written so far; a torn record is dropped on replay
+		spdlog::error("ActionJournal: failed to write {}, journaling stopped", path);
+		file.reset();
+		return false;
+	}
+	return true;
+}
+
+void ActionJournal::recordTiles(const Map& map, const std::vector<Position>& positions) {
+	if (!file || positions.empty()) {
+		return;
+	}
+
+	IOMapOTBM iomap(map.getVersion());
+	MemoryNodeFileWriteHandle writer;
+	writer.addNode(JOURNAL_ROOT);
+	for (const Position& pos : positions) {
+		const Tile* tile = map.getTile(pos);
+
+		uint8_t flags = 0;
+		if (tile && tile->spawn) {
+			flags |= JOURNAL_TILE_SPAWN;
+		}
+		if (tile && tile->creature) {
+			flags |= JOURNAL_TILE_CREATURE;
+		}
+
+		writer.addNode(JOURNAL_TILE);
+		writer.addU16(pos.x);
+		writer.addU16(pos.y);
+		writer.addU8(pos.z);
+		writer.addU8(flags);
+
+		// Spawns and creatures live in the XML files, not in OTBM tile data
+		if (flags & JOURNAL_TILE_SPAWN) {
+			writer.addU32(tile->spawn->getSize());
+		}
+		if (flags & JOURNAL_TILE_CREATURE) {
+			writer.addString(tile->creature->getName());
+			writer.addU8(tile->creature->isNpc() ? 1 : 0);
+			writer.addU32(static_cast<uint32_t>(tile->creature->getSpawnTime()));
+			writer.addU8(static_cast<uint8_t>(tile->creature->getDirection()));
+		}
+
+		// A missing or empty tile is recorded without an area node
+		if (tile && !tile->empty()) {
+			writer.addNode(OTBM_TILE_AREA);
+			writer.addU16(pos.x & 0xFF00);
+			writer.addU16(pos.y & 0xFF00);
+			writer.addU8(pos.z);
+			TileSerializationOTBM::serializeTile(iomap, tile, writer);
+			writer.endNode();
+		}
+		writer.endNode();
+	}
+	writer.endNode();
+
+	append(RECORD_TILES, writer.getMemory(), writer.getSize());
+}
+
+void ActionJournal::recordUntracked() {
+	append(RECORD_UNTRACKED, nullptr, 0);
+}
+
+uint32_t ActionJournal::beginCheckpoint() {
+	if (!file) {
+		return 0;
+	}
+
+	const uint32_t id = next_checkpoint++;
+	if (append(RECORD_CHECKPOINT, reinterpret_cast<const uint8_t*>(&id), sizeof(id))) {
+		checkpoints.emplace_back(id, ftell(file.get()));
+	}
+	return id;
+}
+
+void ActionJournal::endCheckpoint(uint32_t id) {
+	if (!file || id == 0) {
+		return;
+	}
+
+	auto it = std::ranges::find_if(checkpoints, [id](const auto& checkpoint) {
+		return checkpoint.first == id;
+	});
+	if (it == checkpoints.end()) {
+		return;
+	}
+
+	if (!append(RECORD_CHECKPOINT_DONE, reinterpret_cast<const uint8_t*>(&id), sizeof(id))) {
+		return;
+	}
+
+	const long offset = it->second;
+	if (compact(offset)) {
+		const long dropped = offset - JOURNAL_HEADER_SIZE;
+		checkpoints.erase(checkpoints.begin(), it + 1);
+		for (auto& checkpoint : checkpoints) {
+			checkpoint.second -= dropped;
+		}
+	}
+}
+
+bool ActionJournal::compact(long offset) {
+	file.reset();
+
+	std::vector<char> tail;
+	{
+		std::ifstream in(path, std::ios::binary);
+		in.seekg(offset);
+		tail.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	const std::string tmp = path + ".tmp";
+	bool ok = false;
+	{
+		FilePtr out(fopen(tmp.c_str(), "wb"));
+		if (out && writeHeader(out.get())) {
+			if (!tail.empty()) {
+				fwrite(tail.data(), 1, tail.size(), out.get());
+			}
+			ok = ferror(out.get()) == 0;
+		}
+	}
+
+	if (ok && std::rename(tmp.c_str(), path.c_str()) != 0) {
+		// rename does not replace an existing file everywhere
+		std::remove(path.c_str());
+		ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+	}
+	if (!ok) {
+		spdlog::warn("ActionJournal: could not compact {}", path);
+		std::remove(tmp.c_str());
+	}
+
+	file.reset(fopen(path.c_str(), "ab"));
+	if (!file) {
+		spdlog::error("ActionJournal: could not reopen {}, journaling stopped", path);
+	}
+	return ok;
+}
+
+bool ActionJournal::ReadRecords(const std::string& path, std::vector<Record>& records) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		return false;
+	}
+
+	char magic[sizeof(JOURNAL_MAGIC)];
+	uint32_t version = 0;
+	if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, JOURNAL_MAGIC, sizeof(magic)) != 0) {
+		return false;
+	}
+	if (!in.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != JOURNAL_VERSION) {
+		return false;
+	}
+
+	while (true) {
+		uint8_t kind = 0;
+		uint32_t size = 0;
+		uint32_t checksum = 0;
+		if (!in.read(reinterpret_cast<char*>(&kind), 1) || !in.read(reinterpret_cast<char*>(&size), sizeof(size)) || !in.read(reinterpret_cast<char*>(&checksum), sizeof(checksum))) {
+			break;
+		}
+		if (size > MAX_RECORD_SIZE) {
+			break;
+		}
+
+		Record record { static_cast<RecordKind>(kind), std::vector<uint8_t>(size) };
+		if (size > 0 && !in.read(reinterpret_cast<char*>(record.payload.data()), size)) {
+			break; // Torn by the crash
+		}
+		if (Checksum(record.payload.data(), size) != checksum) {
+			break;
+		}
+		records.push_back(std::move(record));
+	}
+	return true;
+}
+
+bool ActionJournal::Replay(Editor& editor, const std::string& map_filename, Recovery& result) {
+	std::vector<Record> records;
+	if (!ReadRecords(PathFor(map_filename), records)) {
+		return false;
+	}
+
+	// Start after the checkpoint of the last save that reached the disk; when
+	// that checkpoint was compacted away the whole journal is newer than it
+	const Record* last_done = nullptr;
+	for (const Record& record : records) {
+		if (record.kind == RECORD_CHECKPOINT_DONE) {
+			last_done = &record;
+		}
+	}
+
+	size_t start = 0;
+	if (last_done) {
+		for (size_t i = 0; i < records.size(); ++i) {
+			if (records[i].kind == RECORD_CHECKPOINT && records[i].payload == last_done->payload) {
+				start = i + 1;
+			}
+		}
+	}
+
+	// Later records overwrite earlier ones in a scratch map, so only the last
+	// state of every position ends up in the action
+	Map scratch;
+	IOMapOTBM iomap(editor.map.getVersion());
+	std::vector<Position> positions;
+
+	for (size_t i = start; i < records.size(); ++i) {
+		const Record& record = records[i];
+		if (record.kind == RECORD_UNTRACKED) {
+			result.incomplete = true;
+			continue;
+		}
+		if (record.kind != RECORD_TILES) {
+			continue;
+		}
+
+		MemoryNodeFileReadHandle reader(record.payload.data(), record.payload.size());
+		BinaryNode* root = reader.getRootNode();
+		uint8_t root_type;
+		if (!root || !root->getByte(root_type) || root_type != JOURNAL_ROOT) {
+			continue;
+		}
+
+		for (BinaryNode* node : root->children()) {
+			uint8_t node_type;
+			uint16_t x, y;
+			uint8_t z, flags;
+			if (!node->getByte(node_type) || node_type != JOURNAL_TILE) {
+				continue;
+			}
+			if (!node->getU16(x) || !node->getU16(y) || !node->getU8(z) || !node->getU8(flags)) {
+				continue;
+			}
+
+			const Position pos(x, y, z);
+			positions.push_back(pos);
+			(void)scratch.setTile(pos, std::unique_ptr<Tile>());
+
+			uint32_t spawn_size = 0;
+			std::string creature_name;
+			uint8_t npc = 0;
+			uint32_t spawntime = 0;
+			uint8_t direction = SOUTH;
+			if (flags & JOURNAL_TILE_SPAWN) {
+				node->getU32(spawn_size);
+			}
+			if (flags & JOURNAL_TILE_CREATURE) {
+				node->getString(creature_name);
+				node->getU8(npc);
+				node->getU32(spawntime);
+				node->getU8(direction);
+			}
+
+			for (BinaryNode* area : node->children()) {
+				uint8_t area_type;
+				if (area->getByte(area_type) && area_type == OTBM_TILE_AREA) {
+					TileSerializationOTBM::readTileArea(iomap, scratch, area);
+				}
+			}
+
+			if ((flags & JOURNAL_TILE_SPAWN) && spawn_size > 0) {
+				scratch.getOrCreateTile(pos)->spawn = std::make_unique<Spawn>(static_cast<int>(spawn_size));
+			}
+			if ((flags & JOURNAL_TILE_CREATURE) && !creature_name.empty()) {
+				CreatureType* type = g_creatures[creature_name];
+				if (!type) {
+					type = g_creatures.addMissingCreatureType(creature_name, npc != 0);
+				}
+				Tile* tile = scratch.getOrCreateTile(pos);
+				tile->creature = std::make_unique<Creature>(type);
+				tile->creature->setSpawnTime(static_cast<int>(spawntime));
+				if (direction >= DIRECTION_FIRST && direction <= DIRECTION_LAST) {
+					tile->creature->setDirection(static_cast<Direction>(direction));
+				}
+			}
+		}
+	}
+
+	std::sort(positions.begin(), positions.end());
+	positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+	std::unique_ptr<Action> action = editor.actionQueue->createAction(ACTION_RECOVER_JOURNAL);
+	for (const Position& pos : positions) {
+		const Tile* tile = scratch.getTile(pos);
+		if (tile && !tile->empty()) {
+			action->addChange(std::make_unique<Change>(TileOperations::deepCopy(tile, editor.map)));
+		} else if (editor.map.getTile(pos)) {
+			action->addChange(std::make_unique<Change>(editor.map.allocator(editor.map.createTileL(pos))));
+		}
+	}
+
+	// The fresh journal records the recovered tiles themselves
+	editor.journal.open(map_filename);
+
+	result.tiles = action->size();
+	if (result.tiles > 0) {
+		editor.addAction(std::move(action));
+	}
+	return true;
+}
@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////
+// This file is part of Remere's Map Editor
+//////////////////////////////////////////////////////////////////////
+
+#ifndef RME_ACTION_JOURNAL_H
+#define RME_ACTION_JOURNAL_H
+
+#include "io/filehandle.h"
+#include "map/position.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Editor;
+class Map;
+
+// Write-ahead journal of committed actions, kept next to the map as
+// "<map file>.journal" so a crash between saves loses nothing.
+//
+// Every committed, undone or redone batch appends the resulting state of the
+// tiles it touched (OTBM-encoded, plus spawn and creature data). Records are
+// absolute tile states, so replaying them in order onto the last saved map is
+// idempotent. Saving writes a checkpoint; once the save reached the disk the
+// records before it are dropped. A clean close deletes the journal, so one
+// found when a map is opened was left behind by a crash.
+class ActionJournal {
+public:
+	ActionJournal() = default;
+	~ActionJournal();
+
+	ActionJournal(const ActionJournal&) = delete;
+	ActionJournal& operator=(const ActionJournal&) = delete;
+
+	static std::string PathFor(const std::string& map_filename);
+	static bool Exists(const std::string& map_filename);
+
+	struct Recovery {
+		// Tiles restored from the journal
+		size_t tiles = 0;
+		// Map-wide operations ran that the journal could not record
+		bool incomplete = false;
+	};
+	// Applies the journal left next to map_filename onto the editor's map as
+	// one undoable action, then starts the editor's journal afresh. Returns
+	// false if there is no readable journal.
+	static bool Replay(Editor& editor, const std::string& map_filename, Recovery& result);
+
+	// Starts an empty journal for the map saved at map_filename, replacing any
+	// journal already there
+	bool open(const std::string& map_filename);
+	// Stops journaling and deletes the journal file
+	void discard();
+	// Stops journaling but leaves the journal file in place; returns its path
+	// (empty if no journal was open)
+	std::string detach();
+
+	bool isOpen() const {
+		return file != nullptr;
+	}
+	const std::string& getMapFilename() const {
+		return map_filename;
+	}
+
+	// Appends the current state of the tiles at the given positions
+	void recordTiles(const Map& map, const std::vector<Position>& positions);
+	// Notes a change the journal cannot replay, such as a map-wide operation
+	// that bypasses the undo queue
+	void recordUntracked();
+
+	// A save snapshot was taken; returns the id to pass to endCheckpoint
+	uint32_t beginCheckpoint();
+	// The snapshot reached the disk: drops everything recorded before it
+	void endCheckpoint(uint32_t id);
+
+private:
+	enum RecordKind : uint8_t {
+		RECORD_TILES = 1,
+		RECORD_UNTRACKED = 2,
+		RECORD_CHECKPOINT = 3,
+		RECORD_CHECKPOINT_DONE = 4,
+	};
+
+	struct Record {
+		RecordKind kind;
+		std::vector<uint8_t> payload;
+	};
+
+	bool append(RecordKind kind, const uint8_t* data, size_t size);
+	bool compact(long offset);
+
+	static uint32_t Checksum(const uint8_t* data, size_t size);
+	// Reads records up to the first torn or corrupt one
+	static bool ReadRecords(const std::string& path, std::vector<Record>& records);
+
+	FilePtr file;
+	std::string path;
+	std::string map_filename;
+	uint32_t next_checkpoint = 1;
+	// Checkpoint ids with the file offset right after their record
+	std::vector<std::pair<uint32_t, long>> checkpoints;
+};
+
+#endif
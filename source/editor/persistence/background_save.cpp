@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////
+// This file is part of Remere's Map Editor
+//////////////////////////////////////////////////////////////////////
+
+#include "app/main.h"
+#include "editor/persistence/background_save.h"
+
+#include <cstdio>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+namespace {
+	bool writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			return false;
+		}
+		out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		out.close();
+		return !out.fail();
+	}
+
+	bool fileExists(const std::string& path) {
+		std::ifstream in(path, std::ios::binary);
+		return in.good();
+	}
+}
+
+BackgroundSave::~BackgroundSave() {
+	*alive = false;
+	if (worker.joinable()) {
+		worker.join();
+	}
+}
+
+std::string BackgroundSave::wait() {
+	if (worker.joinable()) {
+		worker.join();
+	}
+	if (!pending) {
+		return std::string();
+	}
+
+	std::shared_ptr<Pending> done = std::move(pending);
+	deliver(*done);
+	return done->error;
+}
+
+void BackgroundSave::deliver(Pending& pending) {
+	if (pending.delivered) {
+		return;
+	}
+	pending.delivered = true;
+	if (pending.on_done) {
+		pending.on_done(pending.error);
+	}
+}
+
+void BackgroundSave::start(Job job, Callback on_done) {
+	wait();
+
+	pending = std::make_shared<Pending>();
+	pending->on_done = std::move(on_done);
+
+	running.store(true, std::memory_order_release);
+	worker = std::jthread([this, job = std::move(job), pending = pending, alive = alive]() mutable {
+		pending->error = run(job);
+		running.store(false, std::memory_order_release);
+
+		wxTheApp->CallAfter([pending, alive]() {
+			if (*alive) {
+				deliver(*pending);
+			}
+		});
+	});
+}
+
+std::string BackgroundSave::run(Job& job) {
+	std::string error;
+
+	// Everything goes to temporary files first; a failure here leaves the
+	// previous save as it was
+	for (File& file : job.files) {
+		if (!writeFile(file.path + ".tmp", file.data)) {
+			error = "Could not write \"" + file.path + "\".";
+			break;
+		}
+		file.data.clear();
+		file.data.shrink_to_fit();
+	}
+
+	if (error.empty()) {
+		if (!job.runfile.empty()) {
+			std::ofstream runfile(job.runfile, std::ios::trunc | std::ios::out);
+			for (const File& file : job.files) {
+				runfile << file.backup << '\n';
+			}
+		}
+
+		for (const File& file : job.files) {
+			if (!file.backup.empty() && fileExists(file.path)) {
+				std::remove(file.backup.c_str());
+				std::rename(file.path.c_str(), file.backup.c_str());
+			} else {
+				std::remove(file.path.c_str());
+			}
+			if (std::rename((file.path + ".tmp").c_str(), file.path.c_str()) != 0) {
+				error = "Could not move the new \"" + file.path + "\" into place.";
+				spdlog::error("BackgroundSave: {}", error);
+			}
+		}
+
+		// Backups are left alone when the swap went wrong
+		for (const File& file : job.files) {
+			if (!error.empty() || file.backup.empty() || !fileExists(file.backup)) {
+				continue;
+			}
+			if (file.kept_backup.empty()) {
+				std::remove(file.backup.c_str());
+			} else {
+				std::rename(file.backup.c_str(), file.kept_backup.c_str());
+			}
+		}
+	} else {
+		spdlog::error("BackgroundSave: {}", error);
+		for (const File& file : job.files) {
+			std::remove((file.path + ".tmp").c_str());
+		}
+	}
+
+	if (!job.runfile.empty()) {
+		std::remove(job.runfile.c_str());
+	}
+	return error;
+}
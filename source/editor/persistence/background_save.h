@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////
+// This file is part of Remere's Map Editor
+//////////////////////////////////////////////////////////////////////
+
+#ifndef RME_BACKGROUND_SAVE_H
+#define RME_BACKGROUND_SAVE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes map files that were already encoded on the UI thread, so editing
+// can go on while they reach the disk. Every file is first written next to
+// its target as "<path>.tmp"; only when all of them made it is the previous
+// file moved to its backup name and the new one renamed into place, so a
+// failed save leaves the old files untouched.
+// One save runs at a time per editor: starting another one waits for the
+// running one, and destroying the owner waits too but drops its completion.
+class BackgroundSave {
+public:
+	struct File {
+		std::string path;
+		// Where the previous file is moved before the new one takes its place
+		std::string backup;
+		// Where the backup ends up once the save succeeded; empty deletes it
+		std::string kept_backup;
+		std::vector<uint8_t> data;
+	};
+
+	struct Job {
+		std::vector<File> files;
+		// Lists the backups, one per line in file order, while the files are
+		// being swapped so a crash there can be recovered on the next start
+		std::string runfile;
+	};
+
+	// Called on the UI thread; error is empty on success
+	using Callback = std::function<void(const std::string& error)>;
+
+	BackgroundSave() = default;
+	~BackgroundSave();
+
+	BackgroundSave(const BackgroundSave&) = delete;
+	BackgroundSave& operator=(const BackgroundSave&) = delete;
+
+	void start(Job job, Callback on_done);
+	// Waits for the running save and runs its completion right away, unless
+	// it already ran. Returns the error of that save, empty if it succeeded or
+	// nothing was running.
+	std::string wait();
+
+	bool isRunning() const {
+		return running.load(std::memory_order_acquire);
+	}
+
+private:
+	// Shared by the worker, the completion queued on the UI thread and wait(),
+	// whichever of the last two comes first runs on_done
+	struct Pending {
+		Callback on_done;
+		std::string error;
+		bool delivered = false;
+	};
+
+	static std::string run(Job& job);
+	static void deliver(Pending& pending);
+
+	std::jthread worker;
+	std::shared_ptr<Pending> pending;
+	std::atomic<bool> running { false };
+	// Cleared on destruction so a completion still queued on the UI thread is dropped
+	std::shared_ptr<std::atomic<bool>> alive = std::make_shared<std::atomic<bool>>(true);
+};
+
+#endif
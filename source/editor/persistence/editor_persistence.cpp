@@ -18,10 +18,12 @@
 #include "ui/gui.h"
 #include "lua/lua_script_manager.h"
 
+#include <cstdio>
 #include <fstream>
 #include <ctime>
 #include <sstream>
 #include <format>
+#include <functional>
 #include <unordered_map>
 #include <spdlog/spdlog.h>
 
@@ -83,127 +85,37 @@ void EditorPersistence::saveMap(Editor& editor, FileName filename, bool showdial
 		editor.map.unnamed = false;
 	}
 
-	// File object to convert between local paths etc.
-	FileName converter;
-	converter.Assign(wxstr(savefile));
-	std::string map_path = nstr(converter.GetPath(wxPATH_GET_SEPARATOR | wxPATH_GET_VOLUME));
-
-	// Make temporary backups
-	// converter.Assign(wxstr(savefile));
-	std::string backup_otbm;
-	std::string backup_house;
-	std::string backup_spawn;
-	std::string backup_waypoint;
-
-	if (converter.FileExists()) {
-		backup_otbm = map_path + nstr(converter.GetName()) + ".otbm~";
-		std::remove(backup_otbm.c_str());
-		std::rename(savefile.c_str(), backup_otbm.c_str());
-	}
+	// One save at a time; a previous one still writing is finished first
+	editor.background_save.wait();
 
-	converter.SetFullName(wxstr(editor.map.getHouseFilename()));
-	if (converter.FileExists()) {
-		backup_house = map_path + nstr(converter.GetName()) + ".xml~";
-		std::remove(backup_house.c_str());
-		std::rename((map_path + editor.map.getHouseFilename()).c_str(), backup_house.c_str());
-	}
+	// Set up the Map paths
+	wxFileName fn = wxstr(savefile);
+	editor.map.filename = fn.GetFullPath().mb_str(wxConvUTF8);
+	editor.map.name = fn.GetFullName().mb_str(wxConvUTF8);
 
-	converter.SetFullName(wxstr(editor.map.getSpawnFilename()));
-	if (converter.FileExists()) {
-		backup_spawn = map_path + nstr(converter.GetName()) + ".xml~";
-		std::remove(backup_spawn.c_str());
-		std::rename((map_path + editor.map.getSpawnFilename()).c_str(), backup_spawn.c_str());
+	// Encode everything on this thread so the map can't change underneath;
+	// the disk writes then run in the background while editing goes on
+	if (showdialog) {
+		g_gui.CreateLoadBar("Saving OTBM map...");
 	}
 
-	converter.SetFullName(wxstr(editor.map.getWaypointFilename()));
-	if (converter.FileExists()) {
-		backup_waypoint = map_path + nstr(converter.GetName()) + ".xml~";
-		std::remove(backup_waypoint.c_str());
-		std::rename((map_path + editor.map.getWaypointFilename()).c_str(), backup_waypoint.c_str());
-	}
+	std::vector<IOMapOTBM::EncodedFile> encoded;
+	IOMapOTBM mapsaver(editor.map.getVersion());
+	bool success = mapsaver.saveMapToMemory(editor.map, fn, encoded);
 
-	// Save the map
-	{
-		std::string n = nstr(FileSystem::GetLocalDataDirectory()) + ".saving.txt";
-		std::ofstream f(n.c_str(), std::ios::trunc | std::ios::out);
-		f << backup_otbm << '\n'
-		  << backup_house << '\n'
-		  << backup_spawn << '\n'
-		  << backup_waypoint << '\n';
+	if (showdialog) {
+		g_gui.DestroyLoadBar();
 	}
 
-	{
-
-		// Set up the Map paths
-		wxFileName fn = wxstr(savefile);
-		editor.map.filename = fn.GetFullPath().mb_str(wxConvUTF8);
-		editor.map.name = fn.GetFullName().mb_str(wxConvUTF8);
-
-		if (showdialog) {
-			g_gui.CreateLoadBar("Saving OTBM map...");
-		}
-
-		// Perform the actual save
-		IOMapOTBM mapsaver(editor.map.getVersion());
-		bool success = mapsaver.saveMap(editor.map, fn);
-
-		if (showdialog) {
-			g_gui.DestroyLoadBar();
-		}
-
-		// Check for errors...
-		if (!success) {
-			// Rename the temporary backup files back to their previous names
-			if (!backup_otbm.empty()) {
-				converter.SetFullName(wxstr(savefile));
-				std::string otbm_filename = map_path + nstr(converter.GetName());
-				std::rename(backup_otbm.c_str(), std::string(otbm_filename + ".otbm").c_str());
-			}
-
-			if (!backup_house.empty()) {
-				converter.SetFullName(wxstr(editor.map.getHouseFilename()));
-				std::string house_filename = map_path + nstr(converter.GetName());
-				std::rename(backup_house.c_str(), std::string(house_filename + ".xml").c_str());
-			}
-
-			if (!backup_spawn.empty()) {
-				converter.SetFullName(wxstr(editor.map.getSpawnFilename()));
-				std::string spawn_filename = map_path + nstr(converter.GetName());
-				std::rename(backup_spawn.c_str(), std::string(spawn_filename + ".xml").c_str());
-			}
-
-			if (!backup_waypoint.empty()) {
-				converter.SetFullName(wxstr(editor.map.getWaypointFilename()));
-				std::string waypoint_filename = map_path + nstr(converter.GetName());
-				std::rename(backup_waypoint.c_str(), std::string(waypoint_filename + ".xml").c_str());
-			}
-
-			// Display the error
-			DialogUtil::PopupDialog("Error", "Could not save, unable to open target for writing.", wxOK);
-		}
-
-		// Remove temporary save runfile
-		{
-			std::string n = nstr(FileSystem::GetLocalDataDirectory()) + ".saving.txt";
-			std::remove(n.c_str());
-		}
-
-		// If failure, don't run the rest of the function
-		if (!success) {
-			return;
-		}
+	if (!success) {
+		DialogUtil::PopupDialog("Error", "Could not save, unable to encode the map.", wxOK);
+		return;
 	}
 
-	// Save camera paths to sidecar file
-	editor.map.camera_paths.saveToFile(FileName(wxstr(savefile)));
-
-	// BlackTalon: save ambient sound zone metadata to "<map>-sound.xml"
-	editor.map.sound_zones.saveToFile(FileName(wxstr(savefile)));
-	editor.map.instance_zones.saveToFile(FileName(wxstr(savefile)));
-
-	// Move to permanent backup
+	// Previous files are kept as "<name>.otbm~" / "<name>.xml~" until the new
+	// ones are in place, then either dated or deleted
+	std::string date_suffix;
 	if (!save_as && g_settings.getInteger(Config::ALWAYS_MAKE_BACKUP)) {
-		// Move temporary backups to their proper files
 		time_t t = time(nullptr);
 		tm* current_time = localtime(&t);
 		ASSERT(current_time);
@@ -220,39 +132,74 @@ void EditorPersistence::saveMap(Editor& editor, FileName filename, bool showdial
 		date << "-" << current_time->tm_hour;
 		date << "-" << current_time->tm_min;
 		date << "-" << current_time->tm_sec;
+		date_suffix = date.str();
+	}
 
-		if (!backup_otbm.empty()) {
-			converter.SetFullName(wxstr(savefile));
-			std::string otbm_filename = map_path + nstr(converter.GetName());
-			std::rename(backup_otbm.c_str(), std::string(otbm_filename + "." + date.str() + ".otbm").c_str());
-		}
+	BackgroundSave::Job job;
+	// One runfile per map, as several editors can be saving at once
+	job.runfile = nstr(FileSystem::GetLocalDataDirectory()) + std::format(".saving-{:016x}.txt", std::hash<std::string> {}(editor.map.getFilename()));
 
-		if (!backup_house.empty()) {
-			converter.SetFullName(wxstr(editor.map.getHouseFilename()));
-			std::string house_filename = map_path + nstr(converter.GetName());
-			std::rename(backup_house.c_str(), std::string(house_filename + "." + date.str() + ".xml").c_str());
-		}
+	for (size_t i = 0; i < encoded.size(); ++i) {
+		BackgroundSave::File& file = job.files.emplace_back();
+		file.path = std::move(encoded[i].path);
+		file.data = std::move(encoded[i].data);
 
-		if (!backup_spawn.empty()) {
-			converter.SetFullName(wxstr(editor.map.getSpawnFilename()));
-			std::string spawn_filename = map_path + nstr(converter.GetName());
-			std::rename(backup_spawn.c_str(), std::string(spawn_filename + "." + date.str() + ".xml").c_str());
+		FileName converter(wxstr(file.path));
+		if (!converter.FileExists()) {
+			continue;
 		}
 
-		if (!backup_waypoint.empty()) {
-			converter.SetFullName(wxstr(editor.map.getWaypointFilename()));
-			std::string waypoint_filename = map_path + nstr(converter.GetName());
-			std::rename(backup_waypoint.c_str(), std::string(waypoint_filename + "." + date.str() + ".xml").c_str());
+		// The OTBM always comes first, the rest are XML files
+		const std::string ext = i == 0 ? "otbm" : "xml";
+		const std::string base = nstr(converter.GetPath(wxPATH_GET_SEPARATOR | wxPATH_GET_VOLUME)) + nstr(converter.GetName());
+		file.backup = base + "." + ext + "~";
+		if (!date_suffix.empty()) {
+			file.kept_backup = base + "." + date_suffix + "." + ext;
 		}
+	}
+
+	// Save camera paths to sidecar file
+	editor.map.camera_paths.saveToFile(FileName(wxstr(savefile)));
+
+	// BlackTalon: save ambient sound zone metadata to "<map>-sound.xml"
+	editor.map.sound_zones.saveToFile(FileName(wxstr(savefile)));
+	editor.map.instance_zones.saveToFile(FileName(wxstr(savefile)));
+
+	// The map counts as saved once the files are on disk, and only if it was
+	// not changed while they were being written
+	const uint64_t saved_change = editor.map.getChangeCount();
+
+	// The journal follows the map to its new name; otherwise the save becomes
+	// its checkpoint once it reached the disk. The journal of the old name is
+	// kept until then too: should the write fail, the old map and its journal
+	// are still the newest state on disk.
+	uint32_t checkpoint = 0;
+	std::string previous_journal;
+	if (!g_settings.getBoolean(Config::USE_ACTION_JOURNAL)) {
+		editor.journal.discard();
+	} else if (editor.journal.getMapFilename() != editor.map.getFilename()) {
+		previous_journal = editor.journal.detach();
+		editor.journal.open(editor.map.getFilename());
 	} else {
-		// Delete the temporary files
-		std::remove(backup_otbm.c_str());
-		std::remove(backup_house.c_str());
-		std::remove(backup_spawn.c_str());
-		std::remove(backup_waypoint.c_str());
+		checkpoint = editor.journal.beginCheckpoint();
 	}
 
-	editor.map.clearChanges();
+	editor.background_save.start(std::move(job), [&editor, saved_change, checkpoint, previous_journal](const std::string& error) {
+		if (error.empty()) {
+			if (editor.map.getChangeCount() == saved_change) {
+				editor.map.clearChanges();
+				g_status.UpdateTitle();
+			}
+			editor.journal.endCheckpoint(checkpoint);
+			if (!previous_journal.empty()) {
+				std::remove(previous_journal.c_str());
+			}
+			g_status.SetStatusText("Map saved successfully.");
+			return;
+		}
+
+		DialogUtil::PopupDialog("Error", "Could not save, unable to write the map to disk.\n" + wxstr(error), wxOK);
+	});
 }
 
 void EditorPersistence::importTowns(Editor& editor, Map& imported_map, const Position& offset, ImportType house_import_type, std::unordered_map<uint32_t, uint32_t>& town_id_map) {
@@ -31,6 +31,60 @@
 #include <ranges>
 #include <algorithm>
 
+namespace {
+	// Beyond this many presorted runs a plain sort beats the merge.
+	constexpr size_t MAX_MERGED_RUNS = 64;
+
+	// Sorts tiles by position. Input made of a few ascending runs (one per
+	// SelectionThread worker once their changes are committed together) is
+	// k-way merged instead of being sorted from scratch.
+	void sortTileRuns(std::vector<Tile*>& tiles) {
+		std::vector<size_t> run_starts { 0 };
+		for (size_t i = 1; i < tiles.size(); ++i) {
+			if (tilePositionLessThan(tiles[i], tiles[i - 1])) {
+				run_starts.push_back(i);
+				if (run_starts.size() > MAX_MERGED_RUNS) {
+					std::ranges::sort(tiles, tilePositionLessThan);
+					return;
+				}
+			}
+		}
+		if (run_starts.size() == 1) {
+			return;
+		}
+
+		struct RunCursor {
+			size_t pos;
+			size_t end;
+		};
+		// Min-heap on the current tile of each run
+		auto later = [&tiles](const RunCursor& a, const RunCursor& b) {
+			return tilePositionLessThan(tiles[b.pos], tiles[a.pos]);
+		};
+
+		std::vector<RunCursor> heap;
+		heap.reserve(run_starts.size());
+		for (size_t r = 0; r < run_starts.size(); ++r) {
+			heap.push_back({ run_starts[r], r + 1 < run_starts.size() ? run_starts[r + 1] : tiles.size() });
+		}
+		std::ranges::make_heap(heap, later);
+
+		std::vector<Tile*> merged;
+		merged.reserve(tiles.size());
+		while (!heap.empty()) {
+			std::ranges::pop_heap(heap, later);
+			RunCursor& cursor = heap.back();
+			merged.push_back(tiles[cursor.pos]);
+			if (++cursor.pos < cursor.end) {
+				std::ranges::push_heap(heap, later);
+			} else {
+				heap.pop_back();
+			}
+		}
+		tiles = std::move(merged);
+	}
+}
+
 Selection::Selection(Editor& editor) :
 	busy(false),
 	deferred(false),
@@ -97,7 +151,7 @@ void Selection::add(Tile* tile, Item* item) {
 	if (subsession) {
 		// Make a copy of the tile with the item selected
 		item->select();
-		std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
+		std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, tile->getLocation(), editor.map);
 		item->deselect();
 
 		if (g_settings.getInteger(Config::BORDER_IS_GROUND)) {
@@ -130,7 +184,7 @@ void Selection::add(Tile* tile, Spawn* spawn) {
 	if (subsession) {
 		// Make a copy of the tile with the item selected
 		spawn->select();
-		std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
+		std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, tile->getLocation(), editor.map);
 		spawn->deselect();
 
 		subsession->addChange(std::make_unique<Change>(std::move(new_tile)));
@@ -152,7 +206,7 @@ void Selection::add(Tile* tile, Creature* creature) {
 	if (subsession) {
 		// Make a copy of the tile with the item selected
 		creature->select();
-		std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
+		std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, tile->getLocation(), editor.map);
 		creature->deselect();
 
 		subsession->addChange(std::make_unique<Change>(std::move(new_tile)));
@@ -167,7 +221,9 @@ void Selection::add(Tile* tile) {
 	ASSERT(tile);
 
 	if (subsession) {
-		std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, editor.map);
+		// Copy into the tile's own location: SelectionThread workers call this
+		// concurrently and must not go through the map's tile lookup.
+		std::unique_ptr<Tile> new_tile = TileOperations::deepCopy(tile, tile->getLocation(), editor.map);
 		TileOperations::select(new_tile.get());
 
 		subsession->addChange(std::make_unique<Change>(std::move(new_tile)));
@@ -314,7 +370,7 @@ void Selection::flush() {
 	}
 
 	if (!pending_adds.empty()) {
-		std::ranges::sort(pending_adds, tilePositionLessThan);
+		sortTileRuns(pending_adds);
 		auto [first, last] = std::ranges::unique(pending_adds, [](Tile* a, Tile* b) {
 			return a->getPosition() == b->getPosition();
 		});
@@ -439,6 +495,11 @@ void Selection::join(std::unique_ptr<SelectionThread> thread) {
 	thread->Wait();
 
 	ASSERT(session);
-	session->addAction(std::move(thread->result));
+	ASSERT(subsession);
+	// Fold the worker's changes into our own action so the whole selection
+	// commits at once and flush() sees one sorted run per worker.
+	if (thread->result) {
+		subsession->appendChanges(*thread->result);
+	}
 	thread->selection.subsession = nullptr;
 }
@@ -26,6 +26,9 @@
 #include "app/settings.h"
 #include "editor/action.h"
 
+#include <algorithm>
+#include <array>
+
 SelectionThread::SelectionThread(Editor& editor, Position start, Position end, bool creatures_only) :
 	editor(editor),
 	start(start),
@@ -52,33 +55,69 @@ void SelectionThread::Wait() {
 
 void SelectionThread::Work() {
 	selection.start(Selection::SUBTHREAD);
+
+	const bool show_spawns = g_settings.getInteger(Config::SHOW_SPAWNS);
+	const bool show_creatures = g_settings.getInteger(Config::SHOW_CREATURES);
+
+	// Compensated selection shifts the area one tile down-right for every
+	// floor passed at or above ground level.
+	std::array<int, MAP_LAYERS> offsets {};
+	int shift = 0;
 	for (int z = start.z; z >= end.z; --z) {
-		for (int x = start.x; x <= end.x; ++x) {
-			for (int y = start.y; y <= end.y; ++y) {
-				Tile* tile = editor.map.getTile(x, y, z);
-				if (!tile) {
+		offsets[z] = shift;
+		if (z <= GROUND_LAYER && g_settings.getInteger(Config::COMPENSATED_SELECT)) {
+			++shift;
+		}
+	}
+
+	// Walk the grid nodes directly rather than calling map.getTile per
+	// position: the grid's lookup cache must not be shared between workers.
+	std::vector<Tile*> found;
+	editor.map.visitLeaves(start.x, start.y, end.x + shift + 1, end.y + shift + 1, [&](MapNode* node, int node_x, int node_y) {
+		for (int z = start.z; z >= end.z; --z) {
+			Floor* floor = node->getFloor(z);
+			if (!floor) {
+				continue;
+			}
+
+			const int min_x = start.x + offsets[z];
+			const int min_y = start.y + offsets[z];
+			const int max_x = end.x + offsets[z];
+			const int max_y = end.y + offsets[z];
+			for (int lx = 0; lx < 4; ++lx) {
+				const int x = node_x + lx;
+				if (x < min_x || x > max_x) {
 					continue;
 				}
-
-				if (creatures_only) {
-					if (tile->spawn && g_settings.getInteger(Config::SHOW_SPAWNS) && (!tile->creature || !g_settings.getInteger(Config::SHOW_CREATURES))) {
-						selection.add(tile, tile->spawn.get());
+				for (int ly = 0; ly < 4; ++ly) {
+					const int y = node_y + ly;
+					if (y < min_y || y > max_y) {
+						continue;
 					}
-					if (tile->creature && g_settings.getInteger(Config::SHOW_CREATURES)) {
-						selection.add(tile, tile->creature.get());
+					if (Tile* tile = floor->locs[lx * 4 + ly].get()) {
+						found.push_back(tile);
 					}
-				} else {
-					selection.add(tile);
 				}
 			}
 		}
-		if (z <= GROUND_LAYER && g_settings.getInteger(Config::COMPENSATED_SELECT)) {
-			++start.x;
-			++start.y;
-			++end.x;
-			++end.y;
+	});
+
+	// Emit the changes in position order; Selection merges the sorted runs of
+	// all workers instead of sorting the whole selection again.
+	std::ranges::sort(found, tilePositionLessThan);
+	for (Tile* tile : found) {
+		if (creatures_only) {
+			if (tile->spawn && show_spawns && (!tile->creature || !show_creatures)) {
+				selection.add(tile, tile->spawn.get());
+			}
+			if (tile->creature && show_creatures) {
+				selection.add(tile, tile->creature.get());
+			}
+		} else {
+			selection.add(tile);
 		}
 	}
+
 	// Access wrapper to get subsession
 	// Since SelectionThread is friend of Selection, we can access private members of selection instance
 	result = std::move(selection.subsession);
@@ -26,6 +26,9 @@
 class Editor;
 class Action;
 
+// Selects the tiles of one band of a rectangular selection on a worker thread.
+// The band should cover whole SpatialHashGrid cells so workers don't overlap;
+// the resulting changes are sorted by position and merged by Selection::join.
 class SelectionThread {
 public:
 	SelectionThread(Editor& editor, Position start, Position end, bool creatures_only = false);
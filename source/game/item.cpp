@@ -95,9 +95,7 @@ std::unique_ptr<Item> Item::deepCopy() const {
 		if (invalidOtbmData) {
 			copy->invalidOtbmData = std::make_unique<InvalidOTBMItemData>(*invalidOtbmData);
 		}
-		if (attributes) {
-			copy->attributes = newd ItemAttributeMap(*attributes);
-		}
+		copy->attributes = attributes;
 	}
 	return copy;
 }
@@ -22,32 +22,30 @@
 #include <cstring>
 #include <spdlog/spdlog.h>
 
-ItemAttributes::ItemAttributes() :
-	attributes(nullptr) {
+ItemAttributes::ItemAttributes() {
 	////
 }
 
-ItemAttributes::ItemAttributes(const ItemAttributes& o) {
-	if (o.attributes) {
-		attributes = newd ItemAttributeMap(*o.attributes);
-	}
+ItemAttributes::ItemAttributes(const ItemAttributes& o) :
+	attributes(o.attributes) {
+	////
 }
 
 ItemAttributes::~ItemAttributes() {
-	clearAllAttributes();
+	////
 }
 
-void ItemAttributes::createAttributes() {
+ItemAttributeMap& ItemAttributes::writableAttributes() {
 	if (!attributes) {
-		attributes = newd ItemAttributeMap;
+		attributes = std::make_shared<ItemAttributeMap>();
+	} else if (attributes.use_count() > 1) {
+		attributes = std::make_shared<ItemAttributeMap>(*attributes);
 	}
+	return *attributes;
 }
 
 void ItemAttributes::clearAllAttributes() {
-	if (attributes) {
-		delete attributes;
-	}
-	attributes = nullptr;
+	attributes.reset();
 }
 
 ItemAttributeMap ItemAttributes::getAttributes() const {
@@ -58,28 +56,23 @@ ItemAttributeMap ItemAttributes::getAttributes() const {
 }
 
 void ItemAttributes::setAttribute(const std::string& key, const ItemAttribute& value) {
-	createAttributes();
-	(*attributes)[key] = value;
+	writableAttributes()[key] = value;
 }
 
 void ItemAttributes::setAttribute(const std::string& key, const std::string& value) {
-	createAttributes();
-	(*attributes)[key].set(value);
+	writableAttributes()[key].set(value);
 }
 
 void ItemAttributes::setAttribute(const std::string& key, int32_t value) {
-	createAttributes();
-	(*attributes)[key].set(value);
+	writableAttributes()[key].set(value);
 }
 
 void ItemAttributes::setAttribute(const std::string& key, double value) {
-	createAttributes();
-	(*attributes)[key].set(value);
+	writableAttributes()[key].set(value);
 }
 
 void ItemAttributes::setAttribute(const std::string& key, bool value) {
-	createAttributes();
-	(*attributes)[key].set(value);
+	writableAttributes()[key].set(value);
 }
 
 void ItemAttributes::eraseAttribute(const std::string& key) {
@@ -87,10 +80,8 @@ void ItemAttributes::eraseAttribute(const std::string& key) {
 		return;
 	}
 
-	ItemAttributeMap::iterator iter = attributes->find(key);
-
-	if (iter != attributes->end()) {
-		attributes->erase(iter);
+	if (attributes->find(key) != attributes->end()) {
+		writableAttributes().erase(key);
 	}
 }
 
@@ -244,7 +235,7 @@ bool ItemAttributes::unserializeAttributeMap(const IOMap& maphandle, BinaryNode*
 	uint16_t n;
 	if (stream->getU16(n)) {
 		spdlog::debug("unserializeAttributeMap: reading {} attributes", n);
-		createAttributes();
+		ItemAttributeMap& map = writableAttributes();
 
 		std::string key;
 		ItemAttribute attrib;
@@ -258,7 +249,7 @@ bool ItemAttributes::unserializeAttributeMap(const IOMap& maphandle, BinaryNode*
 				spdlog::warn("unserializeAttributeMap: failed to unserialize value for key='{}' (remaining={})", key, n + 1);
 				return false;
 			}
-			(*attributes)[key] = attrib;
+			map[key] = attrib;
 		}
 	}
 	return true;
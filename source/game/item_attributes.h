@@ -20,6 +20,7 @@
 
 #include <string>
 #include <map>
+#include <memory>
 
 #include "io/filehandle.h"
 
@@ -112,9 +113,12 @@ public:
 	ItemAttributeMap getAttributes() const;
 
 protected:
-	ItemAttributeMap* attributes;
+	// Copies of an item share one map until either of them writes to it, so
+	// copying, pasting and undo snapshots don't duplicate attribute storage
+	std::shared_ptr<ItemAttributeMap> attributes;
 
-	void createAttributes();
+	// Returns a map only this item refers to, creating or unsharing it first
+	ItemAttributeMap& writableAttributes();
 };
 
 #endif
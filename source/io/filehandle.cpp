@@ -620,7 +620,14 @@ void MemoryNodeFileWriteHandle::reset() {
 }
 
 void MemoryNodeFileWriteHandle::close() {
-	cache.clear();
+	std::vector<uint8_t>().swap(cache);
+	local_write_index = 0;
+}
+
+std::vector<uint8_t> MemoryNodeFileWriteHandle::release() {
+	cache.resize(local_write_index);
+	local_write_index = 0;
+	return std::move(cache);
 }
 
 uint8_t* MemoryNodeFileWriteHandle::getMemory() {
@@ -720,3 +727,19 @@ bool NodeFileWriteHandle::addRAW(const uint8_t* ptr, size_t sz) {
 	writeBytes(ptr, sz);
 	return error_code == FILE_NO_ERROR;
 }
+
+bool NodeFileWriteHandle::addEncoded(const uint8_t* ptr, size_t sz) {
+	while (sz > 0) {
+		const size_t count = std::min(sz, cache.size() - local_write_index);
+		std::copy_n(ptr, count, cache.data() + local_write_index);
+		local_write_index += count;
+		ptr += count;
+		sz -= count;
+		if (local_write_index >= cache.size()) {
+			if (!renewCache()) {
+				break;
+			}
+		}
+	}
+	return error_code == FILE_NO_ERROR;
+}
@@ -430,6 +430,9 @@ public:
 	bool addRAW(const char* c) {
 		return addRAW(reinterpret_cast<const uint8_t*>(c), strlen(c));
 	}
+	// Appends bytes that are already node-encoded (e.g. the output of another
+	// MemoryNodeFileWriteHandle) verbatim, without escaping
+	bool addEncoded(const uint8_t* ptr, size_t sz);
 
 	template <typename T>
 		requires std::is_trivially_copyable_v<T>
@@ -494,6 +497,8 @@ public:
 	// WARNING: This pointer may become invalid if the buffer is resized (e.g. by renewCache()).
 	uint8_t* getMemory();
 	size_t getSize();
+	// Hands over the written bytes without copying them; the handle is empty afterwards
+	std::vector<uint8_t> release();
 
 protected:
 	bool renewCache() override;
@@ -23,6 +23,7 @@
 
 #include <format>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <filesystem>
 #include <string_view>
@@ -461,6 +462,57 @@ bool IOMapOTBM::saveMap(Map& map, const FileName& identifier) {
 	return saveMapToDisk(map, identifier);
 }
 
+bool IOMapOTBM::saveMapToMemory(Map& map, const FileName& identifier, std::vector<EncodedFile>& files) {
+	// The magic goes in first, so the buffer can be handed over as the file
+	MemoryNodeFileWriteHandle f;
+	const std::string magic = g_settings.getInteger(Config::SAVE_WITH_OTB_MAGIC_NUMBER) ? "OTBM" : std::string(4, '\0');
+	f.addEncoded(reinterpret_cast<const uint8_t*>(magic.data()), magic.size());
+	if (!saveMap(map, f)) {
+		return false;
+	}
+
+	EncodedFile& otbm = files.emplace_back();
+	otbm.path = nstr(identifier.GetFullPath());
+	otbm.data = f.release();
+
+	auto encodeXML = [&](const std::string& filename, bool (*build)(const Map&, pugi::xml_document&)) {
+		pugi::xml_document doc;
+		if (!build(map, doc)) {
+			return false;
+		}
+		std::ostringstream stream;
+		doc.save(stream, "\t", pugi::format_default, pugi::encoding_utf8);
+		const std::string text = stream.str();
+
+		EncodedFile& file = files.emplace_back();
+		file.path = MapXMLIO::normalizeMapFilePaths(identifier, filename).second;
+		file.data.assign(text.begin(), text.end());
+		return true;
+	};
+
+	if (!encodeXML(map.housefile, &MapXMLIO::saveHouses)) {
+		spdlog::error("IOMapOTBM::saveMapToMemory: Failed to save houses");
+		return false;
+	}
+
+	if (!encodeXML(map.spawnfile, &MapXMLIO::saveSpawns)) {
+		spdlog::error("Failed to save spawns!");
+		return false;
+	}
+
+	// Same waypoint file rules as saveMapToDisk
+	if (map.waypoints.size() > 0 && map.waypointfile.empty()) {
+		map.waypointfile = identifier.GetName() + "-waypoint.xml";
+		spdlog::info("Auto-created waypoint file: {}", map.waypointfile);
+	}
+	if (!map.waypointfile.empty() && !encodeXML(map.waypointfile, &MapXMLIO::saveWaypoints)) {
+		spdlog::error("IOMapOTBM::saveMapToMemory: Failed to save waypoints");
+		return false;
+	}
+
+	return true;
+}
+
 bool IOMapOTBM::saveMap(Map& map, NodeFileWriteHandle& f) {
 	const MapVersion mapVersion = map.getVersion();
 
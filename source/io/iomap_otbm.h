@@ -99,11 +99,20 @@ public:
 
 	using WriteResult = OTBMWriteResult;
 
+	// One file of a map save, already encoded
+	struct EncodedFile {
+		std::string path;
+		std::vector<uint8_t> data;
+	};
+
 	static bool getVersionInfo(const FileName& identifier, MapVersion& out_ver);
 	static bool peekStartupInfo(const FileName& identifier, OTBMStartupPeekResult& out_info);
 
 	bool loadMap(Map& map, const FileName& identifier) override;
 	bool saveMap(Map& map, const FileName& identifier) override;
+	// Encodes everything saveMap(map, identifier) would write without touching
+	// the disk: the OTBM first, then the house, spawn and waypoint files.
+	bool saveMapToMemory(Map& map, const FileName& identifier, std::vector<EncodedFile>& files);
 
 protected:
 	static bool getVersionInfo(NodeFileReadHandle* f, MapVersion& out_ver);
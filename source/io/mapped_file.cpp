@@ -0,0 +1,120 @@
+#include "io/mapped_file.h"
+
+#include <format>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <cerrno>
+	#include <cstring>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filename, std::string& error) {
+	close();
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		error = std::format("Failed to open {} (error {})", filename, GetLastError());
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		error = std::format("Failed to map {}: empty or unreadable file", filename);
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		error = std::format("Failed to map {} (error {})", filename, GetLastError());
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view) {
+		error = std::format("Failed to map {} (error {})", filename, GetLastError());
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	file_handle_ = file;
+	mapping_handle_ = mapping;
+	data_ = static_cast<const uint8_t*>(view);
+	size_ = static_cast<size_t>(file_size.QuadPart);
+	return true;
+}
+
+void MappedFile::close() {
+	if (data_) {
+		UnmapViewOfFile(data_);
+	}
+	if (mapping_handle_) {
+		CloseHandle(static_cast<HANDLE>(mapping_handle_));
+	}
+	if (file_handle_) {
+		CloseHandle(static_cast<HANDLE>(file_handle_));
+	}
+	data_ = nullptr;
+	size_ = 0;
+	mapping_handle_ = nullptr;
+	file_handle_ = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filename, std::string& error) {
+	close();
+
+	const int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		error = std::format("Failed to open {}: {}", filename, std::strerror(errno));
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		error = std::format("Failed to map {}: empty or unreadable file", filename);
+		::close(fd);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file.
+	::close(fd);
+	if (view == MAP_FAILED) {
+		error = std::format("Failed to map {}: {}", filename, std::strerror(errno));
+		return false;
+	}
+	// Sprites are fetched in no particular order as the view scrolls.
+	madvise(view, static_cast<size_t>(st.st_size), MADV_RANDOM);
+
+	data_ = static_cast<const uint8_t*>(view);
+	size_ = static_cast<size_t>(st.st_size);
+	return true;
+}
+
+void MappedFile::close() {
+	if (data_) {
+		munmap(const_cast<uint8_t*>(data_), size_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef RME_IO_MAPPED_FILE_H_
+#define RME_IO_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Read-only view of a whole file mapped into memory. The mapping stays valid
+// until the object is destroyed; reads through data() need no locking.
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps the file, replacing any previous mapping. On failure returns false
+	// and fills error.
+	[[nodiscard]] bool open(const std::string& filename, std::string& error);
+	void close();
+
+	[[nodiscard]] bool isOpen() const {
+		return data_ != nullptr;
+	}
+	[[nodiscard]] std::span<const uint8_t> data() const {
+		return { data_, size_ };
+	}
+	[[nodiscard]] size_t size() const {
+		return size_;
+	}
+
+private:
+	const uint8_t* data_ = nullptr;
+	size_t size_ = 0;
+#ifdef _WIN32
+	void* file_handle_ = nullptr;
+	void* mapping_handle_ = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,640 @@
+//////////////////////////////////////////////////////////////////////
+// This file is part of Remere's Map Editor
+//////////////////////////////////////////////////////////////////////
+// Remere's Map Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Remere's Map Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////
+
+#include "io/otbm/map_diff_otbm.h"
+
+#include "io/filehandle.h"
+#include "io/otbm/invalid_otbm_content.h"
+#include "io/otbm/otbm_types.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <future>
+#include <iostream>
+#include <optional>
+#include <unordered_map>
+
+namespace {
+	constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+	void hashBytes(uint64_t& hash, const char* data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= static_cast<uint8_t>(data[i]);
+			hash *= FNV_PRIME;
+		}
+	}
+
+	void hashNode(uint64_t& hash, BinaryNode* node) {
+		const std::string_view data = node->rawData();
+		hashBytes(hash, data.data(), data.size());
+		for (BinaryNode* child : node->children()) {
+			hash ^= NODE_START;
+			hash *= FNV_PRIME;
+			hashNode(hash, child);
+			hash ^= NODE_END;
+			hash *= FNV_PRIME;
+		}
+	}
+
+	// Hash of the tile node and everything in it. The offset bytes are left
+	// out: the position is the key, and they depend on the tile area the tile
+	// was written in.
+	uint64_t hashTile(BinaryNode* tileNode) {
+		const std::string_view data = tileNode->rawData();
+		uint64_t hash = FNV_OFFSET_BASIS;
+		hashBytes(hash, data.data(), 1);
+		if (data.size() > 3) {
+			hashBytes(hash, data.data() + 3, data.size() - 3);
+		}
+		for (BinaryNode* child : tileNode->children()) {
+			hash ^= NODE_START;
+			hash *= FNV_PRIME;
+			hashNode(hash, child);
+			hash ^= NODE_END;
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+	// Opens a node and writes its properties; data starts with the node type
+	void writeNodeHeader(NodeFileWriteHandle& f, std::string_view data) {
+		f.addNode(static_cast<uint8_t>(data.front()));
+		if (data.size() > 1) {
+			f.addRAW(reinterpret_cast<const uint8_t*>(data.data()) + 1, data.size() - 1);
+		}
+	}
+
+	void copyNode(NodeFileWriteHandle& f, BinaryNode* node) {
+		const std::string_view data = node->rawData();
+		if (data.empty()) {
+			return;
+		}
+		writeNodeHeader(f, data);
+		for (BinaryNode* child : node->children()) {
+			copyNode(f, child);
+		}
+		f.endNode();
+	}
+
+	PreservedOTBMNode captureNode(BinaryNode* node) {
+		PreservedOTBMNode captured;
+		const std::string_view data = node->rawData();
+		captured.rawPayload.assign(data.begin(), data.end());
+		for (BinaryNode* child : node->children()) {
+			captured.children.push_back(captureNode(child));
+		}
+		return captured;
+	}
+
+	void writeCapturedNode(NodeFileWriteHandle& f, const PreservedOTBMNode& node) {
+		if (node.rawPayload.empty()) {
+			return;
+		}
+		f.addNode(node.rawPayload.front());
+		if (node.rawPayload.size() > 1) {
+			f.addRAW(node.rawPayload.data() + 1, node.rawPayload.size() - 1);
+		}
+		for (const auto& child : node.children) {
+			writeCapturedNode(f, child);
+		}
+		f.endNode();
+	}
+
+	// Tile offsets are relative to the tile area they are written in, which
+	// need not be the area they were read from
+	void writeCapturedTile(NodeFileWriteHandle& f, PreservedOTBMNode& tile, uint8_t x_offset, uint8_t y_offset) {
+		if (tile.rawPayload.size() >= 3) {
+			tile.rawPayload[1] = x_offset;
+			tile.rawPayload[2] = y_offset;
+		}
+		writeCapturedNode(f, tile);
+	}
+
+	void addTileArea(NodeFileWriteHandle& f, const Position& pos) {
+		f.addNode(OTBM_TILE_AREA);
+		f.addU16(pos.x & 0xFF00);
+		f.addU16(pos.y & 0xFF00);
+		f.addU8(pos.z);
+	}
+
+	// Copies a tile into the tile area opened by addTileArea for its position
+	void copyTile(NodeFileWriteHandle& f, BinaryNode* tileNode, const Position& pos) {
+		const std::string_view data = tileNode->rawData();
+		f.addNode(static_cast<uint8_t>(data.front()));
+		f.addU8(pos.x & 0xFF);
+		f.addU8(pos.y & 0xFF);
+		if (data.size() > 3) {
+			f.addRAW(reinterpret_cast<const uint8_t*>(data.data()) + 3, data.size() - 3);
+		}
+		for (BinaryNode* child : tileNode->children()) {
+			copyNode(f, child);
+		}
+		f.endNode();
+	}
+
+	// Tiles sharing this key go in the same tile area
+	uint64_t areaKey(uint64_t key) {
+		return key & 0xFFFFFF00FF00ULL;
+	}
+
+	bool isTileNode(uint8_t type) {
+		return type == OTBM_TILE || type == OTBM_HOUSETILE;
+	}
+
+	bool openMap(DiskNodeFileReadHandle& f, const std::string& path, BinaryNode*& root, std::string& error) {
+		if (!f.isOk()) {
+			error = std::format("Could not open \"{}\": {}", path, f.getErrorMessage());
+			return false;
+		}
+		root = f.getRootNode();
+		if (!root || root->rawData().empty()) {
+			error = std::format("\"{}\" is not an OTBM map.", path);
+			return false;
+		}
+		return true;
+	}
+
+	// The root node attributes: OTBM version, map size and items version
+	bool readRootHeader(const std::string& path, std::string& header, std::string& error) {
+		DiskNodeFileReadHandle f(path, std::vector<std::string>(1, "OTBM"));
+		BinaryNode* root = nullptr;
+		if (!openMap(f, path, root, error)) {
+			return false;
+		}
+		header = root->rawData();
+		return true;
+	}
+
+	bool checkRead(DiskNodeFileReadHandle& f, const std::string& path, std::string& error) {
+		if (!f.isOk()) {
+			error = std::format("Could not read \"{}\": {}", path, f.getErrorMessage());
+			return false;
+		}
+		return true;
+	}
+
+	// Calls onTile(tileNode, position) for every tile of the map, in file
+	// order. The type and offset bytes of the tile are already read.
+	template <typename F>
+	bool forEachTile(const std::string& path, std::string& error, F&& onTile) {
+		DiskNodeFileReadHandle f(path, std::vector<std::string>(1, "OTBM"));
+		BinaryNode* root = nullptr;
+		if (!openMap(f, path, root, error)) {
+			return false;
+		}
+
+		for (BinaryNode* mapNode : root->children()) {
+			uint8_t type;
+			if (!mapNode->getByte(type) || type != OTBM_MAP_DATA) {
+				continue;
+			}
+
+			for (BinaryNode* areaNode : mapNode->children()) {
+				uint16_t base_x, base_y;
+				uint8_t base_z;
+				if (!areaNode->getByte(type) || type != OTBM_TILE_AREA) {
+					continue;
+				}
+				if (!areaNode->getU16(base_x) || !areaNode->getU16(base_y) || !areaNode->getU8(base_z)) {
+					continue;
+				}
+
+				for (BinaryNode* tileNode : areaNode->children()) {
+					uint8_t x_offset, y_offset;
+					if (!tileNode->getByte(type) || !isTileNode(type)) {
+						continue;
+					}
+					if (!tileNode->getU8(x_offset) || !tileNode->getU8(y_offset)) {
+						continue;
+					}
+					onTile(tileNode, Position(base_x + x_offset, base_y + y_offset, base_z));
+				}
+			}
+		}
+		return checkRead(f, path, error);
+	}
+
+	// Writes to path + ".tmp" and moves it over path once complete, so an
+	// output that is also one of the inputs is only replaced at the end
+	bool finishOutput(DiskNodeFileWriteHandle& f, const std::string& path, std::string& error) {
+		const bool ok = f.isOk();
+		f.close();
+		const std::string tmp = path + ".tmp";
+		std::error_code ec;
+		if (!ok) {
+			error = std::format("Could not write \"{}\".", path);
+			std::filesystem::remove(tmp, ec);
+			return false;
+		}
+		std::filesystem::rename(tmp, path, ec);
+		if (ec) {
+			error = std::format("Could not move the new \"{}\" into place: {}", path, ec.message());
+			return false;
+		}
+		return true;
+	}
+
+	void discardOutput(DiskNodeFileWriteHandle& f, const std::string& path) {
+		f.close();
+		std::error_code ec;
+		std::filesystem::remove(path + ".tmp", ec);
+	}
+
+	void printPositions(std::ostream& out, char mark, const std::vector<Position>& positions) {
+		for (const Position& pos : positions) {
+			out << std::format("{} {},{},{}\n", mark, pos.x, pos.y, pos.z);
+		}
+	}
+
+	int printUsage() {
+		std::cerr << "Usage:\n"
+				  << "  rme --diff <from.otbm> <to.otbm> [-o <diff.otbm>]\n"
+				  << "  rme --merge <base.otbm> <ours.otbm> <theirs.otbm> -o <merged.otbm> [--prefer ours|theirs]\n"
+				  << "Exit code 0: no differences or conflicts, 1: some found, 2: error.\n";
+		return 2;
+	}
+}
+
+bool MapDiffOTBM::BuildIndex(const std::string& path, Index& index, std::string& error) {
+	index.tiles.clear();
+	const bool ok = forEachTile(path, error, [&](BinaryNode* tileNode, const Position& pos) {
+		index.tiles.push_back({ PackPosition(pos.x, pos.y, pos.z), hashTile(tileNode) });
+	});
+	if (!ok) {
+		return false;
+	}
+
+	// Stable, so that of duplicate tiles the first in the file is kept
+	std::stable_sort(index.tiles.begin(), index.tiles.end(), [](const TileEntry& a, const TileEntry& b) {
+		return a.key < b.key;
+	});
+	const auto last = std::unique(index.tiles.begin(), index.tiles.end(), [](const TileEntry& a, const TileEntry& b) {
+		return a.key == b.key;
+	});
+	index.tiles.erase(last, index.tiles.end());
+	index.tiles.shrink_to_fit();
+	return true;
+}
+
+MapDiffOTBM::Diff MapDiffOTBM::Compare(const Index& from, const Index& to) {
+	Diff diff;
+	auto a = from.tiles.begin();
+	auto b = to.tiles.begin();
+	while (a != from.tiles.end() || b != to.tiles.end()) {
+		if (b == to.tiles.end() || (a != from.tiles.end() && a->key < b->key)) {
+			diff.removed.push_back(UnpackPosition(a->key));
+			++a;
+		} else if (a == from.tiles.end() || b->key < a->key) {
+			diff.added.push_back(UnpackPosition(b->key));
+			++b;
+		} else {
+			if (a->hash != b->hash) {
+				diff.changed.push_back(UnpackPosition(a->key));
+			}
+			++a;
+			++b;
+		}
+	}
+	return diff;
+}
+
+bool MapDiffOTBM::WriteDiff(const std::string& to_path, const Diff& diff, const std::string& out_path, std::string& error) {
+	std::vector<uint64_t> wanted;
+	wanted.reserve(diff.added.size() + diff.changed.size());
+	for (const auto* positions : { &diff.added, &diff.changed }) {
+		for (const Position& pos : *positions) {
+			wanted.push_back(PackPosition(pos.x, pos.y, pos.z));
+		}
+	}
+	std::sort(wanted.begin(), wanted.end());
+	// Of duplicate tiles only the first is part of the map
+	std::vector<bool> written(wanted.size(), false);
+
+	// The root is copied from the target map so the diff has its version and size
+	DiskNodeFileReadHandle header(to_path, std::vector<std::string>(1, "OTBM"));
+	BinaryNode* root = nullptr;
+	if (!openMap(header, to_path, root, error)) {
+		return false;
+	}
+
+	DiskNodeFileWriteHandle f(out_path + ".tmp", "OTBM");
+	if (!f.isOk()) {
+		error = std::format("Could not open \"{}\" for writing.", out_path);
+		return false;
+	}
+	writeNodeHeader(f, root->rawData());
+
+	f.addNode(OTBM_MAP_DATA);
+	f.addU8(OTBM_ATTR_DESCRIPTION);
+	f.addString(std::format("Diff: {} added, {} changed, {} removed tiles", diff.added.size(), diff.changed.size(), diff.removed.size()));
+
+	// Tile areas are opened only once they hold a wanted tile
+	std::optional<uint64_t> openArea;
+	const bool ok = forEachTile(to_path, error, [&](BinaryNode* tileNode, const Position& pos) {
+		const uint64_t key = PackPosition(pos.x, pos.y, pos.z);
+		const auto it = std::lower_bound(wanted.begin(), wanted.end(), key);
+		if (it == wanted.end() || *it != key || written[it - wanted.begin()]) {
+			return;
+		}
+		written[it - wanted.begin()] = true;
+
+		if (openArea != areaKey(key)) {
+			if (openArea) {
+				f.endNode();
+			}
+			addTileArea(f, pos);
+			openArea = areaKey(key);
+		}
+		copyTile(f, tileNode, pos);
+	});
+	if (openArea) {
+		f.endNode();
+	}
+	if (!ok) {
+		discardOutput(f, out_path);
+		return false;
+	}
+
+	if (!diff.removed.empty()) {
+		f.addNode(OTBM_DIFF_REMOVED);
+		for (const Position& pos : diff.removed) {
+			f.addU16(pos.x);
+			f.addU16(pos.y);
+			f.addU8(pos.z);
+		}
+		f.endNode();
+	}
+
+	f.endNode(); // OTBM_MAP_DATA
+	f.endNode(); // root
+	return finishOutput(f, out_path, error);
+}
+
+bool MapDiffOTBM::Merge(const std::string& base_path, const std::string& ours_path, const std::string& theirs_path, const std::string& out_path, Prefer prefer, MergeResult& result, std::string& error) {
+	result = MergeResult();
+
+	// Tiles are compared by their encoding, which only means the same across
+	// files of one OTBM and items version; the output takes the root of ours
+	std::string base_header, ours_header, theirs_header;
+	if (!readRootHeader(base_path, base_header, error) || !readRootHeader(ours_path, ours_header, error) || !readRootHeader(theirs_path, theirs_header, error)) {
+		return false;
+	}
+	if (ours_header != base_header || theirs_header != base_header) {
+		error = "The maps differ in OTBM version, map size or items version; convert them to the same version before merging.";
+		return false;
+	}
+
+	// The three files are independent, so they are indexed side by side
+	Index base, ours, theirs;
+	std::string base_error, ours_error, theirs_error;
+	auto base_task = std::async(std::launch::async, [&]() { return BuildIndex(base_path, base, base_error); });
+	auto ours_task = std::async(std::launch::async, [&]() { return BuildIndex(ours_path, ours, ours_error); });
+	const bool theirs_ok = BuildIndex(theirs_path, theirs, theirs_error);
+	const bool base_ok = base_task.get();
+	const bool ours_ok = ours_task.get();
+	if (!base_ok || !ours_ok || !theirs_ok) {
+		error = !base_ok ? base_error : (!ours_ok ? ours_error : theirs_error);
+		return false;
+	}
+
+	// Positions where the result is whatever theirs has there, tile or none
+	std::vector<uint64_t> take_theirs;
+	{
+		auto b = base.tiles.begin();
+		auto o = ours.tiles.begin();
+		auto t = theirs.tiles.begin();
+		while (b != base.tiles.end() || o != ours.tiles.end() || t != theirs.tiles.end()) {
+			uint64_t key = UINT64_MAX;
+			if (b != base.tiles.end()) {
+				key = std::min(key, b->key);
+			}
+			if (o != ours.tiles.end()) {
+				key = std::min(key, o->key);
+			}
+			if (t != theirs.tiles.end()) {
+				key = std::min(key, t->key);
+			}
+
+			std::optional<uint64_t> base_hash, ours_hash, theirs_hash;
+			if (b != base.tiles.end() && b->key == key) {
+				base_hash = (b++)->hash;
+			}
+			if (o != ours.tiles.end() && o->key == key) {
+				ours_hash = (o++)->hash;
+			}
+			if (t != theirs.tiles.end() && t->key == key) {
+				theirs_hash = (t++)->hash;
+			}
+
+			if (ours_hash == theirs_hash || theirs_hash == base_hash) {
+				continue;
+			}
+			if (ours_hash == base_hash) {
+				take_theirs.push_back(key);
+				++result.from_theirs;
+				continue;
+			}
+			result.conflicts.push_back(UnpackPosition(key));
+			if (prefer == Prefer::Theirs) {
+				take_theirs.push_back(key);
+			}
+		}
+	}
+	base.tiles = {};
+	ours.tiles = {};
+	theirs.tiles = {};
+
+	// Only the tiles taken from theirs are kept in memory
+	std::unordered_map<uint64_t, PreservedOTBMNode> theirs_tiles;
+	if (!take_theirs.empty()) {
+		const bool ok = forEachTile(theirs_path, error, [&](BinaryNode* tileNode, const Position& pos) {
+			const uint64_t key = PackPosition(pos.x, pos.y, pos.z);
+			if (std::binary_search(take_theirs.begin(), take_theirs.end(), key) && !theirs_tiles.contains(key)) {
+				theirs_tiles.emplace(key, captureNode(tileNode));
+			}
+		});
+		if (!ok) {
+			return false;
+		}
+	}
+
+	// Ours is copied node by node, swapping in theirs where it wins
+	DiskNodeFileReadHandle in(ours_path, std::vector<std::string>(1, "OTBM"));
+	BinaryNode* root = nullptr;
+	if (!openMap(in, ours_path, root, error)) {
+		return false;
+	}
+
+	DiskNodeFileWriteHandle f(out_path + ".tmp", "OTBM");
+	if (!f.isOk()) {
+		error = std::format("Could not open \"{}\" for writing.", out_path);
+		return false;
+	}
+	writeNodeHeader(f, root->rawData());
+
+	for (BinaryNode* mapNode : root->children()) {
+		uint8_t type;
+		if (!mapNode->getByte(type) || type != OTBM_MAP_DATA) {
+			copyNode(f, mapNode);
+			continue;
+		}
+
+		writeNodeHeader(f, mapNode->rawData());
+
+		for (BinaryNode* areaNode : mapNode->children()) {
+			uint16_t base_x, base_y;
+			uint8_t base_z;
+			if (!areaNode->getByte(type) || type != OTBM_TILE_AREA || !areaNode->getU16(base_x) || !areaNode->getU16(base_y) || !areaNode->getU8(base_z)) {
+				copyNode(f, areaNode);
+				continue;
+			}
+
+			writeNodeHeader(f, areaNode->rawData());
+
+			for (BinaryNode* tileNode : areaNode->children()) {
+				uint8_t x_offset, y_offset;
+				if (!tileNode->getByte(type) || !isTileNode(type) || !tileNode->getU8(x_offset) || !tileNode->getU8(y_offset)) {
+					copyNode(f, tileNode);
+					continue;
+				}
+
+				const Position pos(base_x + x_offset, base_y + y_offset, base_z);
+				const uint64_t key = PackPosition(pos.x, pos.y, pos.z);
+				if (!std::binary_search(take_theirs.begin(), take_theirs.end(), key)) {
+					copyNode(f, tileNode);
+					continue;
+				}
+
+				// Theirs wins: write its tile once here, or nothing if it removed it
+				auto it = theirs_tiles.find(key);
+				if (it != theirs_tiles.end()) {
+					writeCapturedTile(f, it->second, x_offset, y_offset);
+					theirs_tiles.erase(it);
+				}
+			}
+			f.endNode();
+		}
+
+		// What is left are tiles only theirs has, written in new tile areas
+		std::vector<uint64_t> added;
+		added.reserve(theirs_tiles.size());
+		for (const auto& [key, tile] : theirs_tiles) {
+			added.push_back(key);
+		}
+		std::sort(added.begin(), added.end(), [](uint64_t a, uint64_t b) {
+			return areaKey(a) != areaKey(b) ? areaKey(a) < areaKey(b) : a < b;
+		});
+
+		for (size_t i = 0; i < added.size(); ++i) {
+			const Position pos = UnpackPosition(added[i]);
+			if (i == 0 || areaKey(added[i]) != areaKey(added[i - 1])) {
+				if (i != 0) {
+					f.endNode();
+				}
+				addTileArea(f, pos);
+			}
+			writeCapturedTile(f, theirs_tiles[added[i]], pos.x & 0xFF, pos.y & 0xFF);
+		}
+		if (!added.empty()) {
+			f.endNode();
+		}
+		theirs_tiles.clear();
+
+		f.endNode(); // OTBM_MAP_DATA
+	}
+	f.endNode(); // root
+
+	if (!checkRead(in, ours_path, error)) {
+		discardOutput(f, out_path);
+		return false;
+	}
+	return finishOutput(f, out_path, error);
+}
+
+int MapDiffOTBM::RunCommandLine(int argc, char** argv) {
+	if (argc < 2) {
+		return -1;
+	}
+	const std::string_view command = argv[1];
+	if (command != "--diff" && command != "--merge") {
+		return -1;
+	}
+
+	std::vector<std::string> files;
+	std::string out_path;
+	Prefer prefer = Prefer::Ours;
+	for (int i = 2; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		if (arg == "-o" && i + 1 < argc) {
+			out_path = argv[++i];
+		} else if (arg == "--prefer" && i + 1 < argc) {
+			const std::string_view side = argv[++i];
+			if (side == "theirs") {
+				prefer = Prefer::Theirs;
+			} else if (side != "ours") {
+				return printUsage();
+			}
+		} else if (!arg.empty() && arg.front() == '-') {
+			return printUsage();
+		} else {
+			files.emplace_back(arg);
+		}
+	}
+
+	std::string error;
+	if (command == "--diff") {
+		if (files.size() != 2) {
+			return printUsage();
+		}
+
+		Index from, to;
+		std::string from_error;
+		auto from_task = std::async(std::launch::async, [&]() { return BuildIndex(files[0], from, from_error); });
+		const bool to_ok = BuildIndex(files[1], to, error);
+		if (!from_task.get() || !to_ok) {
+			std::cerr << (error.empty() ? from_error : error) << '\n';
+			return 2;
+		}
+
+		const Diff diff = Compare(from, to);
+		if (out_path.empty()) {
+			printPositions(std::cout, '+', diff.added);
+			printPositions(std::cout, '-', diff.removed);
+			printPositions(std::cout, '~', diff.changed);
+		} else if (!WriteDiff(files[1], diff, out_path, error)) {
+			std::cerr << error << '\n';
+			return 2;
+		}
+		std::cout << std::format("{} added, {} removed, {} changed tiles\n", diff.added.size(), diff.removed.size(), diff.changed.size());
+		return diff.empty() ? 0 : 1;
+	}
+
+	if (files.size() != 3 || out_path.empty()) {
+		return printUsage();
+	}
+
+	MergeResult result;
+	if (!Merge(files[0], files[1], files[2], out_path, prefer, result, error)) {
+		std::cerr << error << '\n';
+		return 2;
+	}
+	printPositions(std::cout, '!', result.conflicts);
+	std::cout << std::format("{} tiles taken from {}, {} conflicts resolved as {}\n", result.from_theirs, files[2], result.conflicts.size(), prefer == Prefer::Theirs ? "theirs" : "ours");
+	return result.conflicts.empty() ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////
+// This file is part of Remere's Map Editor
+//////////////////////////////////////////////////////////////////////
+// Remere's Map Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Remere's Map Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef RME_MAP_DIFF_OTBM_H_
+#define RME_MAP_DIFF_OTBM_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "map/position.h"
+
+// Compares and merges OTBM files without loading them into a Map.
+//
+// Every file is streamed once to build a compact index of its tiles: the
+// position and a 64-bit hash of the encoded tile node, items included, sorted
+// by position. Diffs and merges are worked out on these indexes and a second
+// pass copies only the tile nodes that are needed, so memory stays at a few
+// bytes per tile whatever the size of the maps.
+//
+// Tiles are compared by their encoding, which needs no item definitions, but
+// also means a tile written differently by another tool counts as changed.
+// Only tiles are diffed and merged; towns, waypoints and the house and spawn
+// files are taken from "ours".
+class MapDiffOTBM {
+public:
+	struct TileEntry {
+		uint64_t key;
+		uint64_t hash;
+	};
+
+	// Tiles sorted by position. As when loading, the first of several tiles
+	// at the same position is the one kept.
+	struct Index {
+		std::vector<TileEntry> tiles;
+	};
+
+	struct Diff {
+		std::vector<Position> added;
+		std::vector<Position> removed;
+		std::vector<Position> changed;
+
+		bool empty() const {
+			return added.empty() && removed.empty() && changed.empty();
+		}
+	};
+
+	enum class Prefer {
+		Ours,
+		Theirs,
+	};
+
+	struct MergeResult {
+		// Tiles added, changed or removed in theirs only
+		size_t from_theirs = 0;
+		// Tiles both sides changed differently; resolved by Prefer
+		std::vector<Position> conflicts;
+	};
+
+	static bool BuildIndex(const std::string& path, Index& index, std::string& error);
+	static Diff Compare(const Index& from, const Index& to);
+
+	// Writes the added and changed tiles of to_path together with the removed
+	// positions as an OTBM file. Removals go in a node the map loader skips,
+	// so the diff can also be opened or imported as a map.
+	static bool WriteDiff(const std::string& to_path, const Diff& diff, const std::string& out_path, std::string& error);
+
+	// Three-way merge of ours and theirs against their common base, written to
+	// out_path. Tiles only one side changed are taken from that side. Fails if
+	// the root nodes (OTBM version, map size, items version) are not the same.
+	static bool Merge(const std::string& base_path, const std::string& ours_path, const std::string& theirs_path, const std::string& out_path, Prefer prefer, MergeResult& result, std::string& error);
+
+	// Runs "--diff" and "--merge" command lines without starting the editor.
+	// Returns the exit code, or -1 if argv is not one of them.
+	static int RunCommandLine(int argc, char** argv);
+
+private:
+	// Node holding the removed positions of a diff, as x (u16), y (u16), z (u8)
+	static constexpr uint8_t OTBM_DIFF_REMOVED = 0x80;
+
+	static uint64_t PackPosition(int x, int y, int z) {
+		return (static_cast<uint64_t>(z) << 32) | (static_cast<uint64_t>(x) << 16) | static_cast<uint64_t>(y);
+	}
+	static Position UnpackPosition(uint64_t key) {
+		return Position(static_cast<int>((key >> 16) & 0xFFFF), static_cast<int>(key & 0xFFFF), static_cast<int>(key >> 32));
+	}
+};
+
+#endif
@@ -5,11 +5,14 @@
 #include "map/tile.h"
 #include "game/item.h"
 #include "game/house.h"
+#include "io/filehandle.h"
 #include "io/otbm/item_serialization_otbm.h"
 #include "item_definitions/core/item_definition_store.h"
 #include "ui/gui.h"
+#include "util/parallel.h"
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace {
@@ -261,17 +264,13 @@ void TileSerializationOTBM::readTileArea(IOMapOTBM& iomap, Map& map, BinaryNode*
 	}
 }
 
-void TileSerializationOTBM::writeTileData(const IOMapOTBM& iomap, const Map& map, NodeFileWriteHandle& f, const std::function<void(int)>& progressCb) {
+uint32_t TileSerializationOTBM::writeCellRange(const IOMapOTBM& iomap, const std::vector<SpatialHashGrid::SortedGridCell>& sorted_cells, size_t begin, size_t end, NodeFileWriteHandle& f, const std::function<void(uint32_t)>& tilesCb) {
 	uint32_t tiles_saved = 0;
 	bool first = true;
 	int local_x = -1, local_y = -1, local_z = -1;
 
-	const uint64_t total_tiles = map.getTileCount();
-
-	// Use modern ranges for iteration if possible, but the spatial hash grid iterator is already custom
-	auto sorted_cells = map.getGrid().getSortedCells();
-	for (const auto& sorted_cell : sorted_cells) {
-		SpatialHashGrid::GridCell* cell = sorted_cell.cell;
+	for (size_t c = begin; c < end; ++c) {
+		SpatialHashGrid::GridCell* cell = sorted_cells[c].cell;
 		if (!cell) {
 			continue;
 		}
@@ -295,8 +294,8 @@ void TileSerializationOTBM::writeTileData(const IOMapOTBM& iomap, const Map& map
 					}
 
 					++tiles_saved;
-					if (tiles_saved % 8192 == 0 && total_tiles > 0 && progressCb) {
-						progressCb(std::min(100, static_cast<int>(100.0 * tiles_saved / total_tiles)));
+					if (tiles_saved % 8192 == 0 && tilesCb) {
+						tilesCb(tiles_saved);
 					}
 
 					const Position& pos = save_tile->getPosition();
@@ -323,6 +322,47 @@ void TileSerializationOTBM::writeTileData(const IOMapOTBM& iomap, const Map& map
 	if (!first) {
 		f.endNode();
 	}
+	return tiles_saved;
+}
+
+void TileSerializationOTBM::writeTileData(const IOMapOTBM& iomap, const Map& map, NodeFileWriteHandle& f, const std::function<void(int)>& progressCb) {
+	const uint64_t total_tiles = map.getTileCount();
+	auto sorted_cells = map.getGrid().getSortedCells();
+
+	auto reportProgress = [&](uint64_t tiles_saved) {
+		if (progressCb && total_tiles > 0) {
+			progressCb(std::min(100, static_cast<int>(100.0 * tiles_saved / total_tiles)));
+		}
+	};
+
+	// A small map is written straight to f
+	if (sorted_cells.size() < 64) {
+		writeCellRange(iomap, sorted_cells, 0, sorted_cells.size(), f, reportProgress);
+		return;
+	}
+
+	// Each worker encodes a contiguous run of cells into its own buffer; the
+	// buffers are then appended in cell order. A run starts a fresh tile area
+	// node, so the file may hold a few more area nodes than a serial save,
+	// which readers accept just the same.
+	struct Chunk {
+		std::unique_ptr<MemoryNodeFileWriteHandle> handle;
+		uint32_t tiles;
+	};
+	auto chunks = parallelFor(0, sorted_cells.size(), 32, [&iomap, &sorted_cells](size_t start, size_t end) {
+		Chunk chunk { std::make_unique<MemoryNodeFileWriteHandle>(), 0 };
+		chunk.tiles = writeCellRange(iomap, sorted_cells, start, end, *chunk.handle, nullptr);
+		return chunk;
+	});
+
+	uint64_t tiles_saved = 0;
+	for (Chunk& chunk : chunks) {
+		tiles_saved += chunk.tiles;
+		f.addEncoded(chunk.handle->getMemory(), chunk.handle->getSize());
+		// Freed right away so at most one chunk is held twice
+		chunk.handle.reset();
+		reportProgress(tiles_saved);
+	}
 }
 
 void TileSerializationOTBM::serializeTile(const IOMapOTBM& iomap, const Tile* save_tile, NodeFileWriteHandle& f) {
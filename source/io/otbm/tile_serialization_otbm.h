@@ -18,7 +18,11 @@
 #ifndef RME_TILE_SERIALIZATION_OTBM_H_
 #define RME_TILE_SERIALIZATION_OTBM_H_
 
+#include <cstdint>
 #include <functional>
+#include <vector>
+
+#include "map/spatial_hash_grid.h"
 
 class Map;
 class BinaryNode;
@@ -31,6 +35,12 @@ public:
 	static void readTileArea(IOMapOTBM& iomap, Map& map, BinaryNode* mapNode);
 	static void writeTileData(const IOMapOTBM& iomap, const Map& map, NodeFileWriteHandle& f, const std::function<void(int)>& progressCb = nullptr);
 	static void serializeTile(const IOMapOTBM& iomap, const Tile* tile, NodeFileWriteHandle& f);
+
+private:
+	// Writes the tiles of sorted_cells[begin, end) grouped into tile area
+	// nodes. tilesCb is called every 8192 tiles with the count so far.
+	// Returns the number of tiles written.
+	static uint32_t writeCellRange(const IOMapOTBM& iomap, const std::vector<SpatialHashGrid::SortedGridCell>& sorted_cells, size_t begin, size_t end, NodeFileWriteHandle& f, const std::function<void(uint32_t)>& tilesCb);
 };
 
 #endif
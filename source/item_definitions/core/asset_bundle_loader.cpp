@@ -1,11 +1,15 @@
 #include "item_definitions/core/asset_bundle_loader.h"
 
+#include "item_definitions/core/asset_bundle_snapshot.h"
 #include "item_definitions/core/item_definitions_loader.h"
 #include "item_definitions/core/item_definition_store_builder.h"
 #include "item_definitions/formats/dat/dat_item_parser.h"
 #include "rendering/core/graphics_assembler.h"
 #include "rendering/core/sprite_archive.h"
 
+#include <future>
+#include <iterator>
+
 namespace {
 	ItemDefinitionLoadInput toDefinitionInput(const AssetLoadRequest& request, const DatCatalog& dat_catalog) {
 		return ItemDefinitionLoadInput {
@@ -23,7 +27,11 @@ namespace {
 bool AssetBundleLoader::load(const AssetLoadRequest& request, AssetBundle& bundle, wxString& error, std::vector<std::string>& warnings) const {
 	bundle = {};
 
-	DatItemParser dat_parser;
+	if (AssetBundleSnapshot::read(request, bundle, warnings)) {
+		bundle.sprite_archive = SpriteArchive::load(request.spr_path, bundle.dat_catalog.is_extended, error, warnings);
+		return bundle.sprite_archive != nullptr;
+	}
+
 	const auto definition_input = ItemDefinitionLoadInput {
 		.mode = request.mode,
 		.dat_path = request.dat_path,
@@ -33,20 +41,59 @@ bool AssetBundleLoader::load(const AssetLoadRequest& request, AssetBundle& bundl
 		.graphics = nullptr,
 		.dat_catalog = nullptr,
 	};
-	if (!dat_parser.parseCatalog(definition_input, bundle.dat_catalog, error, warnings)) {
+
+	// OTB, items.xml and the sprite archive don't depend on the DAT catalog, so
+	// they are read on worker threads while this thread parses the DAT. Errors
+	// are still reported in the order the files used to be loaded.
+	ItemDefinitionsLoader definitions_loader;
+	PendingItemDefinitionSources pending_sources = definitions_loader.startFileSources(definition_input);
+
+	struct SpriteLoadResult {
+		std::shared_ptr<SpriteArchive> archive;
+		wxString error;
+		std::vector<std::string> warnings;
+	};
+	std::future<SpriteLoadResult> sprite_task;
+	if (request.client_version != nullptr) {
+		sprite_task = std::async(std::launch::async, [spr_path = request.spr_path, extended = request.client_version->isExtended()]() {
+			SpriteLoadResult result;
+			result.archive = SpriteArchive::load(spr_path, extended, result.error, result.warnings);
+			return result;
+		});
+	}
+
+	// Definition warnings are kept apart from the sprite ones so the snapshot
+	// only replays what the definition parsers reported.
+	std::vector<std::string> definition_warnings;
+	SpriteLoadResult sprites;
+	auto reportWarnings = [&warnings, &definition_warnings, &sprites]() {
+		for (auto* source : { &definition_warnings, &sprites.warnings }) {
+			warnings.insert(warnings.end(), std::make_move_iterator(source->begin()), std::make_move_iterator(source->end()));
+		}
+	};
+
+	DatItemParser dat_parser;
+	if (!dat_parser.parseCatalog(definition_input, bundle.dat_catalog, error, definition_warnings)) {
+		reportWarnings();
 		return false;
 	}
 
-	bundle.sprite_archive = SpriteArchive::load(request.spr_path, bundle.dat_catalog.is_extended, error, warnings);
+	// parseCatalog takes is_extended from the client version, as the task did.
+	sprites = sprite_task.get();
+	bundle.sprite_archive = std::move(sprites.archive);
 	if (!bundle.sprite_archive) {
+		error = sprites.error;
+		reportWarnings();
 		return false;
 	}
 
-	ItemDefinitionsLoader definitions_loader;
-	if (!definitions_loader.assemble(toDefinitionInput(request, bundle.dat_catalog), bundle.fragments, bundle.rows, error, warnings)) {
+	if (!definitions_loader.assemble(toDefinitionInput(request, bundle.dat_catalog), pending_sources, bundle.fragments, bundle.rows, error, definition_warnings)) {
+		reportWarnings();
 		return false;
 	}
 
+	AssetBundleSnapshot::write(request, bundle, definition_warnings);
+	reportWarnings();
 	return true;
 }
 
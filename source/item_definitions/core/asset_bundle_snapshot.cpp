@@ -0,0 +1,520 @@
+#include "app/main.h"
+#include "item_definitions/core/asset_bundle_snapshot.h"
+
+#include "app/client_version.h"
+#include "io/mapped_file.h"
+#include "util/file_system.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <spdlog/spdlog.h>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+	constexpr char kSnapshotMagic[4] = { 'R', 'D', 'E', 'F' };
+	// Bump whenever DatCatalog, ResolvedItemDefinitionRow or the layout below
+	// change; the layout checks next to the transfer functions enforce it.
+	constexpr uint32_t kSnapshotVersion = 1;
+
+	constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ull;
+	constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+	uint64_t fnv1a(std::span<const uint8_t> bytes, uint64_t hash = kFnvOffset) {
+		for (uint8_t byte : bytes) {
+			hash = (hash ^ byte) * kFnvPrime;
+		}
+		return hash;
+	}
+
+	uint64_t fnv1a(std::string_view text, uint64_t hash = kFnvOffset) {
+		return fnv1a(std::span(reinterpret_cast<const uint8_t*>(text.data()), text.size()), hash);
+	}
+
+	// Size, modification time and content hash of one input file. Missing or
+	// unused inputs are all zero.
+	struct InputStamp {
+		uint64_t size = 0;
+		int64_t mtime = 0;
+		uint64_t hash = 0;
+	};
+
+	constexpr size_t kInputCount = 3; // dat, otb, xml
+
+	struct SnapshotHeader {
+		char magic[4];
+		uint32_t version;
+		uint64_t key;
+		std::array<InputStamp, kInputCount> inputs;
+	};
+
+	std::array<std::string, kInputCount> inputPaths(const AssetLoadRequest& request) {
+		return {
+			request.dat_path.GetFullPath().ToStdString(),
+			request.otb_path.GetFullPath().ToStdString(),
+			request.xml_path.GetFullPath().ToStdString(),
+		};
+	}
+
+	bool statInput(const std::string& path, InputStamp& stamp) {
+		stamp = {};
+		std::error_code ec;
+		if (path.empty() || !std::filesystem::is_regular_file(path, ec)) {
+			return true;
+		}
+		stamp.size = std::filesystem::file_size(path, ec);
+		if (ec) {
+			return false;
+		}
+		const auto mtime = std::filesystem::last_write_time(path, ec);
+		if (ec) {
+			return false;
+		}
+		stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+		return true;
+	}
+
+	bool hashInput(const std::string& path, InputStamp& stamp) {
+		if (stamp.size == 0) {
+			return true;
+		}
+		MappedFile file;
+		std::string error;
+		if (!file.open(path, error)) {
+			spdlog::warn("Definition snapshot: {}", error);
+			return false;
+		}
+		stamp.hash = fnv1a(file.data());
+		return true;
+	}
+
+	// Everything besides the file contents that changes what the parsers produce.
+	uint64_t requestKey(const AssetLoadRequest& request) {
+		const ClientVersion* version = request.client_version;
+		std::string key = std::format("{}|{}|{}|{}|{}|{}|{}|{}", static_cast<int>(request.mode), version->getName(), version->getOtbMajor(), version->getOtbId(), version->isExtended(), version->isTransparent(), version->hasFrameDurations(), version->hasFrameGroups());
+		for (const std::string& path : inputPaths(request)) {
+			key += '|';
+			key += path;
+		}
+		return fnv1a(key);
+	}
+
+	std::string snapshotPath(uint64_t key) {
+		FileName dir = FileSystem::GetLocalDirectory();
+		dir.AppendDir("definition_cache");
+		dir.Mkdir(0755, wxPATH_MKDIR_FULL);
+		dir.SetFullName(wxString::FromUTF8(std::format("{:016x}.bin", key)));
+		return dir.GetFullPath().ToStdString();
+	}
+
+	class SnapshotWriter {
+	public:
+		static constexpr bool reading = false;
+
+		template <typename T>
+		void value(const T& value) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+			buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+		}
+
+		void string(const std::string& text) {
+			value(static_cast<uint32_t>(text.size()));
+			buffer.insert(buffer.end(), text.begin(), text.end());
+		}
+
+		template <typename T>
+		void vector(const std::vector<T>& items) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			value(static_cast<uint32_t>(items.size()));
+			const auto* bytes = reinterpret_cast<const uint8_t*>(items.data());
+			buffer.insert(buffer.end(), bytes, bytes + items.size() * sizeof(T));
+		}
+
+		std::vector<uint8_t> buffer;
+	};
+
+	// Bounds-checked reader over the mapped snapshot; once a read runs past the
+	// end every further read fails and ok turns false.
+	class SnapshotReader {
+	public:
+		static constexpr bool reading = true;
+
+		explicit SnapshotReader(std::span<const uint8_t> bytes) :
+			bytes(bytes) { }
+
+		template <typename T>
+		void value(T& value) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			if (take(sizeof(T))) {
+				std::memcpy(&value, bytes.data() + offset - sizeof(T), sizeof(T));
+			}
+		}
+
+		void string(std::string& text) {
+			uint32_t size = 0;
+			value(size);
+			if (take(size)) {
+				text.assign(reinterpret_cast<const char*>(bytes.data() + offset - size), size);
+			}
+		}
+
+		template <typename T>
+		void vector(std::vector<T>& items) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			uint32_t count = 0;
+			value(count);
+			const size_t size = static_cast<size_t>(count) * sizeof(T);
+			if (take(size)) {
+				items.resize(count);
+				std::memcpy(items.data(), bytes.data() + offset - size, size);
+			}
+		}
+
+		[[nodiscard]] size_t remaining() const {
+			return ok ? bytes.size() - offset : 0;
+		}
+
+		bool ok = true;
+
+	private:
+		bool take(size_t size) {
+			if (!ok || bytes.size() - offset < size) {
+				ok = false;
+				return false;
+			}
+			offset += size;
+			return true;
+		}
+
+		std::span<const uint8_t> bytes;
+		size_t offset = 0;
+	};
+
+	// The structs below are stored field by field, or as raw bytes for the
+	// trivially copyable ones. Each is checked against a copy of its layout at
+	// the time of kSnapshotVersion, so adding, removing or retyping a member
+	// breaks the build until the transfer code and the version are updated.
+	struct DatItemFragmentLayout {
+		ClientItemId client_id;
+		ItemGroup_t group;
+		ItemTypes_t type;
+		uint64_t flags;
+		uint16_t way_speed;
+		int always_on_top_order;
+	};
+	static_assert(sizeof(DatItemFragment) == sizeof(DatItemFragmentLayout), "DatItemFragment changed: bump kSnapshotVersion");
+	static_assert(sizeof(SpriteLight) == 2, "SpriteLight changed: bump kSnapshotVersion");
+	static_assert(sizeof(DatAnimationFrameDuration) == 8, "DatAnimationFrameDuration changed: bump kSnapshotVersion");
+	static_assert(sizeof(ItemDefinitionVersionInfo) == 12, "ItemDefinitionVersionInfo changed: bump kSnapshotVersion");
+
+	struct DatAnimationInfoLayout {
+		bool asynchronous;
+		int loop_count;
+		int8_t start_frame;
+		std::vector<DatAnimationFrameDuration> frame_durations;
+	};
+	static_assert(sizeof(DatAnimationInfo) == sizeof(DatAnimationInfoLayout), "DatAnimationInfo changed: update transferEntry and bump kSnapshotVersion");
+
+	struct DatCatalogEntryLayout {
+		uint32_t client_id;
+		DatItemFragment item_fragment;
+		uint8_t height;
+		uint8_t width;
+		uint8_t layers;
+		uint8_t pattern_x;
+		uint8_t pattern_y;
+		uint8_t pattern_z;
+		uint8_t frames;
+		uint32_t numsprites;
+		uint16_t draw_height;
+		int16_t drawoffset_x;
+		int16_t drawoffset_y;
+		uint16_t minimap_color;
+		bool has_light;
+		SpriteLight light;
+		std::vector<uint32_t> sprite_ids;
+		std::optional<DatAnimationInfo> animation;
+	};
+	static_assert(sizeof(DatCatalogEntry) == sizeof(DatCatalogEntryLayout), "DatCatalogEntry changed: update transferEntry and bump kSnapshotVersion");
+
+	// Walks the bundle fields in one fixed order for both directions. Entry and
+	// row types are const when writing.
+	template <typename Stream, typename Entry>
+	void transferEntry(Stream& stream, Entry& entry) {
+		stream.value(entry.client_id);
+		stream.value(entry.item_fragment);
+		stream.value(entry.height);
+		stream.value(entry.width);
+		stream.value(entry.layers);
+		stream.value(entry.pattern_x);
+		stream.value(entry.pattern_y);
+		stream.value(entry.pattern_z);
+		stream.value(entry.frames);
+		stream.value(entry.numsprites);
+		stream.value(entry.draw_height);
+		stream.value(entry.drawoffset_x);
+		stream.value(entry.drawoffset_y);
+		stream.value(entry.minimap_color);
+		stream.value(entry.has_light);
+		stream.value(entry.light);
+		stream.vector(entry.sprite_ids);
+
+		bool has_animation = entry.animation.has_value();
+		stream.value(has_animation);
+		if (!has_animation) {
+			return;
+		}
+		if constexpr (Stream::reading) {
+			entry.animation.emplace();
+		}
+		stream.value(entry.animation->asynchronous);
+		stream.value(entry.animation->loop_count);
+		stream.value(entry.animation->start_frame);
+		stream.vector(entry.animation->frame_durations);
+	}
+
+	struct ResolvedItemDefinitionRowLayout {
+		ServerItemId server_id;
+		ClientItemId client_id;
+		ItemGroup_t group;
+		ItemTypes_t type;
+		uint64_t flags;
+		uint16_t volume;
+		uint16_t max_text_len;
+		uint16_t slot_position;
+		uint8_t weapon_type;
+		uint8_t classification;
+		uint16_t border_base_ground_id;
+		uint32_t border_group;
+		float weight;
+		int attack;
+		int defense;
+		int armor;
+		uint32_t charges;
+		uint16_t rotate_to;
+		uint16_t way_speed;
+		int always_on_top_order;
+		BorderType border_alignment;
+		std::string name;
+		std::string editor_suffix;
+		std::string description;
+	};
+	static_assert(sizeof(ResolvedItemDefinitionRow) == sizeof(ResolvedItemDefinitionRowLayout), "ResolvedItemDefinitionRow changed: update transferRow and bump kSnapshotVersion");
+
+	template <typename Stream, typename Row>
+	void transferRow(Stream& stream, Row& row) {
+		stream.value(row.server_id);
+		stream.value(row.client_id);
+		stream.value(row.group);
+		stream.value(row.type);
+		stream.value(row.flags);
+		stream.value(row.volume);
+		stream.value(row.max_text_len);
+		stream.value(row.slot_position);
+		stream.value(row.weapon_type);
+		stream.value(row.classification);
+		stream.value(row.border_base_ground_id);
+		stream.value(row.border_group);
+		stream.value(row.weight);
+		stream.value(row.attack);
+		stream.value(row.defense);
+		stream.value(row.armor);
+		stream.value(row.charges);
+		stream.value(row.rotate_to);
+		stream.value(row.way_speed);
+		stream.value(row.always_on_top_order);
+		stream.value(row.border_alignment);
+		stream.string(row.name);
+		stream.string(row.editor_suffix);
+		stream.string(row.description);
+	}
+
+	struct DatCatalogLayout {
+		uint32_t signature;
+		DatFormat format;
+		bool is_extended;
+		bool has_transparency;
+		bool has_frame_durations;
+		bool has_frame_groups;
+		uint16_t item_count;
+		uint16_t creature_count;
+		uint16_t effect_count;
+		uint16_t distance_count;
+		uint32_t max_sprite_id;
+		std::vector<DatCatalogEntry> entries;
+	};
+	static_assert(sizeof(DatCatalog) == sizeof(DatCatalogLayout), "DatCatalog changed: update transferCatalogHeader and bump kSnapshotVersion");
+
+	template <typename Stream, typename Catalog>
+	void transferCatalogHeader(Stream& stream, Catalog& catalog) {
+		stream.value(catalog.signature);
+		stream.value(catalog.format);
+		stream.value(catalog.is_extended);
+		stream.value(catalog.has_transparency);
+		stream.value(catalog.has_frame_durations);
+		stream.value(catalog.has_frame_groups);
+		stream.value(catalog.item_count);
+		stream.value(catalog.creature_count);
+		stream.value(catalog.effect_count);
+		stream.value(catalog.distance_count);
+		stream.value(catalog.max_sprite_id);
+	}
+}
+
+bool AssetBundleSnapshot::read(const AssetLoadRequest& request, AssetBundle& bundle, std::vector<std::string>& warnings) {
+	if (request.client_version == nullptr) {
+		return false;
+	}
+
+	const uint64_t key = requestKey(request);
+	const std::string path = snapshotPath(key);
+	std::error_code ec;
+	if (!std::filesystem::exists(path, ec)) {
+		return false;
+	}
+
+	MappedFile file;
+	std::string error;
+	if (!file.open(path, error)) {
+		spdlog::warn("Definition snapshot: {}", error);
+		return false;
+	}
+
+	SnapshotHeader header;
+	const std::span<const uint8_t> bytes = file.data();
+	if (bytes.size() < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 || header.version != kSnapshotVersion || header.key != key) {
+		return false;
+	}
+
+	// Size and time decide quickly; a file that was only touched is hashed and
+	// still accepted when the bytes are the same.
+	const auto paths = inputPaths(request);
+	for (size_t i = 0; i < kInputCount; ++i) {
+		InputStamp current;
+		if (!statInput(paths[i], current) || current.size != header.inputs[i].size) {
+			return false;
+		}
+		if (current.mtime != header.inputs[i].mtime) {
+			if (!hashInput(paths[i], current) || current.hash != header.inputs[i].hash) {
+				return false;
+			}
+		}
+	}
+
+	SnapshotReader reader(bytes.subspan(sizeof(header)));
+	AssetBundle loaded;
+	transferCatalogHeader(reader, loaded.dat_catalog);
+
+	uint32_t entry_count = 0;
+	reader.value(entry_count);
+	// Every entry takes well over one byte; reject counts the file can't hold.
+	if (entry_count > reader.remaining()) {
+		return false;
+	}
+	loaded.dat_catalog.entries.resize(entry_count);
+	for (DatCatalogEntry& entry : loaded.dat_catalog.entries) {
+		transferEntry(reader, entry);
+	}
+
+	reader.value(loaded.fragments.version);
+
+	uint32_t row_count = 0;
+	reader.value(row_count);
+	if (row_count > reader.remaining()) {
+		return false;
+	}
+	loaded.rows.resize(row_count);
+	for (ResolvedItemDefinitionRow& row : loaded.rows) {
+		transferRow(reader, row);
+	}
+
+	uint32_t warning_count = 0;
+	reader.value(warning_count);
+	if (warning_count > reader.remaining()) {
+		return false;
+	}
+	std::vector<std::string> stored_warnings(warning_count);
+	for (std::string& warning : stored_warnings) {
+		reader.string(warning);
+	}
+
+	if (!reader.ok || reader.remaining() != 0) {
+		spdlog::info("Definition snapshot: ignoring damaged {}", path);
+		return false;
+	}
+
+	bundle = std::move(loaded);
+	warnings.insert(warnings.end(), std::make_move_iterator(stored_warnings.begin()), std::make_move_iterator(stored_warnings.end()));
+	spdlog::info("Definition snapshot: loaded {} items from {}", bundle.rows.size(), path);
+	return true;
+}
+
+void AssetBundleSnapshot::write(const AssetLoadRequest& request, const AssetBundle& bundle, const std::vector<std::string>& warnings) {
+	if (request.client_version == nullptr) {
+		return;
+	}
+
+	SnapshotHeader header {};
+	std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+	header.version = kSnapshotVersion;
+	header.key = requestKey(request);
+
+	const auto paths = inputPaths(request);
+	for (size_t i = 0; i < kInputCount; ++i) {
+		if (!statInput(paths[i], header.inputs[i]) || !hashInput(paths[i], header.inputs[i])) {
+			return;
+		}
+	}
+
+	SnapshotWriter writer;
+	writer.value(header);
+	transferCatalogHeader(writer, bundle.dat_catalog);
+	writer.value(static_cast<uint32_t>(bundle.dat_catalog.entries.size()));
+	for (const DatCatalogEntry& entry : bundle.dat_catalog.entries) {
+		transferEntry(writer, entry);
+	}
+	writer.value(bundle.fragments.version);
+	writer.value(static_cast<uint32_t>(bundle.rows.size()));
+	for (const ResolvedItemDefinitionRow& row : bundle.rows) {
+		transferRow(writer, row);
+	}
+	writer.value(static_cast<uint32_t>(warnings.size()));
+	for (const std::string& warning : warnings) {
+		writer.string(warning);
+	}
+
+	const std::string path = snapshotPath(header.key);
+	const std::string temp_path = path + ".tmp";
+	{
+		std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(writer.buffer.data()), static_cast<std::streamsize>(writer.buffer.size()));
+		if (!out) {
+			spdlog::warn("Definition snapshot: cannot write {}", temp_path);
+			out.close();
+			std::error_code ec;
+			std::filesystem::remove(temp_path, ec);
+			return;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temp_path, path, ec);
+	if (ec) {
+		spdlog::warn("Definition snapshot: cannot replace {}: {}", path, ec.message());
+		std::filesystem::remove(temp_path, ec);
+		return;
+	}
+	spdlog::info("Definition snapshot: saved {} items to {}", bundle.rows.size(), path);
+}
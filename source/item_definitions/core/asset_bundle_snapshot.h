@@ -0,0 +1,24 @@
+#ifndef RME_ITEM_DEFINITIONS_CORE_ASSET_BUNDLE_SNAPSHOT_H_
+#define RME_ITEM_DEFINITIONS_CORE_ASSET_BUNDLE_SNAPSHOT_H_
+
+#include "item_definitions/core/asset_bundle.h"
+
+// Binary snapshot of what AssetBundleLoader::load derives from the DAT, OTB
+// and items.xml files: the DAT catalog, the resolved definition rows, the
+// version info and the parser warnings.
+//
+// One snapshot is kept per client version and set of input paths, under the
+// local directory. It records size, modification time and content hash of
+// every input; a snapshot whose inputs changed (by content, a touched file
+// with the same bytes still matches) is ignored and rewritten after the next
+// full load. The per-source fragment maps are not stored, read() leaves them
+// empty.
+class AssetBundleSnapshot {
+public:
+	// Fills the bundle (without sprite archive) from a valid snapshot.
+	[[nodiscard]] static bool read(const AssetLoadRequest& request, AssetBundle& bundle, std::vector<std::string>& warnings);
+	// Stores the bundle for the next start. Failures are only logged.
+	static void write(const AssetLoadRequest& request, const AssetBundle& bundle, const std::vector<std::string>& warnings);
+};
+
+#endif
@@ -8,7 +8,10 @@
 #include "item_definitions/formats/otb/otb_item_parser.h"
 #include "item_definitions/formats/xml/xml_item_parser.h"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <optional>
 
 namespace {
 	void seedVersionInfoFromClient(const ItemDefinitionLoadInput& input, ItemDefinitionFragments& fragments) {
@@ -19,9 +22,59 @@ namespace {
 		fragments.version.major_version = input.client_version->getOtbMajor();
 		fragments.version.minor_version = input.client_version->getOtbId();
 	}
+
+	bool recipeUses(const ItemDefinitionRecipe& recipe, ItemDefinitionSourceKind kind) {
+		return std::find(recipe.sources.begin(), recipe.sources.begin() + recipe.source_count, kind) != recipe.sources.begin() + recipe.source_count;
+	}
+
+	template <typename Parser>
+	std::future<ItemDefinitionSourceResult> startSource(const ItemDefinitionLoadInput& input) {
+		// Captured by value: the task may outlive the caller's input.
+		return std::async(std::launch::async, [input]() {
+			ItemDefinitionSourceResult result;
+			seedVersionInfoFromClient(input, result.fragments);
+			result.ok = Parser().parse(input, result.fragments, result.error, result.warnings);
+			return result;
+		});
+	}
+
+	// Joins a background source and hands over its diagnostics. Returns nullopt
+	// if the source was already consumed (recipes may list a source twice).
+	std::optional<ItemDefinitionSourceResult> joinSource(std::future<ItemDefinitionSourceResult>& task, wxString& error, std::vector<std::string>& warnings) {
+		if (!task.valid()) {
+			return std::nullopt;
+		}
+		ItemDefinitionSourceResult result = task.get();
+		warnings.insert(warnings.end(), std::make_move_iterator(result.warnings.begin()), std::make_move_iterator(result.warnings.end()));
+		if (!result.ok) {
+			error = result.error;
+		}
+		return result;
+	}
+}
+
+PendingItemDefinitionSources ItemDefinitionsLoader::startFileSources(const ItemDefinitionLoadInput& input) const {
+	PendingItemDefinitionSources pending;
+	const ItemDefinitionRecipe& recipe = ItemDefinitionRecipeRegistry::get(input.mode);
+	if (!recipe.runnable || input.xml_path.GetFullPath().IsEmpty()) {
+		return pending;
+	}
+
+	if (recipeUses(recipe, ItemDefinitionSourceKind::Otb)) {
+		pending.otb = startSource<OtbItemParser>(input);
+	}
+	if (recipeUses(recipe, ItemDefinitionSourceKind::Xml)) {
+		pending.xml = startSource<XmlItemParser>(input);
+	}
+	return pending;
 }
 
 bool ItemDefinitionsLoader::assemble(const ItemDefinitionLoadInput& input, ItemDefinitionFragments& fragments, std::vector<ResolvedItemDefinitionRow>& rows, wxString& error, std::vector<std::string>& warnings) const {
+	PendingItemDefinitionSources pending = startFileSources(input);
+	return assemble(input, pending, fragments, rows, error, warnings);
+}
+
+bool ItemDefinitionsLoader::assemble(const ItemDefinitionLoadInput& input, PendingItemDefinitionSources& pending, ItemDefinitionFragments& fragments, std::vector<ResolvedItemDefinitionRow>& rows, wxString& error, std::vector<std::string>& warnings) const {
 	const ItemDefinitionRecipe& recipe = ItemDefinitionRecipeRegistry::get(input.mode);
 	if (!recipe.runnable) {
 		error = "Selected item definition mode is not implemented yet.";
@@ -38,9 +91,9 @@ bool ItemDefinitionsLoader::assemble(const ItemDefinitionLoadInput& input, ItemD
 	seedVersionInfoFromClient(input, fragments);
 
 	DatItemParser dat_parser;
-	OtbItemParser otb_parser;
-	XmlItemParser xml_parser;
 
+	// OTB and items.xml were parsed in the background; their results are merged
+	// in recipe order so errors and warnings read as if they ran in sequence.
 	for (size_t i = 0; i < recipe.source_count; ++i) {
 		switch (recipe.sources[i]) {
 			case ItemDefinitionSourceKind::Dat:
@@ -49,13 +102,20 @@ bool ItemDefinitionsLoader::assemble(const ItemDefinitionLoadInput& input, ItemD
 				}
 				break;
 			case ItemDefinitionSourceKind::Otb:
-				if (!otb_parser.parse(input, fragments, error, warnings)) {
-					return false;
+				if (auto result = joinSource(pending.otb, error, warnings)) {
+					if (!result->ok) {
+						return false;
+					}
+					fragments.otb = std::move(result->fragments.otb);
+					fragments.version = result->fragments.version;
 				}
 				break;
 			case ItemDefinitionSourceKind::Xml:
-				if (!xml_parser.parse(input, fragments, error, warnings)) {
-					return false;
+				if (auto result = joinSource(pending.xml, error, warnings)) {
+					if (!result->ok) {
+						return false;
+					}
+					fragments.xml = std::move(result->fragments.xml);
 				}
 				break;
 			case ItemDefinitionSourceKind::Srv:
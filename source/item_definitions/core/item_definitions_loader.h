@@ -3,8 +3,30 @@
 
 #include "item_definitions/core/item_definition_store.h"
 
+#include <future>
+
+// Outcome of one source parsed on its own thread, into its own fragments.
+struct ItemDefinitionSourceResult {
+	bool ok = false;
+	ItemDefinitionFragments fragments;
+	wxString error;
+	std::vector<std::string> warnings;
+};
+
+// The file-backed sources of a recipe (OTB, items.xml) being parsed in the
+// background. A future without shared state means the recipe doesn't use it.
+struct PendingItemDefinitionSources {
+	std::future<ItemDefinitionSourceResult> otb;
+	std::future<ItemDefinitionSourceResult> xml;
+};
+
 class ItemDefinitionsLoader {
 public:
+	// Starts the sources that don't need the DAT catalog, so the caller can read
+	// the DAT and sprite files while they run.
+	PendingItemDefinitionSources startFileSources(const ItemDefinitionLoadInput& input) const;
+
+	bool assemble(const ItemDefinitionLoadInput& input, PendingItemDefinitionSources& pending, ItemDefinitionFragments& fragments, std::vector<ResolvedItemDefinitionRow>& rows, wxString& error, std::vector<std::string>& warnings) const;
 	bool assemble(const ItemDefinitionLoadInput& input, ItemDefinitionFragments& fragments, std::vector<ResolvedItemDefinitionRow>& rows, wxString& error, std::vector<std::string>& warnings) const;
 	bool load(const ItemDefinitionLoadInput& input, wxString& error, std::vector<std::string>& warnings) const;
 };
@@ -2,14 +2,28 @@
 
 #include "app/client_version.h"
 #include "io/filehandle.h"
+#include "io/mapped_file.h"
 #include "util/common.h"
+#include "util/parallel.h"
 
 #include <algorithm>
 #include <climits>
+#include <cstring>
 #include <format>
+#include <functional>
 #include <limits>
+#include <span>
 
 namespace {
+	// Where the sprite id table of one sprite group sits in the file. The scan
+	// only records these; the ids are decoded afterwards, in parallel.
+	struct SpriteIdBlock {
+		uint32_t client_id;
+		uint32_t group_index;
+		size_t offset;
+		uint32_t count;
+	};
+
 	constexpr uint64_t flagMask(ItemFlag flag) {
 		return uint64_t { 1 } << static_cast<uint8_t>(flag);
 	}
@@ -291,45 +305,87 @@ namespace {
 		return true;
 	}
 
-	bool readSpriteIds(DatCatalog& catalog, FileReadHandle& file, DatCatalogEntry& entry, uint32_t sprite_count, uint32_t group_index, std::vector<std::string>& warnings) {
-		if (group_index == 0) {
-			entry.sprite_ids.clear();
-			entry.sprite_ids.reserve(sprite_count);
+	bool skipSpriteIds(const DatCatalog& catalog, FileReadHandle& file, const DatCatalogEntry& entry, uint32_t sprite_count, uint32_t group_index, std::vector<SpriteIdBlock>& blocks) {
+		const size_t id_size = catalog.is_extended ? sizeof(uint32_t) : sizeof(uint16_t);
+		const size_t offset = file.tell();
+		const size_t table_size = static_cast<size_t>(sprite_count) * id_size;
+		if (offset + table_size > file.size() || !file.skip(table_size)) {
+			return false;
 		}
+		blocks.push_back({ entry.client_id, group_index, offset, sprite_count });
+		return true;
+	}
 
-		for (uint32_t sprite_index = 0; sprite_index < sprite_count; ++sprite_index) {
-			uint32_t sprite_id = 0;
-			if (catalog.is_extended) {
-				if (!file.getU32(sprite_id)) {
-					return false;
+	// First block holding an id past MAX_SPRITES, found while decoding.
+	struct SpriteIdFailure {
+		size_t block = SIZE_MAX;
+		uint32_t sprite_id = 0;
+	};
+
+	// Decodes blocks [start, end) into the entries' sprite_ids (first group
+	// only, like the client) and returns the largest id seen there.
+	uint32_t decodeSpriteIds(DatCatalog& catalog, std::span<const uint8_t> bytes, const std::vector<SpriteIdBlock>& blocks, size_t start, size_t end, SpriteIdFailure& failure) {
+		uint32_t max_sprite_id = 0;
+		for (size_t i = start; i < end; ++i) {
+			const SpriteIdBlock& block = blocks[i];
+			const uint8_t* cursor = bytes.data() + block.offset;
+			DatCatalogEntry& entry = catalog.entries[block.client_id];
+			if (block.group_index == 0) {
+				entry.sprite_ids.resize(block.count);
+			}
+
+			for (uint32_t sprite_index = 0; sprite_index < block.count; ++sprite_index) {
+				uint32_t sprite_id = 0;
+				if (catalog.is_extended) {
+					std::memcpy(&sprite_id, cursor, sizeof(uint32_t));
+					cursor += sizeof(uint32_t);
+				} else {
+					uint16_t compact_id = 0;
+					std::memcpy(&compact_id, cursor, sizeof(uint16_t));
+					cursor += sizeof(uint16_t);
+					sprite_id = compact_id;
 				}
-			} else {
-				uint16_t compact_id = 0;
-				if (!file.getU16(compact_id)) {
-					return false;
+				if (sprite_id >= MAX_SPRITES) {
+					failure = { i, sprite_id };
+					return max_sprite_id;
+				}
+				if (block.group_index == 0) {
+					entry.sprite_ids[sprite_index] = sprite_id;
+					max_sprite_id = std::max(max_sprite_id, sprite_id);
 				}
-				sprite_id = compact_id;
-			}
-			if (sprite_id >= MAX_SPRITES) {
-				warnings.push_back(std::format(
-					"DAT catalog: sprite id {} exceeds MAX_SPRITES={} for client id {}.",
-					sprite_id,
-					MAX_SPRITES,
-					entry.client_id));
-				return false;
 			}
+		}
+		return max_sprite_id;
+	}
 
-			if (group_index != 0) {
-				continue;
+	// Fills the sprite ids of every scanned group from the mapped file, split
+	// over worker threads. Returns false with the offending block on the first
+	// out-of-range id.
+	bool decodeSpriteBlocks(DatCatalog& catalog, std::span<const uint8_t> bytes, const std::vector<SpriteIdBlock>& blocks, SpriteIdFailure& failure) {
+		struct ChunkResult {
+			uint32_t max_sprite_id;
+			SpriteIdFailure failure;
+		};
+		const auto chunks = parallelFor(0, blocks.size(), 2048, [&catalog, bytes, &blocks](size_t start, size_t end) {
+			ChunkResult result;
+			result.max_sprite_id = decodeSpriteIds(catalog, bytes, blocks, start, end, result.failure);
+			return result;
+		});
+
+		for (const ChunkResult& chunk : chunks) {
+			catalog.max_sprite_id = std::max(catalog.max_sprite_id, chunk.max_sprite_id);
+		}
+		// Chunks are in block order, so the first failing chunk has the earliest block.
+		for (const ChunkResult& chunk : chunks) {
+			if (chunk.failure.block != SIZE_MAX) {
+				failure = chunk.failure;
+				return false;
 			}
-
-			entry.sprite_ids.push_back(sprite_id);
-			catalog.max_sprite_id = std::max(catalog.max_sprite_id, sprite_id);
 		}
 		return true;
 	}
 
-	bool readSpriteGroup(DatCatalog& catalog, FileReadHandle& file, DatCatalogEntry& entry, uint32_t group_index, std::vector<std::string>& warnings) {
+	bool readSpriteGroup(const DatCatalog& catalog, FileReadHandle& file, DatCatalogEntry& entry, uint32_t group_index, std::vector<SpriteIdBlock>& blocks, std::vector<std::string>& warnings) {
 		if (catalog.has_frame_groups && entry.client_id > catalog.item_count && !file.skip(1)) {
 			return false;
 		}
@@ -412,7 +468,7 @@ namespace {
 			entry.numsprites = sprite_count;
 		}
 
-		return readSpriteIds(catalog, file, entry, sprite_count, group_index, warnings);
+		return skipSpriteIds(catalog, file, entry, sprite_count, group_index, blocks);
 	}
 }
 
@@ -493,35 +549,68 @@ bool DatItemParser::parseCatalog(const ItemDefinitionLoadInput& input, DatCatalo
 	catalog.entries.clear();
 	catalog.entries.resize(static_cast<size_t>(catalog.lastEntryId()) + 1);
 
-	for (uint32_t client_id = 100; client_id <= catalog.lastEntryId(); ++client_id) {
-		auto& entry = catalog.entries[client_id];
-		entry = {};
-		entry.client_id = client_id;
-		entry.item_fragment.client_id = static_cast<ClientItemId>(client_id);
+	// Sequential scan: flags and group headers are variable-length, so each
+	// entry has to be read to find the next. The sprite id tables are skipped
+	// and only located.
+	std::vector<SpriteIdBlock> blocks;
+	blocks.reserve(catalog.lastEntryId());
+	const bool scanned = [&]() {
+		for (uint32_t client_id = 100; client_id <= catalog.lastEntryId(); ++client_id) {
+			auto& entry = catalog.entries[client_id];
+			entry = {};
+			entry.client_id = client_id;
+			entry.item_fragment.client_id = static_cast<ClientItemId>(client_id);
+
+			if (!readFlags(catalog.format, file, entry, error, warnings)) {
+				if (error.empty()) {
+					error = wxstr(std::format("Failed to read DAT flags for client id {}", client_id));
+				}
+				return false;
+			}
 
-		if (!readFlags(catalog.format, file, entry, error, warnings)) {
-			if (error.empty()) {
-				error = wxstr(std::format("Failed to read DAT flags for client id {}", client_id));
+			uint8_t group_count = 1;
+			if (catalog.has_frame_groups && client_id > catalog.item_count && !file.getU8(group_count)) {
+				error = wxstr(std::format("Failed to read DAT frame-group count for client id {}", client_id));
+				return false;
+			}
+			if (group_count == 0) {
+				error = wxstr(std::format("Invalid DAT frame-group count for client id {}", client_id));
+				return false;
 			}
-			return false;
-		}
 
-		uint8_t group_count = 1;
-		if (catalog.has_frame_groups && client_id > catalog.item_count && !file.getU8(group_count)) {
-			error = wxstr(std::format("Failed to read DAT frame-group count for client id {}", client_id));
-			return false;
+			for (uint32_t group_index = 0; group_index < group_count; ++group_index) {
+				if (!readSpriteGroup(catalog, file, entry, group_index, blocks, warnings)) {
+					error = wxstr(std::format("Failed to read DAT sprite group {} for client id {}", group_index, client_id));
+					return false;
+				}
+			}
 		}
-		if (group_count == 0) {
-			error = wxstr(std::format("Invalid DAT frame-group count for client id {}", client_id));
+		return true;
+	}();
+
+	// The id tables are most of the file; decode them in parallel from a
+	// mapping. An out-of-range id comes before any later scan failure.
+	MappedFile mapping;
+	if (!blocks.empty()) {
+		std::string map_error;
+		if (!mapping.open(nstr(input.dat_path.GetFullPath()), map_error)) {
+			error = wxstr(map_error);
 			return false;
 		}
-
-		for (uint32_t group_index = 0; group_index < group_count; ++group_index) {
-			if (!readSpriteGroup(catalog, file, entry, group_index, warnings)) {
-				error = wxstr(std::format("Failed to read DAT sprite group {} for client id {}", group_index, client_id));
-				return false;
-			}
-		}
+	}
+	SpriteIdFailure failure;
+	if (!decodeSpriteBlocks(catalog, mapping.data(), blocks, failure)) {
+		const SpriteIdBlock& block = blocks[failure.block];
+		warnings.push_back(std::format(
+			"DAT catalog: sprite id {} exceeds MAX_SPRITES={} for client id {}.",
+			failure.sprite_id,
+			MAX_SPRITES,
+			block.client_id));
+		error = wxstr(std::format("Failed to read DAT sprite group {} for client id {}", block.group_index, block.client_id));
+		return false;
+	}
+	if (!scanned) {
+		return false;
 	}
 
 	if (catalog.item_count == 0 || catalog.entries.size() <= 100 || !catalog.entry(100)) {
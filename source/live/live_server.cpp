@@ -186,16 +186,17 @@ void LiveServer::broadcastNodes(DirtyList& dirtyList) {
 		return;
 	}
 
-	for (const auto& ind : dirtyList.GetPosList()) {
-		int32_t ndx = ind.pos >> 18;
-		int32_t ndy = (ind.pos >> 4) & 0x3FFF;
-		uint32_t floors = ind.floors;
-
-		MapNode* node = editor->map.getLeaf(ndx * 4, ndy * 4);
+	// Nodes come cell by cell rather than in one x/y order; each is sent on
+	// its own, so peers don't depend on the order
+	dirtyList.ForEachNode([&](int node_x, int node_y, uint32_t floors) {
+		MapNode* node = editor->map.getLeaf(node_x, node_y);
 		if (!node) {
-			continue;
+			return;
 		}
 
+		const int32_t ndx = node_x >> 2;
+		const int32_t ndy = node_y >> 2;
+
 		std::lock_guard<std::mutex> lock(clientMutex);
 		for (auto& clientEntry : clients) {
 			LivePeer* peer = clientEntry.second.get();
@@ -213,7 +214,7 @@ void LiveServer::broadcastNodes(DirtyList& dirtyList) {
 				peer->sendNode(clientId, node, ndx, ndy, floors & 0x00FF);
 			}
 		}
-	}
+	});
 }
 
 void LiveServer::broadcastCursor(const LiveCursor& cursor) {
@@ -22,6 +22,8 @@
 #include "live/live_tab.h"
 #include "editor/editor.h"
 
+#include <utility>
+
 LiveSocket::LiveSocket() :
 	cursors(), mapReader(nullptr, 0), mapWriter(),
 	mapVersion(MapVersion(MAP_OTBM_4, OTB_VERSION_NONE)), log(nullptr),
@@ -261,7 +263,7 @@ void LiveSocket::sendTile(MemoryNodeFileWriteHandle& writer, Tile* tile, const P
 		}
 	}
 
-	for (const auto& item : tile->items) {
+	for (const auto& item : std::as_const(tile->items)) {
 		item->serializeItemNode_OTBM(mapVersion, writer);
 	}
 
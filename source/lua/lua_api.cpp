@@ -62,6 +62,7 @@ namespace LuaAPI {
 		registerHttp(lua);
 
 		// Register procedural generation APIs
+		registerGrid(lua);
 		registerNoise(lua);
 		registerAlgo(lua);
 		registerGeo(lua);
@@ -49,6 +49,7 @@ namespace LuaAPI {
 	void registerHttp(sol::state& lua);
 
 	// Procedural generation APIs
+	void registerGrid(sol::state& lua);
 	void registerNoise(sol::state& lua);
 	void registerAlgo(sol::state& lua);
 	void registerGeo(sol::state& lua);
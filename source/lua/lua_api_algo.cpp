@@ -17,6 +17,7 @@
 
 #include "app/main.h"
 #include "lua_api_algo.h"
+#include "lua_api_grid.h"
 
 #include <vector>
 #include <random>
@@ -28,66 +29,6 @@
 
 namespace LuaAPI {
 
-	// Helper: convert Lua table to 2D grid
-	static std::vector<std::vector<int>> tableToGrid(const sol::table& tbl, int width, int height) {
-		std::vector<std::vector<int>> grid(height, std::vector<int>(width, 0));
-
-		for (int y = 1; y <= height; ++y) {
-			if (tbl[y].valid() && tbl[y].get_type() == sol::type::table) {
-				sol::table row = tbl[y];
-				for (int x = 1; x <= width; ++x) {
-					if (row[x].valid()) {
-						grid[y - 1][x - 1] = row[x].get<int>();
-					}
-				}
-			}
-		}
-		return grid;
-	}
-
-	// Helper: convert 2D grid to Lua table
-	static sol::table gridToTable(const std::vector<std::vector<int>>& grid, sol::state_view& lua) {
-		sol::table result = lua.create_table();
-		for (size_t y = 0; y < grid.size(); ++y) {
-			sol::table row = lua.create_table();
-			for (size_t x = 0; x < grid[y].size(); ++x) {
-				row[x + 1] = grid[y][x];
-			}
-			result[y + 1] = row;
-		}
-		return result;
-	}
-
-	// Helper: convert Lua table to 2D float grid
-	static std::vector<std::vector<float>> tableToFloatGrid(const sol::table& tbl, int width, int height) {
-		std::vector<std::vector<float>> grid(height, std::vector<float>(width, 0.0f));
-
-		for (int y = 1; y <= height; ++y) {
-			if (tbl[y].valid() && tbl[y].get_type() == sol::type::table) {
-				sol::table row = tbl[y];
-				for (int x = 1; x <= width; ++x) {
-					if (row[x].valid()) {
-						grid[y - 1][x - 1] = row[x].get<float>();
-					}
-				}
-			}
-		}
-		return grid;
-	}
-
-	// Helper: convert 2D float grid to Lua table
-	static sol::table floatGridToTable(const std::vector<std::vector<float>>& grid, sol::state_view& lua) {
-		sol::table result = lua.create_table();
-		for (size_t y = 0; y < grid.size(); ++y) {
-			sol::table row = lua.create_table();
-			for (size_t x = 0; x < grid[y].size(); ++x) {
-				row[x + 1] = grid[y][x];
-			}
-			result[y + 1] = row;
-		}
-		return result;
-	}
-
 	// BSP Node for dungeon generation
 	struct BSPNode {
 		int x, y, w, h;
@@ -106,9 +47,9 @@ namespace LuaAPI {
 
 		// algo.cellularAutomata(grid, options) -> grid
 		// Run cellular automata simulation (useful for caves, organic shapes)
-		// grid: 2D table where 1 = wall, 0 = floor
+		// grid: Grid or 2D table where 1 = wall, 0 = floor
 		// options: { iterations, birthLimit, deathLimit, width, height }
-		algoTable.set_function("cellularAutomata", [](sol::table inputGrid, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
+		algoTable.set_function("cellularAutomata", [](sol::object inputGrid, sol::optional<sol::table> options, sol::this_state s) -> sol::object {
 			sol::state_view lua(s);
 
 			int iterations = 4;
@@ -118,13 +59,7 @@ namespace LuaAPI {
 			int height = 0;
 
 			// Get dimensions from grid
-			if (inputGrid[1].valid()) {
-				height = static_cast<int>(inputGrid.size());
-				if (inputGrid[1].get_type() == sol::type::table) {
-					sol::table firstRow = inputGrid[1];
-					width = static_cast<int>(firstRow.size());
-				}
-			}
+			gridArgumentSize(inputGrid, width, height);
 
 			if (options) {
 				sol::table opts = *options;
@@ -139,7 +74,7 @@ namespace LuaAPI {
 				return inputGrid; // Return unchanged if invalid dimensions
 			}
 
-			auto grid = tableToGrid(inputGrid, width, height);
+			auto grid = readIntGrid(inputGrid, width, height);
 
 			// Run iterations
 			for (int iter = 0; iter < iterations; ++iter) {
@@ -179,13 +114,13 @@ namespace LuaAPI {
 				grid = newGrid;
 			}
 
-			return gridToTable(grid, lua);
+			return writeGridLike(inputGrid, grid, lua);
 		});
 
 		// algo.generateCave(width, height, options) -> grid
 		// Generate a cave map using cellular automata
-		// options: { fillProbability, iterations, birthLimit, deathLimit, seed }
-		algoTable.set_function("generateCave", [](int width, int height, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
+		// options: { fillProbability, iterations, birthLimit, deathLimit, seed, asGrid }
+		algoTable.set_function("generateCave", [](int width, int height, sol::optional<sol::table> options, sol::this_state s) -> sol::object {
 			sol::state_view lua(s);
 
 			if (width <= 0 || height <= 0) {
@@ -253,7 +188,7 @@ namespace LuaAPI {
 				grid = newGrid;
 			}
 
-			return gridToTable(grid, lua);
+			return writeGridAs(requestedGridType(options, LuaGrid::Type::U8), grid, lua);
 		});
 
 		// ========================================
@@ -262,21 +197,15 @@ namespace LuaAPI {
 
 		// algo.erode(heightmap, options) -> heightmap
 		// Hydraulic erosion simulation for terrain
-		// heightmap: 2D table of float values [0, 1]
+		// heightmap: Grid or 2D table of float values [0, 1]
 		// options: { iterations, erosionRadius, inertia, sedimentCapacity, minSlope, erosionSpeed, depositSpeed, evaporateSpeed, gravity }
-		algoTable.set_function("erode", [](sol::table inputHeightmap, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
+		algoTable.set_function("erode", [](sol::object inputHeightmap, sol::optional<sol::table> options, sol::this_state s) -> sol::object {
 			sol::state_view lua(s);
 
 			// Get dimensions
 			int height = 0;
 			int width = 0;
-			if (inputHeightmap[1].valid()) {
-				height = static_cast<int>(inputHeightmap.size());
-				if (inputHeightmap[1].get_type() == sol::type::table) {
-					sol::table firstRow = inputHeightmap[1];
-					width = static_cast<int>(firstRow.size());
-				}
-			}
+			gridArgumentSize(inputHeightmap, width, height);
 
 			if (width <= 2 || height <= 2) {
 				return inputHeightmap;
@@ -311,7 +240,7 @@ namespace LuaAPI {
 				maxDropletLifetime = std::max(1, opts.get_or(std::string("maxDropletLifetime"), 30));
 			}
 
-			auto heightmap = tableToFloatGrid(inputHeightmap, width, height);
+			auto heightmap = readFloatGrid(inputHeightmap, width, height);
 
 			std::mt19937 rng(seed);
 			std::uniform_real_distribution<float> dist(0.0f, 1.0f);
@@ -453,23 +382,17 @@ namespace LuaAPI {
 				}
 			}
 
-			return floatGridToTable(heightmap, lua);
+			return writeGridLike(inputHeightmap, heightmap, lua);
 		});
 
 		// algo.thermalErode(heightmap, options) -> heightmap
 		// Thermal erosion (talus/slope erosion)
-		algoTable.set_function("thermalErode", [](sol::table inputHeightmap, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
+		algoTable.set_function("thermalErode", [](sol::object inputHeightmap, sol::optional<sol::table> options, sol::this_state s) -> sol::object {
 			sol::state_view lua(s);
 
 			int height = 0;
 			int width = 0;
-			if (inputHeightmap[1].valid()) {
-				height = static_cast<int>(inputHeightmap.size());
-				if (inputHeightmap[1].get_type() == sol::type::table) {
-					sol::table firstRow = inputHeightmap[1];
-					width = static_cast<int>(firstRow.size());
-				}
-			}
+			gridArgumentSize(inputHeightmap, width, height);
 
 			if (width <= 2 || height <= 2) {
 				return inputHeightmap;
@@ -486,7 +409,7 @@ namespace LuaAPI {
 				erosionAmount = opts.get_or(std::string("erosionAmount"), 0.5f);
 			}
 
-			auto heightmap = tableToFloatGrid(inputHeightmap, width, height);
+			auto heightmap = readFloatGrid(inputHeightmap, width, height);
 
 			// 4-directional neighbors
 			const int dx[] = { 0, 1, 0, -1 };
@@ -525,7 +448,7 @@ namespace LuaAPI {
 				heightmap = newHeightmap;
 			}
 
-			return floatGridToTable(heightmap, lua);
+			return writeGridLike(inputHeightmap, heightmap, lua);
 		});
 
 		// ========================================
@@ -534,18 +457,12 @@ namespace LuaAPI {
 
 		// algo.smooth(grid, options) -> grid
 		// Gaussian-like smoothing for grids
-		algoTable.set_function("smooth", [](sol::table inputGrid, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
+		algoTable.set_function("smooth", [](sol::object inputGrid, sol::optional<sol::table> options, sol::this_state s) -> sol::object {
 			sol::state_view lua(s);
 
 			int height = 0;
 			int width = 0;
-			if (inputGrid[1].valid()) {
-				height = static_cast<int>(inputGrid.size());
-				if (inputGrid[1].get_type() == sol::type::table) {
-					sol::table firstRow = inputGrid[1];
-					width = static_cast<int>(firstRow.size());
-				}
-			}
+			gridArgumentSize(inputGrid, width, height);
 
 			if (width <= 2 || height <= 2) {
 				return inputGrid;
@@ -566,7 +483,7 @@ namespace LuaAPI {
 				kernelSize++;
 			}
 
-			auto grid = tableToFloatGrid(inputGrid, width, height);
+			auto grid = readFloatGrid(inputGrid, width, height);
 
 			int radius = kernelSize / 2;
 
@@ -592,16 +509,17 @@ namespace LuaAPI {
 				grid = newGrid;
 			}
 
-			return floatGridToTable(grid, lua);
+			return writeGridLike(inputGrid, grid, lua);
 		});
 
 		// ========================================
 		// VORONOI DIAGRAM
 		// ========================================
 
-		// algo.voronoi(width, height, points) -> grid of region indices
+		// algo.voronoi(width, height, points, options) -> grid of region indices
 		// Generate Voronoi diagram from seed points
-		algoTable.set_function("voronoi", [](int width, int height, sol::table points, sol::this_state s) -> sol::table {
+		// options: { asGrid }
+		algoTable.set_function("voronoi", [](int width, int height, sol::table points, sol::optional<sol::table> options, sol::this_state s) -> sol::object {
 			sol::state_view lua(s);
 
 			if (width <= 0 || height <= 0) {
@@ -645,7 +563,7 @@ namespace LuaAPI {
 				}
 			}
 
-			return gridToTable(grid, lua);
+			return writeGridAs(requestedGridType(options, LuaGrid::Type::I32), grid, lua);
 		});
 
 		// algo.generateRandomPoints(width, height, count, seed) -> table of points
@@ -684,7 +602,8 @@ namespace LuaAPI {
 
 		// algo.generateMaze(width, height, options) -> grid
 		// Generate a maze using recursive backtracking
-		algoTable.set_function("generateMaze", [](int width, int height, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
+		// options: { seed, asGrid }
+		algoTable.set_function("generateMaze", [](int width, int height, sol::optional<sol::table> options, sol::this_state s) -> sol::object {
 			sol::state_view lua(s);
 
 			if (width <= 0 || height <= 0) {
@@ -708,7 +627,7 @@ namespace LuaAPI {
 			if (carveHeight % 2 == 0) carveHeight--;
 
 			if (carveWidth < 3 || carveHeight < 3) {
-				return gridToTable(std::vector<std::vector<int>>(height, std::vector<int>(width, 1)), lua);
+				return writeGridAs(requestedGridType(options, LuaGrid::Type::U8), std::vector<std::vector<int>>(height, std::vector<int>(width, 1)), lua);
 			}
 
 			// Initialize grid with walls (using original size)
@@ -753,7 +672,7 @@ namespace LuaAPI {
 				}
 			}
 
-			return gridToTable(grid, lua);
+			return writeGridAs(requestedGridType(options, LuaGrid::Type::U8), grid, lua);
 		});
 
 		// ========================================
@@ -761,7 +680,7 @@ namespace LuaAPI {
 		// ========================================
 
 		// algo.generateDungeon(width, height, options) -> { grid, rooms }
-		// Generate a dungeon using BSP
+		// Generate a dungeon using BSP; options.asGrid returns grid as a Grid
 		algoTable.set_function("generateDungeon", [](int width, int height, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
 			sol::state_view lua(s);
 
@@ -898,7 +817,7 @@ namespace LuaAPI {
 
 			// Return result
 			sol::table result = lua.create_table();
-			result["grid"] = gridToTable(grid, lua);
+			result["grid"] = writeGridAs(requestedGridType(options, LuaGrid::Type::U8), grid, lua);
 
 			sol::table roomsTable = lua.create_table();
 			for (size_t i = 0; i < rooms.size(); ++i) {
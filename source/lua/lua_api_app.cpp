@@ -18,6 +18,7 @@
 #include "app/main.h"
 #include "lua_api_app.h"
 #include "lua_script_manager.h"
+#include "lua_api_grid.h"
 #include "ui/gui.h"
 #include "editor/editor.h"
 #include "editor/copybuffer.h"
@@ -25,10 +26,13 @@
 #include "map/map.h"
 #include "brushes/brush.h"
 #include "editor/action.h"
+#include "editor/operations/draw_operations.h"
 #include "map/tile.h"
 #include "editor/selection.h"
 #include "game/items.h"
 #include "brushes/raw/raw_brush.h"
+#include "brushes/ground/ground_brush.h"
+#include "brushes/wall/wall_brush.h"
 #include "brushes/ground/auto_border.h"
 #include "util/file_system.h"
 #include "ui/map_tab.h"
@@ -258,6 +262,10 @@ namespace LuaAPI {
 		if (LuaTransaction::getInstance().isActive()) {
 			LuaTransaction::getInstance().markTileModified(tile, originallyExisted);
 		}
+		// Scripts edit tiles in place, past the map index's setTile hook
+		if (tile && g_gui.IsEditorOpen()) {
+			g_gui.GetCurrentMap().index.markDirty(tile->getX(), tile->getY());
+		}
 	}
 
 	// ============================================================================
@@ -409,6 +417,101 @@ namespace LuaAPI {
 		}
 	}
 
+	// Resolves one app.paintGrid palette value: an item id, a brush name, a
+	// Brush, or a list of item ids stacked in order
+	static GridPaintEntry paletteEntry(const sol::object& value) {
+		GridPaintEntry entry;
+		Brush* brush = nullptr;
+		if (value.is<Brush*>()) {
+			brush = value.as<Brush*>();
+		} else if (value.get_type() == sol::type::string) {
+			const std::string name = value.as<std::string>();
+			brush = g_brushes.getBrush(name);
+			if (!brush) {
+				throw sol::error("app.paintGrid: unknown brush '" + name + "'");
+			}
+		} else if (value.get_type() == sol::type::number) {
+			entry.items.push_back(value.as<uint16_t>());
+		} else if (value.get_type() == sol::type::table) {
+			sol::table ids = value.as<sol::table>();
+			for (size_t i = 1; i <= ids.size(); ++i) {
+				entry.items.push_back(ids[i].get<uint16_t>());
+			}
+		} else {
+			throw sol::error("app.paintGrid: palette values must be item ids, brush names, brushes or lists of item ids");
+		}
+
+		if (brush) {
+			if (RAWBrush* raw = dynamic_cast<RAWBrush*>(brush)) {
+				entry.items.push_back(raw->getItemID());
+			} else if (brush->is<GroundBrush>() || brush->is<WallBrush>()) {
+				entry.brush = brush;
+			} else {
+				throw sol::error("app.paintGrid: brush '" + brush->getName() + "' cannot be painted from a grid (use ground, wall or raw brushes)");
+			}
+		}
+		return entry;
+	}
+
+	// app.paintGrid(grid, origin, palette [, options]) -> number of tiles changed
+	// Paints every cell of a Grid (or nested table) of palette indices onto the
+	// floor of origin, as a single undo step. options: { borderize = true }
+	static size_t paintGrid(sol::object input, const Position& origin, sol::table palette, sol::optional<sol::table> options) {
+		Editor* editor = g_gui.GetCurrentEditor();
+		if (!editor) {
+			throw sol::error("No map open");
+		}
+		if (LuaTransaction::getInstance().isActive()) {
+			throw sol::error("app.paintGrid cannot run inside app.transaction; it already records one undo step");
+		}
+		if (!origin.isValid()) {
+			throw sol::error("app.paintGrid: invalid origin");
+		}
+
+		GridPaint paint;
+		paint.origin = origin;
+		if (!gridArgumentSize(input, paint.width, paint.height) || paint.width <= 0 || paint.height <= 0) {
+			throw sol::error("app.paintGrid: grid must be a non-empty Grid or 2D table");
+		}
+		if (options) {
+			paint.borderize = options->get_or(std::string("borderize"), true);
+		}
+
+		if (input.is<LuaGrid>()) {
+			const LuaGrid& grid = input.as<const LuaGrid&>();
+			grid.visit([&](const auto& data) {
+				paint.cells.resize(data.size());
+				std::transform(data.begin(), data.end(), paint.cells.begin(), [](auto v) { return static_cast<int32_t>(v); });
+			});
+		} else {
+			paint.cells.reserve(static_cast<size_t>(paint.width) * paint.height);
+			for (const auto& row : readIntGrid(input, paint.width, paint.height)) {
+				paint.cells.insert(paint.cells.end(), row.begin(), row.end());
+			}
+		}
+
+		for (const auto& [key, value] : palette) {
+			if (key.get_type() != sol::type::number) {
+				throw sol::error("app.paintGrid: palette keys must be grid values");
+			}
+			const int index = key.as<int>();
+			if (index < 0 || index > 0xFFFF) {
+				throw sol::error("app.paintGrid: palette index " + std::to_string(index) + " is out of range (0-65535)");
+			}
+			if (static_cast<size_t>(index) >= paint.palette.size()) {
+				paint.palette.resize(index + 1);
+			}
+			paint.palette[index] = paletteEntry(value);
+		}
+
+		const size_t changed = DrawOperations::paintGrid(*editor, paint);
+		if (changed > 0) {
+			editor->getMap()->doChange();
+			g_gui.RefreshView();
+		}
+		return changed;
+	}
+
 	static sol::object getBorders(sol::this_state ts) {
 		sol::state_view lua(ts);
 
@@ -672,6 +775,7 @@ namespace LuaAPI {
 			}
 		};
 		app["transaction"] = transaction;
+		app["paintGrid"] = paintGrid;
 		app["setClipboard"] = setClipboard;
 		app["getDataDirectory"] = getDataDirectory;
 
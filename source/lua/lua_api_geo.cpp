@@ -17,6 +17,7 @@
 
 #include "app/main.h"
 #include "lua_api_geo.h"
+#include "lua_api_grid.h"
 #include <random>
 
 #include <vector>
@@ -247,16 +248,14 @@ namespace LuaAPI {
 
 		// geo.floodFill(grid, startX, startY, newValue, options) -> grid
 		// Flood fill algorithm (4-connected or 8-connected)
-		geoTable.set_function("floodFill", [](sol::table inputGrid, int startX, int startY, int newValue, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
+		// grid: Grid or 2D table; the result has the same form
+		geoTable.set_function("floodFill", [](sol::object inputGrid, int startX, int startY, int newValue, sol::optional<sol::table> options, sol::this_state s) -> sol::object {
 			sol::state_view lua(s);
 
 			// Get dimensions
-			int height = static_cast<int>(inputGrid.size());
+			int height = 0;
 			int width = 0;
-			if (inputGrid[1].valid() && inputGrid[1].get_type() == sol::type::table) {
-				sol::table firstRow = inputGrid[1];
-				width = static_cast<int>(firstRow.size());
-			}
+			gridArgumentSize(inputGrid, width, height);
 
 			if (width <= 0 || height <= 0) {
 				return inputGrid;
@@ -269,17 +268,7 @@ namespace LuaAPI {
 			}
 
 			// Convert to grid
-			std::vector<std::vector<int>> grid(height, std::vector<int>(width, 0));
-			for (int y = 1; y <= height; ++y) {
-				if (inputGrid[y].valid() && inputGrid[y].get_type() == sol::type::table) {
-					sol::table row = inputGrid[y];
-					for (int x = 1; x <= width; ++x) {
-						if (row[x].valid()) {
-							grid[y - 1][x - 1] = row[x].get<int>();
-						}
-					}
-				}
-			}
+			auto grid = readIntGrid(inputGrid, width, height);
 
 			// Adjust for 1-indexed Lua
 			int sx = startX - 1;
@@ -323,31 +312,18 @@ namespace LuaAPI {
 				}
 			}
 
-			// Convert back to Lua table
-			sol::table result = lua.create_table();
-			for (int y = 0; y < height; ++y) {
-				sol::table row = lua.create_table();
-				for (int x = 0; x < width; ++x) {
-					row[x + 1] = grid[y][x];
-				}
-				result[y + 1] = row;
-			}
-
-			return result;
+			return writeGridLike(inputGrid, grid, lua);
 		});
 
 		// geo.getFloodFillPositions(grid, startX, startY, options) -> table of positions
 		// Returns all positions that would be filled without modifying the grid
-		geoTable.set_function("getFloodFillPositions", [](sol::table inputGrid, int startX, int startY, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
+		geoTable.set_function("getFloodFillPositions", [](sol::object inputGrid, int startX, int startY, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
 			sol::state_view lua(s);
 			sol::table result = lua.create_table();
 
-			int height = static_cast<int>(inputGrid.size());
+			int height = 0;
 			int width = 0;
-			if (inputGrid[1].valid() && inputGrid[1].get_type() == sol::type::table) {
-				sol::table firstRow = inputGrid[1];
-				width = static_cast<int>(firstRow.size());
-			}
+			gridArgumentSize(inputGrid, width, height);
 
 			if (width <= 0 || height <= 0) {
 				return result;
@@ -360,17 +336,7 @@ namespace LuaAPI {
 			}
 
 			// Convert to grid
-			std::vector<std::vector<int>> grid(height, std::vector<int>(width, 0));
-			for (int y = 1; y <= height; ++y) {
-				if (inputGrid[y].valid() && inputGrid[y].get_type() == sol::type::table) {
-					sol::table row = inputGrid[y];
-					for (int x = 1; x <= width; ++x) {
-						if (row[x].valid()) {
-							grid[y - 1][x - 1] = row[x].get<int>();
-						}
-					}
-				}
-			}
+			auto grid = readIntGrid(inputGrid, width, height);
 
 			int sx = startX - 1;
 			int sy = startY - 1;
@@ -0,0 +1,307 @@
+//////////////////////////////////////////////////////////////////////
+// This file is part of Remere's Map Editor
+//////////////////////////////////////////////////////////////////////
+// Remere's Map Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Remere's Map Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////
+
+#include "app/main.h"
+#include "lua_api_grid.h"
+#include "lua_api_noise.h"
+
+namespace LuaAPI {
+
+	LuaGrid::LuaGrid(int width, int height, Type type) :
+		width(width), height(height), type(type) {
+		if (width <= 0 || height <= 0) {
+			throw sol::error("Grid: width and height must be positive integers");
+		}
+		if (static_cast<int64_t>(width) * height > MAX_CELLS) {
+			throw sol::error("Grid: " + std::to_string(width) + "x" + std::to_string(height) + " exceeds " + std::to_string(MAX_CELLS) + " cells");
+		}
+
+		const size_t count = static_cast<size_t>(width) * height;
+		switch (type) {
+			case Type::U8:
+				cells = std::vector<uint8_t>(count, 0);
+				break;
+			case Type::U16:
+				cells = std::vector<uint16_t>(count, 0);
+				break;
+			case Type::I32:
+				cells = std::vector<int32_t>(count, 0);
+				break;
+			case Type::F32:
+				cells = std::vector<float>(count, 0.0f);
+				break;
+		}
+	}
+
+	std::optional<LuaGrid::Type> LuaGrid::ParseType(const std::string& name) {
+		if (name == "u8") {
+			return Type::U8;
+		} else if (name == "u16") {
+			return Type::U16;
+		} else if (name == "i32") {
+			return Type::I32;
+		} else if (name == "f32") {
+			return Type::F32;
+		}
+		return std::nullopt;
+	}
+
+	const char* LuaGrid::TypeName(Type type) {
+		switch (type) {
+			case Type::U8:
+				return "u8";
+			case Type::U16:
+				return "u16";
+			case Type::I32:
+				return "i32";
+			case Type::F32:
+				return "f32";
+		}
+		return "i32";
+	}
+
+	double LuaGrid::get(int x, int y) const {
+		return visit([&](const auto& data) {
+			return static_cast<double>(data[static_cast<size_t>(y) * width + x]);
+		});
+	}
+
+	void LuaGrid::set(int x, int y, double value) {
+		visit([&](auto& data) {
+			using E = typename std::decay_t<decltype(data)>::value_type;
+			data[static_cast<size_t>(y) * width + x] = Convert<E>(value);
+		});
+	}
+
+	void LuaGrid::fill(double value) {
+		visit([&](auto& data) {
+			using E = typename std::decay_t<decltype(data)>::value_type;
+			std::fill(data.begin(), data.end(), Convert<E>(value));
+		});
+	}
+
+	bool gridArgumentSize(const sol::object& input, int& width, int& height) {
+		width = 0;
+		height = 0;
+		if (input.is<LuaGrid>()) {
+			const LuaGrid& grid = input.as<const LuaGrid&>();
+			width = grid.getWidth();
+			height = grid.getHeight();
+			return true;
+		}
+		if (input.get_type() != sol::type::table) {
+			return false;
+		}
+
+		sol::table tbl = input.as<sol::table>();
+		if (tbl[1].valid()) {
+			height = static_cast<int>(tbl.size());
+			if (tbl[1].get_type() == sol::type::table) {
+				sol::table firstRow = tbl[1];
+				width = static_cast<int>(firstRow.size());
+			}
+		}
+		return true;
+	}
+
+	template <typename T>
+	static std::vector<std::vector<T>> readGrid(const sol::object& input, int width, int height) {
+		if (input.is<LuaGrid>()) {
+			const LuaGrid& grid = input.as<const LuaGrid&>();
+			if (grid.getWidth() == width && grid.getHeight() == height) {
+				return grid.toRows<T>();
+			}
+			std::vector<std::vector<T>> rows(height, std::vector<T>(width, T(0)));
+			for (int y = 0; y < std::min(height, grid.getHeight()); ++y) {
+				for (int x = 0; x < std::min(width, grid.getWidth()); ++x) {
+					rows[y][x] = static_cast<T>(grid.get(x, y));
+				}
+			}
+			return rows;
+		}
+
+		std::vector<std::vector<T>> rows(height, std::vector<T>(width, T(0)));
+		if (input.get_type() != sol::type::table) {
+			return rows;
+		}
+		sol::table tbl = input.as<sol::table>();
+		for (int y = 1; y <= height; ++y) {
+			if (tbl[y].valid() && tbl[y].get_type() == sol::type::table) {
+				sol::table row = tbl[y];
+				for (int x = 1; x <= width; ++x) {
+					if (row[x].valid()) {
+						rows[y - 1][x - 1] = row[x].get<T>();
+					}
+				}
+			}
+		}
+		return rows;
+	}
+
+	template <typename T>
+	static sol::object writeGrid(std::optional<LuaGrid::Type> type, const std::vector<std::vector<T>>& rows, sol::state_view& lua) {
+		const int height = static_cast<int>(rows.size());
+		const int width = height > 0 ? static_cast<int>(rows[0].size()) : 0;
+
+		if (type && width > 0 && height > 0) {
+			LuaGrid result(width, height, *type);
+			result.assignRows(rows);
+			return sol::make_object(lua, std::move(result));
+		}
+
+		sol::table result = lua.create_table(height, 0);
+		for (int y = 0; y < height; ++y) {
+			sol::table row = lua.create_table(static_cast<int>(rows[y].size()), 0);
+			for (size_t x = 0; x < rows[y].size(); ++x) {
+				row[x + 1] = rows[y][x];
+			}
+			result[y + 1] = row;
+		}
+		return result;
+	}
+
+	static std::optional<LuaGrid::Type> gridTypeOf(const sol::object& input) {
+		if (input.is<LuaGrid>()) {
+			return input.as<const LuaGrid&>().getType();
+		}
+		return std::nullopt;
+	}
+
+	std::vector<std::vector<int>> readIntGrid(const sol::object& input, int width, int height) {
+		return readGrid<int>(input, width, height);
+	}
+
+	std::vector<std::vector<float>> readFloatGrid(const sol::object& input, int width, int height) {
+		return readGrid<float>(input, width, height);
+	}
+
+	sol::object writeGridLike(const sol::object& input, const std::vector<std::vector<int>>& rows, sol::state_view& lua) {
+		return writeGrid(gridTypeOf(input), rows, lua);
+	}
+
+	sol::object writeGridLike(const sol::object& input, const std::vector<std::vector<float>>& rows, sol::state_view& lua) {
+		return writeGrid(gridTypeOf(input), rows, lua);
+	}
+
+	sol::object writeGridAs(std::optional<LuaGrid::Type> type, const std::vector<std::vector<int>>& rows, sol::state_view& lua) {
+		return writeGrid(type, rows, lua);
+	}
+
+	sol::object writeGridAs(std::optional<LuaGrid::Type> type, const std::vector<std::vector<float>>& rows, sol::state_view& lua) {
+		return writeGrid(type, rows, lua);
+	}
+
+	std::optional<LuaGrid::Type> requestedGridType(const sol::optional<sol::table>& options, LuaGrid::Type fallback) {
+		if (!options) {
+			return std::nullopt;
+		}
+		sol::object value = (*options)["asGrid"];
+		if (value.is<bool>()) {
+			return value.as<bool>() ? std::optional<LuaGrid::Type>(fallback) : std::nullopt;
+		}
+		if (value.is<std::string>()) {
+			auto type = LuaGrid::ParseType(value.as<std::string>());
+			if (!type) {
+				throw sol::error("asGrid: unknown grid type '" + value.as<std::string>() + "' (expected u8, u16, i32 or f32)");
+			}
+			return type;
+		}
+		return std::nullopt;
+	}
+
+	static LuaGrid::Type typeArgument(const sol::optional<std::string>& name) {
+		if (!name) {
+			return LuaGrid::Type::I32;
+		}
+		auto type = LuaGrid::ParseType(*name);
+		if (!type) {
+			throw sol::error("Grid: unknown type '" + *name + "' (expected u8, u16, i32 or f32)");
+		}
+		return *type;
+	}
+
+	static void checkCell(const LuaGrid& grid, int x, int y) {
+		if (!grid.contains(x - 1, y - 1)) {
+			throw sol::error("Grid: cell (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside " + std::to_string(grid.getWidth()) + "x" + std::to_string(grid.getHeight()));
+		}
+	}
+
+	void registerGrid(sol::state& lua) {
+		auto makeGrid = [](int width, int height, sol::optional<std::string> type) {
+			return LuaGrid(width, height, typeArgument(type));
+		};
+
+		lua.new_usertype<LuaGrid>(
+			"Grid",
+			sol::no_constructor,
+
+			// Grid(width, height [, type]) with type one of "u8", "u16", "i32" (default), "f32"
+			sol::call_constructor, sol::factories(makeGrid),
+			"new", makeGrid,
+
+			// Grid.fromTable(rows [, type]) copies a nested {{...}} table
+			"fromTable", [](sol::table rows, sol::optional<std::string> type) {
+				int width = 0;
+				int height = 0;
+				gridArgumentSize(rows, width, height);
+				LuaGrid grid(width, height, typeArgument(type));
+				grid.assignRows(readGrid<double>(rows, width, height));
+				return grid;
+			},
+
+			// Properties (read-only)
+			"width", sol::property(&LuaGrid::getWidth),
+			"height", sol::property(&LuaGrid::getHeight),
+			"type", sol::property([](const LuaGrid& grid) { return std::string(LuaGrid::TypeName(grid.getType())); }),
+
+			// Cell access (1-based)
+			"get", [](const LuaGrid& grid, int x, int y, sol::this_state s) -> sol::object {
+				checkCell(grid, x, y);
+				const double value = grid.get(x - 1, y - 1);
+				if (grid.getType() == LuaGrid::Type::F32) {
+					return sol::make_object(s, value);
+				}
+				return sol::make_object(s, static_cast<int64_t>(value));
+			},
+			"set", [](LuaGrid& grid, int x, int y, double value) {
+				checkCell(grid, x, y);
+				grid.set(x - 1, y - 1, value);
+			},
+			"fill", &LuaGrid::fill,
+
+			// grid:fillNoise{ seed, frequency, noiseType, fractal, octaves, lacunarity, gain, x, y, min, max }
+			"fillNoise", [](LuaGrid& grid, sol::optional<sol::table> options) -> LuaGrid& {
+				fillGridWithNoise(grid, options);
+				return grid;
+			},
+
+			"clone", [](const LuaGrid& grid) { return LuaGrid(grid); },
+			"toTable", [](const LuaGrid& grid, sol::this_state s) -> sol::object {
+				sol::state_view lua(s);
+				if (grid.getType() == LuaGrid::Type::F32) {
+					return writeGridAs(std::nullopt, grid.toRows<float>(), lua);
+				}
+				return writeGridAs(std::nullopt, grid.toRows<int>(), lua);
+			},
+
+			sol::meta_function::to_string, [](const LuaGrid& grid) {
+				return "Grid(" + std::to_string(grid.getWidth()) + "x" + std::to_string(grid.getHeight()) + ", " + LuaGrid::TypeName(grid.getType()) + ")";
+			}
+		);
+	}
+
+} // namespace LuaAPI
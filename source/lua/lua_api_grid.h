@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////
+// This file is part of Remere's Map Editor
+//////////////////////////////////////////////////////////////////////
+// Remere's Map Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Remere's Map Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef RME_LUA_API_GRID_H
+#define RME_LUA_API_GRID_H
+
+#include "lua_api.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace LuaAPI {
+
+	// Dense width x height buffer of a single element type, exposed to Lua as
+	// the Grid usertype. The algo, geo and noise APIs accept a Grid wherever
+	// they take a nested {{...}} table and return one in kind, so large grids
+	// never have to be built out of Lua tables.
+	// C++ indexes cells from 0; the Lua methods index from 1 like the tables.
+	class LuaGrid {
+	public:
+		enum class Type : uint8_t {
+			U8,
+			U16,
+			I32,
+			F32,
+		};
+
+		// Largest grid a script may allocate (an 8192x8192 area)
+		static constexpr int64_t MAX_CELLS = 8192 * 8192;
+
+		LuaGrid(int width, int height, Type type = Type::I32);
+
+		static std::optional<Type> ParseType(const std::string& name);
+		static const char* TypeName(Type type);
+
+		int getWidth() const {
+			return width;
+		}
+		int getHeight() const {
+			return height;
+		}
+		Type getType() const {
+			return type;
+		}
+		bool contains(int x, int y) const {
+			return x >= 0 && y >= 0 && x < width && y < height;
+		}
+
+		// Integer types round and saturate on store
+		double get(int x, int y) const;
+		void set(int x, int y, double value);
+		void fill(double value);
+
+		// Calls fn with the backing std::vector of the active element type
+		template <typename Fn>
+		decltype(auto) visit(Fn&& fn) {
+			return std::visit(std::forward<Fn>(fn), cells);
+		}
+		template <typename Fn>
+		decltype(auto) visit(Fn&& fn) const {
+			return std::visit(std::forward<Fn>(fn), cells);
+		}
+
+		// Nested row copies, the layout the algorithm implementations use
+		template <typename T>
+		std::vector<std::vector<T>> toRows() const;
+		template <typename T>
+		void assignRows(const std::vector<std::vector<T>>& rows);
+
+		// Rounds and saturates a value into element type E
+		template <typename E>
+		static E Convert(double value);
+
+	private:
+		int width;
+		int height;
+		Type type;
+		std::variant<std::vector<uint8_t>, std::vector<uint16_t>, std::vector<int32_t>, std::vector<float>> cells;
+	};
+
+	// Helpers for API functions taking "a Grid or a nested table"
+
+	// Reads the dimensions of a grid argument. Tables are measured by their
+	// row count and the length of their first row.
+	bool gridArgumentSize(const sol::object& input, int& width, int& height);
+	// Copies a grid argument into rows; missing table cells read as 0
+	std::vector<std::vector<int>> readIntGrid(const sol::object& input, int width, int height);
+	std::vector<std::vector<float>> readFloatGrid(const sol::object& input, int width, int height);
+	// Returns rows in the same form as the input: a Grid of the input's
+	// element type, or a nested table
+	sol::object writeGridLike(const sol::object& input, const std::vector<std::vector<int>>& rows, sol::state_view& lua);
+	sol::object writeGridLike(const sol::object& input, const std::vector<std::vector<float>>& rows, sol::state_view& lua);
+	// Returns rows as a Grid of the given type, or as a nested table for nullopt
+	sol::object writeGridAs(std::optional<LuaGrid::Type> type, const std::vector<std::vector<int>>& rows, sol::state_view& lua);
+	sol::object writeGridAs(std::optional<LuaGrid::Type> type, const std::vector<std::vector<float>>& rows, sol::state_view& lua);
+
+	// Element type requested through the `asGrid` option of generators:
+	// true selects fallback, a string names the type. nullopt means "return
+	// a table".
+	std::optional<LuaGrid::Type> requestedGridType(const sol::optional<sol::table>& options, LuaGrid::Type fallback);
+
+	template <typename T>
+	std::vector<std::vector<T>> LuaGrid::toRows() const {
+		std::vector<std::vector<T>> rows(height, std::vector<T>(width));
+		visit([&](const auto& data) {
+			for (int y = 0; y < height; ++y) {
+				const auto* src = data.data() + static_cast<size_t>(y) * width;
+				std::transform(src, src + width, rows[y].begin(), [](auto v) { return static_cast<T>(v); });
+			}
+		});
+		return rows;
+	}
+
+	template <typename T>
+	void LuaGrid::assignRows(const std::vector<std::vector<T>>& rows) {
+		visit([&](auto& data) {
+			using E = typename std::decay_t<decltype(data)>::value_type;
+			for (int y = 0; y < height && y < static_cast<int>(rows.size()); ++y) {
+				const int count = std::min(width, static_cast<int>(rows[y].size()));
+				E* dest = data.data() + static_cast<size_t>(y) * width;
+				for (int x = 0; x < count; ++x) {
+					dest[x] = Convert<E>(static_cast<double>(rows[y][x]));
+				}
+			}
+		});
+	}
+
+	template <typename E>
+	E LuaGrid::Convert(double value) {
+		if constexpr (std::is_floating_point_v<E>) {
+			return static_cast<E>(value);
+		} else {
+			if (std::isnan(value)) {
+				return 0;
+			}
+			const double lo = static_cast<double>(std::numeric_limits<E>::min());
+			const double hi = static_cast<double>(std::numeric_limits<E>::max());
+			return static_cast<E>(std::clamp(std::round(value), lo, hi));
+		}
+	}
+
+} // namespace LuaAPI
+
+#endif // RME_LUA_API_GRID_H
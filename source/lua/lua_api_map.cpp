@@ -140,6 +140,14 @@ namespace LuaAPI {
 				return map ? map->getTileCount() : 0;
 			}),
 
+			// Number of items with this server id on the map, from the map index
+			"countItems", [](Map* map, int itemId) -> uint64_t {
+				if (!map || itemId < 0 || itemId > 65535) {
+					return 0;
+				}
+				return map->index.countOf(static_cast<uint16_t>(itemId));
+			},
+
 			// Get tile methods
 			"getTile", sol::overload([](Map* map, int x, int y, int z) -> Tile* { return map ? map->getTile(x, y, z) : nullptr; }, [](Map* map, const Position& pos) -> Tile* { return map ? map->getTile(pos) : nullptr; }),
 
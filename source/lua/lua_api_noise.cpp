@@ -17,7 +17,12 @@
 
 #include "app/main.h"
 #include "lua_api_noise.h"
+#include "lua_api_grid.h"
 #include "ext/fast_noise_lite.h"
+#include "util/parallel.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace LuaAPI {
 
@@ -30,6 +35,89 @@ namespace LuaAPI {
 		return noise;
 	}
 
+	// Generator configured by the options shared by noise.generateGrid and
+	// Grid:fillNoise: seed, frequency, noiseType, fractal, octaves, lacunarity, gain
+	static FastNoiseLite noiseFromGridOptions(const sol::optional<sol::table>& options) {
+		FastNoiseLite noise;
+
+		if (options) {
+			sol::table opts = *options;
+			noise.SetSeed(opts.get_or(std::string("seed"), 1337));
+			noise.SetFrequency(opts.get_or(std::string("frequency"), 0.01f));
+
+			std::string noiseType = opts.get_or<std::string>(std::string("noiseType"), "simplex");
+			if (noiseType == "perlin") {
+				noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+			} else if (noiseType == "simplex") {
+				noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+			} else if (noiseType == "cellular") {
+				noise.SetNoiseType(FastNoiseLite::NoiseType_Cellular);
+			} else if (noiseType == "value") {
+				noise.SetNoiseType(FastNoiseLite::NoiseType_Value);
+			}
+
+			// Fractal settings
+			std::string fractal = opts.get_or<std::string>(std::string("fractal"), "none");
+			if (fractal == "fbm") {
+				noise.SetFractalType(FastNoiseLite::FractalType_FBm);
+				noise.SetFractalOctaves(opts.get_or(std::string("octaves"), 4));
+				noise.SetFractalLacunarity(opts.get_or(std::string("lacunarity"), 2.0f));
+				noise.SetFractalGain(opts.get_or(std::string("gain"), 0.5f));
+			} else if (fractal == "ridged") {
+				noise.SetFractalType(FastNoiseLite::FractalType_Ridged);
+				noise.SetFractalOctaves(opts.get_or(std::string("octaves"), 4));
+			}
+		} else {
+			noise.SetSeed(1337);
+			noise.SetFrequency(0.01f);
+			noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+		}
+		return noise;
+	}
+
+	// Samples the world points (originX + x, originY + y) into every cell,
+	// mapping [-1, 1] linearly onto [outMin, outMax]
+	static void sampleNoise(LuaGrid& grid, const FastNoiseLite& noise, int originX, int originY, float outMin, float outMax) {
+		const float scale = (outMax - outMin) * 0.5f;
+		const int width = grid.getWidth();
+		const int height = grid.getHeight();
+
+		grid.visit([&](auto& data) {
+			using E = typename std::decay_t<decltype(data)>::value_type;
+
+			// Rows are independent, so they are split over worker threads, each
+			// sampling its own copy of the generator. Chunks of at least 32K
+			// samples keep small grids on one thread.
+			const size_t min_rows = std::max<size_t>(1, 32768 / std::max(width, 1));
+			parallelFor(0, static_cast<size_t>(height), min_rows, [&](size_t start, size_t end) {
+				FastNoiseLite local = noise;
+				for (size_t y = start; y < end; ++y) {
+					E* row = data.data() + y * width;
+					const float wy = static_cast<float>(originY + static_cast<int>(y));
+					for (int x = 0; x < width; ++x) {
+						const float n = local.GetNoise(static_cast<float>(originX + x), wy);
+						row[x] = LuaGrid::Convert<E>(outMin + (n + 1.0f) * scale);
+					}
+				}
+			});
+		});
+	}
+
+	void fillGridWithNoise(LuaGrid& grid, const sol::optional<sol::table>& options) {
+		int originX = 0;
+		int originY = 0;
+		float outMin = -1.0f;
+		float outMax = 1.0f;
+		if (options) {
+			sol::table opts = *options;
+			originX = opts.get_or(std::string("x"), 0);
+			originY = opts.get_or(std::string("y"), 0);
+			outMin = opts.get_or(std::string("min"), -1.0f);
+			outMax = opts.get_or(std::string("max"), 1.0f);
+		}
+		sampleNoise(grid, noiseFromGridOptions(options), originX, originY, outMin, outMax);
+	}
+
 	void registerNoise(sol::state& lua) {
 		sol::table noiseTable = lua.create_table();
 
@@ -391,9 +479,10 @@ namespace LuaAPI {
 
 		// noise.generateGrid(x1, y1, x2, y2, options) -> table of values
 		// Generate noise values for a grid area (faster than individual calls)
-		noiseTable.set_function("generateGrid", [](int x1, int y1, int x2, int y2, sol::optional<sol::table> options, sol::this_state s) -> sol::table {
+		// With options.asGrid the values come back as an f32 Grid (or the type
+		// named by asGrid) filled without building any Lua tables.
+		noiseTable.set_function("generateGrid", [](int x1, int y1, int x2, int y2, sol::optional<sol::table> options, sol::this_state s) -> sol::object {
 			sol::state_view lua(s);
-			sol::table result = lua.create_table();
 
 			if (x1 > x2 || y1 > y2) {
 				throw sol::error("noise.generateGrid: x1 must be <= x2 and y1 must be <= y2");
@@ -402,47 +491,22 @@ namespace LuaAPI {
 			const int64_t width = static_cast<int64_t>(x2) - static_cast<int64_t>(x1) + 1;
 			const int64_t height = static_cast<int64_t>(y2) - static_cast<int64_t>(y1) + 1;
 
-			constexpr int64_t MAX_GRID_CELLS = 1000000;
-			if (width <= 0 || height <= 0 || width > MAX_GRID_CELLS / height) {
-				throw sol::error("noise.generateGrid: Requested grid is too large (exceeds " + std::to_string(MAX_GRID_CELLS) + " cells)");
+			const std::optional<LuaGrid::Type> gridType = requestedGridType(options, LuaGrid::Type::F32);
+			const int64_t maxCells = gridType ? LuaGrid::MAX_CELLS : 1000000;
+			if (width <= 0 || height <= 0 || width > maxCells / height) {
+				throw sol::error("noise.generateGrid: Requested grid is too large (exceeds " + std::to_string(maxCells) + " cells)");
 			}
 
-			FastNoiseLite noise;
-
-			if (options) {
-				sol::table opts = *options;
-				noise.SetSeed(opts.get_or(std::string("seed"), 1337));
-				noise.SetFrequency(opts.get_or(std::string("frequency"), 0.01f));
+			FastNoiseLite noise = noiseFromGridOptions(options);
 
-				std::string noiseType = opts.get_or<std::string>(std::string("noiseType"), "simplex");
-				if (noiseType == "perlin") {
-					noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-				} else if (noiseType == "simplex") {
-					noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-				} else if (noiseType == "cellular") {
-					noise.SetNoiseType(FastNoiseLite::NoiseType_Cellular);
-				} else if (noiseType == "value") {
-					noise.SetNoiseType(FastNoiseLite::NoiseType_Value);
-				}
-
-				// Fractal settings
-				std::string fractal = opts.get_or<std::string>(std::string("fractal"), "none");
-				if (fractal == "fbm") {
-					noise.SetFractalType(FastNoiseLite::FractalType_FBm);
-					noise.SetFractalOctaves(opts.get_or(std::string("octaves"), 4));
-					noise.SetFractalLacunarity(opts.get_or(std::string("lacunarity"), 2.0f));
-					noise.SetFractalGain(opts.get_or(std::string("gain"), 0.5f));
-				} else if (fractal == "ridged") {
-					noise.SetFractalType(FastNoiseLite::FractalType_Ridged);
-					noise.SetFractalOctaves(opts.get_or(std::string("octaves"), 4));
-				}
-			} else {
-				noise.SetSeed(1337);
-				noise.SetFrequency(0.01f);
-				noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+			if (gridType) {
+				LuaGrid grid(static_cast<int>(width), static_cast<int>(height), *gridType);
+				sampleNoise(grid, noise, x1, y1, -1.0f, 1.0f);
+				return sol::make_object(lua, std::move(grid));
 			}
 
 			// Generate values
+			sol::table result = lua.create_table();
 			for (int64_t y = y1; y <= y2; ++y) {
 				sol::table row = lua.create_table();
 				for (int64_t x = x1; x <= x2; ++x) {
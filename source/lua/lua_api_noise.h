@@ -21,8 +21,14 @@
 #include "lua_api.h"
 
 namespace LuaAPI {
+	class LuaGrid;
+
 	// Register noise generation functions (perlin, simplex, cellular, fbm, etc.)
 	void registerNoise(sol::state& lua);
+
+	// Fills every cell of grid with noise (Grid:fillNoise), using worker
+	// threads for large grids
+	void fillGridWithNoise(LuaGrid& grid, const sol::optional<sol::table>& options);
 }
 
 #endif // RME_LUA_API_NOISE_H
@@ -31,6 +31,7 @@ BaseMap::BaseMap() :
 void BaseMap::clear(bool del) {
 	std::ranges::for_each(tiles(), [&](auto& loc) {
 		if (loc.tile) {
+			onTileReplaced(loc.getX(), loc.getY());
 			std::unique_ptr<Tile> t = std::move(loc.tile);
 			if (!del) {
 				t.release();
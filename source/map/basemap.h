@@ -162,6 +162,11 @@ public:
 	MapAllocator allocator;
 
 protected:
+	// Called whenever the tile at (x, y) is replaced or removed through
+	// setTile/swapTile/createTile or clear. Lets derived maps keep per-cell
+	// indices in step without scanning.
+	virtual void onTileReplaced(int x, int y) { }
+
 	uint64_t tilecount;
 
 	SpatialHashGrid grid; // The Spatial Hash Grid
@@ -0,0 +1,32 @@
+#include "app/main.h"
+#include "map/item_list.h"
+
+void ItemList::share(ItemList& other) {
+	if (&other == this) {
+		return;
+	}
+	if (!other.shared) {
+		if (other.owned.empty()) {
+			clear();
+			return;
+		}
+		other.shared = std::make_shared<Vector>(std::move(other.owned));
+		other.owned.clear();
+	}
+	owned.clear();
+	shared = other.shared;
+}
+
+void ItemList::copyShared() {
+	if (shared.use_count() == 1) {
+		// The other tiles are gone, the items are ours alone
+		owned = std::move(*shared);
+	} else {
+		owned.clear();
+		owned.reserve(shared->size());
+		for (const auto& item : *shared) {
+			owned.push_back(item->deepCopy());
+		}
+	}
+	shared.reset();
+}
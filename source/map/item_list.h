@@ -0,0 +1,170 @@
+#ifndef RME_ITEM_LIST_H_
+#define RME_ITEM_LIST_H_
+
+#include "game/item.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// The stacked items of a tile, with the interface of the vector it replaces.
+//
+// Several tiles can share one immutable list: a paste leaves the pasted tiles
+// pointing at the copy buffer's items, so pasting a prefab again and again,
+// and keeping those pastes in the undo history, costs no item copies. The
+// list is copied on the first write, which is any non-const access: a
+// non-const begin(), operator[], front() or back() may hand out an item to
+// modify, so they unshare as well. Code that only reads a tile that may be
+// shared (renderers, tile flag updates) should go through a const reference,
+// e.g. std::as_const(tile->items), to keep the sharing.
+//
+// Items reached through a const ItemList may belong to other tiles too and
+// must not be modified.
+class ItemList {
+public:
+	using Vector = std::vector<std::unique_ptr<Item>>;
+	using value_type = Vector::value_type;
+	using size_type = Vector::size_type;
+	using difference_type = Vector::difference_type;
+	using reference = Vector::reference;
+	using const_reference = Vector::const_reference;
+	using iterator = Vector::iterator;
+	using const_iterator = Vector::const_iterator;
+	using reverse_iterator = Vector::reverse_iterator;
+	using const_reverse_iterator = Vector::const_reverse_iterator;
+
+	ItemList() = default;
+
+	ItemList(const ItemList&) = delete;
+	ItemList& operator=(const ItemList&) = delete;
+
+	// Makes this list refer to the items of other until either is written to.
+	// other is turned into a shared list itself, its items keep their address.
+	void share(ItemList& other);
+	bool isShared() const {
+		return shared != nullptr;
+	}
+	// Gives this list items of its own, copying the shared ones if needed.
+	// Called by every non-const accessor.
+	Vector& unshare() {
+		if (shared) {
+			copyShared();
+		}
+		return owned;
+	}
+
+	// Reading
+	bool empty() const {
+		return view().empty();
+	}
+	size_type size() const {
+		return view().size();
+	}
+	size_type capacity() const {
+		return view().capacity();
+	}
+	const_iterator begin() const {
+		return view().begin();
+	}
+	const_iterator end() const {
+		return view().end();
+	}
+	const_iterator cbegin() const {
+		return view().cbegin();
+	}
+	const_iterator cend() const {
+		return view().cend();
+	}
+	const_reverse_iterator rbegin() const {
+		return view().rbegin();
+	}
+	const_reverse_iterator rend() const {
+		return view().rend();
+	}
+	const_reference operator[](size_type index) const {
+		return view()[index];
+	}
+	const_reference at(size_type index) const {
+		return view().at(index);
+	}
+	const_reference front() const {
+		return view().front();
+	}
+	const_reference back() const {
+		return view().back();
+	}
+
+	// Writing
+	iterator begin() {
+		return unshare().begin();
+	}
+	iterator end() {
+		return unshare().end();
+	}
+	reverse_iterator rbegin() {
+		return unshare().rbegin();
+	}
+	reverse_iterator rend() {
+		return unshare().rend();
+	}
+	reference operator[](size_type index) {
+		return unshare()[index];
+	}
+	reference at(size_type index) {
+		return unshare().at(index);
+	}
+	reference front() {
+		return unshare().front();
+	}
+	reference back() {
+		return unshare().back();
+	}
+
+	void reserve(size_type count) {
+		unshare().reserve(count);
+	}
+	void push_back(value_type&& item) {
+		unshare().push_back(std::move(item));
+	}
+	void pop_back() {
+		unshare().pop_back();
+	}
+	// The position may come from a const (shared) view of this list
+	iterator insert(const_iterator pos, value_type&& item) {
+		const difference_type offset = pos - view().begin();
+		Vector& items = unshare();
+		return items.insert(items.begin() + offset, std::move(item));
+	}
+	iterator erase(const_iterator pos) {
+		const difference_type offset = pos - view().begin();
+		Vector& items = unshare();
+		return items.erase(items.begin() + offset);
+	}
+	iterator erase(const_iterator first, const_iterator last) {
+		const difference_type from = first - view().begin();
+		const difference_type to = last - view().begin();
+		Vector& items = unshare();
+		return items.erase(items.begin() + from, items.begin() + to);
+	}
+	// std::erase_if for the list
+	template <typename Predicate>
+	size_type eraseIf(Predicate pred) {
+		return std::erase_if(unshare(), pred);
+	}
+	void clear() {
+		shared.reset();
+		owned.clear();
+	}
+
+private:
+	const Vector& view() const {
+		return shared ? *shared : owned;
+	}
+	void copyShared();
+
+	// Exactly one of the two holds the items: owned, or shared while the list
+	// refers to items other tiles hold as well
+	Vector owned;
+	std::shared_ptr<Vector> shared;
+};
+
+#endif
@@ -41,6 +41,7 @@ Map::Map() :
 	width(512),
 	height(512),
 	houses(*this),
+	index(*this),
 	has_changed(false),
 	unnamed(false),
 	waypoints(*this),
@@ -90,6 +91,8 @@ bool Map::open(const std::string& file) {
 	bool success = maploader.loadMap(*this, wxstr(file));
 
 	mapVersion = maploader.version;
+	// Tiles are filled in place while loading; index them on first use.
+	index.invalidate();
 
 	warnings = maploader.getWarnings();
 
@@ -109,16 +112,22 @@ bool Map::open(const std::string& file) {
 	return true;
 }
 
+// Conversions rewrite item ids in place, so the index starts over afterwards.
 bool Map::convert(MapVersion to, bool showdialog) {
-	return MapConverter::convert(*this, to, showdialog);
+	const bool converted = MapConverter::convert(*this, to, showdialog);
+	index.invalidate();
+	return converted;
 }
 
 bool Map::convert(const ConversionMap& rm, bool showdialog) {
-	return MapConverter::convert(*this, rm, showdialog);
+	const bool converted = MapConverter::convert(*this, rm, showdialog);
+	index.invalidate();
+	return converted;
 }
 
 void Map::cleanInvalidTiles(bool showdialog) {
 	MapConverter::cleanInvalidTiles(*this, showdialog);
+	index.invalidate();
 }
 
 void Map::cleanInvalidZones(bool showdialog) {
@@ -140,6 +149,7 @@ bool Map::hasChanged() const {
 bool Map::doChange() {
 	bool doupdate = !has_changed;
 	has_changed = true;
+	++change_count;
 	return doupdate;
 }
 
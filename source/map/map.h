@@ -30,6 +30,8 @@
 #include "game/sound_zones.h"
 #include "game/instance_zones.h"
 #include "io/templates.h"
+#include "map/map_index.h"
+#include "map/map_region.h"
 
 class MapConverter;
 class MapSpawnManager;
@@ -60,6 +62,10 @@ public:
 	bool doChange();
 	// Clears any changes
 	bool clearChanges();
+	// Counts doChange calls, so a save can tell whether the map changed after its snapshot
+	uint64_t getChangeCount() const {
+		return change_count;
+	}
 
 	// Errors/warnings
 	bool hasWarnings() const {
@@ -147,6 +153,10 @@ public:
 	void initializeEmpty();
 
 protected:
+	void onTileReplaced(int x, int y) override {
+		index.markDirty(x, y);
+	}
+
 	// Loads a map
 	bool open(const std::string& identifier);
 
@@ -171,9 +181,11 @@ public:
 	Towns towns;
 	Houses houses;
 	Spawns spawns;
+	MapIndex index;
 
 protected:
 	bool has_changed; // If the map has changed
+	uint64_t change_count = 0;
 	bool unnamed; // If the map has yet to receive a name
 
 	friend class IOMapOTBM;
@@ -283,6 +295,7 @@ inline int64_t RemoveItemOnMap(Map& map, RemoveIfType& condition, bool selectedO
 			return;
 		}
 
+		const int64_t before = removed;
 		if (tile->ground) {
 			if (condition(map, tile->ground.get(), removed, done)) {
 				tile->ground.reset();
@@ -291,15 +304,83 @@ inline int64_t RemoveItemOnMap(Map& map, RemoveIfType& condition, bool selectedO
 		}
 
 		// Use C++20's std::erase_if for a safer and more idiomatic way to remove elements.
-		std::erase_if(tile->items, [&](const auto& item) {
+		tile->items.eraseIf([&](const auto& item) {
 			if (condition(map, item.get(), removed, done)) {
 				++removed;
 				return true;
 			}
 			return false;
 		});
+		if (removed != before) {
+			// Edited in place, bypassing swapTile.
+			map.index.markDirty(tile->getX(), tile->getY());
+		}
 	});
 	return removed;
 }
 
+// Visits every item with the given server id, in the same order as
+// foreach_ItemOnMap, but only walks the grid cells the map index lists for it.
+template <typename ForeachType>
+inline void foreach_ItemWithIdOnMap(Map& map, uint16_t id, ForeachType& foreach) {
+	long long done = 0;
+	std::vector<Container*> containers;
+	containers.reserve(32);
+
+	auto visit = [&](Tile* tile, Item* item) {
+		if (item->getID() == id) {
+			foreach (map, tile, item, done)
+				;
+		}
+	};
+
+	const SpatialHashGrid& grid = map.getGrid();
+	for (const MapIndex::CellKey key : map.index.cellsContaining(id)) {
+		const SpatialHashGrid::GridCell* cell = grid.findCell(key);
+		if (!cell) {
+			continue;
+		}
+		for (const auto& node_ptr : cell->nodes) {
+			MapNode* node = node_ptr.get();
+			if (!node) {
+				continue;
+			}
+			for (int z = 0; z <= MAP_MAX_LAYER; ++z) {
+				Floor* floor = node->getFloor(z);
+				if (!floor) {
+					continue;
+				}
+				for (TileLocation& loc : floor->locs) {
+					Tile* tile = loc.get();
+					if (!tile) {
+						continue;
+					}
+					++done;
+					if (tile->ground) {
+						visit(tile, tile->ground.get());
+					}
+					for (const auto& item : tile->items) {
+						visit(tile, item.get());
+						Container* container = item->asContainer();
+						if (!container) {
+							continue;
+						}
+						containers.clear();
+						containers.push_back(container);
+						size_t index = 0;
+						while (index < containers.size()) {
+							for (const auto& inner : containers[index++]->getVector()) {
+								visit(tile, inner.get());
+								if (Container* c = inner->asContainer()) {
+									containers.push_back(c);
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
 #endif
@@ -181,7 +181,7 @@ void MapConverter::cleanInvalidTiles(Map& map, bool showdialog) {
 		}
 
 		// Use std::erase_if from C++20 for cleanup
-		std::erase_if(tile->items, [](const std::unique_ptr<Item>& item) {
+		tile->items.eraseIf([](const std::unique_ptr<Item>& item) {
 			return item->isInvalidOTBMItem() || !g_item_definitions.typeExists(item->getID());
 		});
 
@@ -0,0 +1,331 @@
+#include "app/main.h"
+#include "map/map_index.h"
+#include "map/basemap.h"
+#include "map/map_region.h"
+#include "map/tile.h"
+#include "game/item.h"
+#include "game/complexitem.h"
+#include "util/parallel.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace {
+	constexpr size_t ITEM_ID_SLOTS = size_t(std::numeric_limits<uint16_t>::max()) + 1;
+
+	// Per-thread scratch for counting one cell: a dense counter per id plus the
+	// list of ids touched, so resetting costs only what was used.
+	struct CellCounter {
+		std::vector<uint32_t> counts = std::vector<uint32_t>(ITEM_ID_SLOTS, 0);
+		std::vector<uint16_t> touched;
+		std::vector<const Container*> containers;
+
+		void add(const Item* item) {
+			const uint16_t id = item->getID();
+			if (counts[id]++ == 0) {
+				touched.push_back(id);
+			}
+		}
+
+		void addTile(const Tile* tile) {
+			if (tile->ground) {
+				add(tile->ground.get());
+			}
+			for (const auto& item : tile->items) {
+				add(item.get());
+				const Container* container = item->asContainer();
+				if (!container) {
+					continue;
+				}
+				containers.clear();
+				containers.push_back(container);
+				size_t idx = 0;
+				while (idx < containers.size()) {
+					for (const auto& inner : containers[idx++]->getVector()) {
+						add(inner.get());
+						if (const Container* c = inner->asContainer()) {
+							containers.push_back(c);
+						}
+					}
+				}
+			}
+		}
+
+		std::vector<MapIndex::ItemCount> takeItems() {
+			std::ranges::sort(touched);
+			std::vector<MapIndex::ItemCount> result;
+			result.reserve(touched.size());
+			for (uint16_t id : touched) {
+				result.push_back({ id, counts[id] });
+				counts[id] = 0;
+			}
+			touched.clear();
+			return result;
+		}
+	};
+
+	MapIndex::CellRecord CountCell(const SpatialHashGrid::GridCell* cell, CellCounter& counter) {
+		MapIndex::CellRecord record;
+		if (!cell) {
+			return record;
+		}
+
+		std::array<TileStatistics, MAP_LAYERS> floors {};
+		for (const auto& node_ptr : cell->nodes) {
+			const MapNode* node = node_ptr.get();
+			if (!node) {
+				continue;
+			}
+			for (int z = 0; z <= MAP_MAX_LAYER; ++z) {
+				const Floor* floor = node->getFloor(z);
+				if (!floor) {
+					continue;
+				}
+				for (const TileLocation& loc : floor->locs) {
+					const Tile* tile = loc.get();
+					if (!tile) {
+						continue;
+					}
+					counter.addTile(tile);
+					MapStatisticsCollector::AccumulateTile(tile, floors[z]);
+					if (const uint32_t house_id = tile->getHouseID()) {
+						// A cell holds only a few houses
+						auto house = std::ranges::find(record.houses, house_id, &std::pair<uint32_t, TileStatistics>::first);
+						if (house == record.houses.end()) {
+							house = record.houses.insert(house, { house_id, TileStatistics() });
+						}
+						MapStatisticsCollector::AccumulateTile(tile, house->second);
+					}
+				}
+			}
+		}
+
+		record.items = counter.takeItems();
+		for (int z = 0; z <= MAP_MAX_LAYER; ++z) {
+			if (!floors[z].empty()) {
+				record.floors.emplace_back(static_cast<uint8_t>(z), floors[z]);
+			}
+		}
+		return record;
+	}
+
+	// Counts the given cells over worker threads, each with its own scratch
+	// counter. Results are returned in input order.
+	std::vector<MapIndex::CellRecord> CountCells(const std::vector<const SpatialHashGrid::GridCell*>& targets) {
+		std::vector<MapIndex::CellRecord> results(targets.size());
+		parallelFor(0, targets.size(), 16, [&targets, &results](size_t start, size_t end) {
+			CellCounter counter;
+			for (size_t i = start; i < end; ++i) {
+				results[i] = CountCell(targets[i], counter);
+			}
+		});
+		return results;
+	}
+}
+
+MapIndex::MapIndex(BaseMap& map) :
+	map(map) {
+	////
+}
+
+void MapIndex::invalidate() {
+	built = false;
+	dirty.clear();
+	dirty.shrink_to_fit();
+	cells.clear();
+	totals.clear();
+	totals.shrink_to_fit();
+	postings.clear();
+	postings.shrink_to_fit();
+	floorTotals = {};
+	houseTotals.clear();
+}
+
+uint64_t MapIndex::countOf(uint16_t id) {
+	refresh();
+	return totals[id];
+}
+
+const std::vector<MapIndex::CellKey>& MapIndex::cellsContaining(uint16_t id) {
+	refresh();
+	return postings[id];
+}
+
+const std::vector<MapIndex::ItemCount>& MapIndex::cellItems(CellKey key) {
+	static const std::vector<ItemCount> none;
+	refresh();
+	auto it = cells.find(key);
+	return it != cells.end() ? it->second.items : none;
+}
+
+const std::array<TileStatistics, MAP_LAYERS>& MapIndex::floorStatistics() {
+	refresh();
+	return floorTotals;
+}
+
+const std::unordered_map<uint32_t, TileStatistics>& MapIndex::houseStatistics() {
+	refresh();
+	return houseTotals;
+}
+
+std::array<TileStatistics, MAP_LAYERS> MapIndex::floorStatisticsIn(int min_x, int min_y, int max_x, int max_y) {
+	refresh();
+	std::array<TileStatistics, MAP_LAYERS> result {};
+	const int min_cx = min_x >> SpatialHashGrid::CELL_SHIFT;
+	const int min_cy = min_y >> SpatialHashGrid::CELL_SHIFT;
+	const int max_cx = max_x >> SpatialHashGrid::CELL_SHIFT;
+	const int max_cy = max_y >> SpatialHashGrid::CELL_SHIFT;
+	for (const auto& [key, record] : cells) {
+		int cx, cy;
+		SpatialHashGrid::getCellCoordsFromKey(key, cx, cy);
+		if (cx < min_cx || cx > max_cx || cy < min_cy || cy > max_cy) {
+			continue;
+		}
+		for (const auto& [z, stats] : record.floors) {
+			result[z] += stats;
+		}
+	}
+	return result;
+}
+
+void MapIndex::refresh() {
+	if (!built) {
+		rebuild();
+		return;
+	}
+	if (dirty.empty()) {
+		return;
+	}
+
+	std::ranges::sort(dirty);
+	dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+	// Past this point recounting everything is as cheap as patching and leaves
+	// tighter postings behind.
+	const SpatialHashGrid& grid = map.getGrid();
+	if (dirty.size() * 2 > grid.cellCount()) {
+		rebuild();
+		return;
+	}
+
+	std::vector<const SpatialHashGrid::GridCell*> targets;
+	targets.reserve(dirty.size());
+	for (CellKey key : dirty) {
+		targets.push_back(grid.findCell(key));
+	}
+
+	auto fresh = CountCells(targets);
+	for (size_t i = 0; i < dirty.size(); ++i) {
+		replaceCell(dirty[i], std::move(fresh[i]));
+	}
+	dirty.clear();
+}
+
+void MapIndex::rebuild() {
+	cells.clear();
+	dirty.clear();
+	totals.assign(ITEM_ID_SLOTS, 0);
+	floorTotals = {};
+	houseTotals.clear();
+	postings.resize(ITEM_ID_SLOTS);
+	for (auto& list : postings) {
+		list.clear();
+	}
+
+	const auto sorted = map.getGrid().getSortedCells();
+	std::vector<const SpatialHashGrid::GridCell*> targets;
+	targets.reserve(sorted.size());
+	for (const auto& entry : sorted) {
+		targets.push_back(entry.cell);
+	}
+
+	auto counted = CountCells(targets);
+	cells.reserve(sorted.size());
+	// Cells come in key order, so every posting list stays sorted by appending.
+	for (size_t i = 0; i < sorted.size(); ++i) {
+		if (counted[i].empty()) {
+			continue;
+		}
+		for (const ItemCount& entry : counted[i].items) {
+			totals[entry.id] += entry.count;
+			postings[entry.id].push_back(sorted[i].key);
+		}
+		for (const auto& [z, stats] : counted[i].floors) {
+			floorTotals[z] += stats;
+		}
+		for (const auto& [house_id, stats] : counted[i].houses) {
+			houseTotals[house_id] += stats;
+		}
+		cells.emplace(sorted[i].key, std::move(counted[i]));
+	}
+	built = true;
+}
+
+void MapIndex::replaceCell(CellKey key, CellRecord record) {
+	static const CellRecord none;
+	auto it = cells.find(key);
+	const CellRecord& previous = it != cells.end() ? it->second : none;
+
+	for (const auto& [z, stats] : previous.floors) {
+		floorTotals[z] -= stats;
+	}
+	for (const auto& [z, stats] : record.floors) {
+		floorTotals[z] += stats;
+	}
+	for (const auto& [house_id, stats] : previous.houses) {
+		auto total = houseTotals.find(house_id);
+		total->second -= stats;
+		if (total->second.empty()) {
+			houseTotals.erase(total);
+		}
+	}
+	for (const auto& [house_id, stats] : record.houses) {
+		houseTotals[house_id] += stats;
+	}
+
+	const std::vector<ItemCount>& old = previous.items;
+	const std::vector<ItemCount>& fresh = record.items;
+
+	auto addPosting = [&](uint16_t id) {
+		auto& list = postings[id];
+		list.insert(std::lower_bound(list.begin(), list.end(), key), key);
+	};
+	auto removePosting = [&](uint16_t id) {
+		auto& list = postings[id];
+		auto pos = std::lower_bound(list.begin(), list.end(), key);
+		if (pos != list.end() && *pos == key) {
+			list.erase(pos);
+		}
+	};
+
+	// Both lists are sorted by id: walk them together to find the ids that
+	// entered or left this cell.
+	size_t a = 0;
+	size_t b = 0;
+	while (a < old.size() || b < fresh.size()) {
+		if (b == fresh.size() || (a < old.size() && old[a].id < fresh[b].id)) {
+			totals[old[a].id] -= old[a].count;
+			removePosting(old[a].id);
+			++a;
+		} else if (a == old.size() || fresh[b].id < old[a].id) {
+			totals[fresh[b].id] += fresh[b].count;
+			addPosting(fresh[b].id);
+			++b;
+		} else {
+			totals[fresh[b].id] += fresh[b].count;
+			totals[old[a].id] -= old[a].count;
+			++a;
+			++b;
+		}
+	}
+
+	if (record.empty()) {
+		if (it != cells.end()) {
+			cells.erase(it);
+		}
+	} else if (it != cells.end()) {
+		it->second = std::move(record);
+	} else {
+		cells.emplace(key, std::move(record));
+	}
+}
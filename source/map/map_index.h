@@ -0,0 +1,97 @@
+#ifndef RME_MAP_INDEX_H_
+#define RME_MAP_INDEX_H_
+
+#include "app/main.h"
+#include "map/spatial_hash_grid.h"
+#include "map/map_statistics.h"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class BaseMap;
+
+// Inverted index over the map contents, kept per SpatialHashGrid cell.
+//
+// For every server item id it knows how many items exist on the map (ground,
+// stacked and nested inside containers) and which cells hold at least one of
+// them, so "find all of item X" only has to walk those cells. Alongside, each
+// cell carries the TileStatistics of its floors and of its house tiles, summed
+// into per-floor and per-house totals that MapStatisticsCollector reads
+// instead of visiting every tile.
+//
+// Maintenance is lazy: every tile swap (action commit/undo, paste, Lua
+// transactions) marks its cell stale in O(1), and stale cells are recounted on
+// the next query. The first query after a load builds the whole index.
+// Code that edits tiles of the live map in place, bypassing setTile/swapTile,
+// must call markDirty (or invalidate for map-wide edits) itself.
+class MapIndex {
+public:
+	using CellKey = uint64_t;
+
+	struct ItemCount {
+		uint16_t id;
+		uint32_t count;
+	};
+
+	explicit MapIndex(BaseMap& map);
+
+	MapIndex(const MapIndex&) = delete;
+	MapIndex& operator=(const MapIndex&) = delete;
+
+	// Flags the cell containing tile (x, y) for recount. No-op until the index
+	// has been built.
+	void markDirty(int x, int y) {
+		if (!built) {
+			return;
+		}
+		const CellKey key = SpatialHashGrid::cellKeyOf(x, y);
+		if (dirty.empty() || dirty.back() != key) {
+			dirty.push_back(key);
+		}
+	}
+	// Drops everything; the next query rebuilds from scratch.
+	void invalidate();
+
+	// Number of items with this server id on the whole map.
+	uint64_t countOf(uint16_t id);
+	// Sorted keys of the cells holding at least one item with this id.
+	const std::vector<CellKey>& cellsContaining(uint16_t id);
+	// Item counts of one cell, sorted by id (empty for unknown cells).
+	const std::vector<ItemCount>& cellItems(CellKey key);
+
+	// Statistics of the whole map, one entry per floor.
+	const std::array<TileStatistics, MAP_LAYERS>& floorStatistics();
+	// Statistics of the cells overlapping the tile rectangle [min, max]
+	// (inclusive, whole cells), per floor.
+	std::array<TileStatistics, MAP_LAYERS> floorStatisticsIn(int min_x, int min_y, int max_x, int max_y);
+	// Statistics of the tiles of each house, by house id.
+	const std::unordered_map<uint32_t, TileStatistics>& houseStatistics();
+
+	// Everything counted for one grid cell. Floors without tiles are omitted.
+	struct CellRecord {
+		std::vector<ItemCount> items; // sorted by id
+		std::vector<std::pair<uint8_t, TileStatistics>> floors; // sorted by z
+		std::vector<std::pair<uint32_t, TileStatistics>> houses; // house tiles only
+
+		bool empty() const {
+			return items.empty() && floors.empty();
+		}
+	};
+
+private:
+	void refresh();
+	void rebuild();
+	void replaceCell(CellKey key, CellRecord fresh);
+
+	BaseMap& map;
+	bool built = false;
+	std::vector<CellKey> dirty;
+	std::unordered_map<CellKey, CellRecord> cells;
+	std::vector<uint64_t> totals; // indexed by server id
+	std::vector<std::vector<CellKey>> postings; // indexed by server id, sorted
+	std::array<TileStatistics, MAP_LAYERS> floorTotals;
+	std::unordered_map<uint32_t, TileStatistics> houseTotals;
+};
+
+#endif
@@ -235,6 +235,9 @@ std::unique_ptr<Tile> MapNode::setTile(int x, int y, int z, std::unique_ptr<Tile
 	} else if (oldtile && !tmp->tile) {
 		--map.tilecount;
 	}
+	if (tmp->tile || oldtile) {
+		map.onTileReplaced(x, y);
+	}
 
 	return oldtile;
 }
@@ -247,6 +250,7 @@ void MapNode::clearTile(int x, int y, int z) {
 
 	TileLocation* tmp = &f->locs[offset_x * 4 + offset_y];
 	tmp->tile = map.allocator(tmp);
+	map.onTileReplaced(x, y);
 }
 
 //**************** SpatialHashGrid **********************
@@ -4,93 +4,140 @@
 #include "map/tile.h"
 #include "ui/gui.h"
 #include <sstream>
-#include <unordered_map>
 
-MapStatistics MapStatisticsCollector::Collect(Map* map) {
-	MapStatistics stats;
-	int load_counter = 0;
-
-	std::unordered_map<uint32_t, uint32_t> town_sqm_count;
+TileStatistics& TileStatistics::operator+=(const TileStatistics& other) {
+	tile_count += other.tile_count;
+	detailed_tile_count += other.detailed_tile_count;
+	blocking_tile_count += other.blocking_tile_count;
+	walkable_tile_count += other.walkable_tile_count;
+	spawn_count += other.spawn_count;
+	creature_count += other.creature_count;
+	item_count += other.item_count;
+	loose_item_count += other.loose_item_count;
+	depot_count += other.depot_count;
+	action_item_count += other.action_item_count;
+	unique_item_count += other.unique_item_count;
+	container_count += other.container_count;
+	return *this;
+}
 
-	std::ranges::for_each(map->tiles(), [&](auto& tile_location) {
-		Tile* tile = tile_location.get();
-		if (load_counter % 8192 == 0) {
-			g_gui.SetLoadDone(static_cast<unsigned int>(static_cast<int64_t>(load_counter) * 95ll / static_cast<int64_t>(map->getTileCount())));
-		}
+TileStatistics& TileStatistics::operator-=(const TileStatistics& other) {
+	tile_count -= other.tile_count;
+	detailed_tile_count -= other.detailed_tile_count;
+	blocking_tile_count -= other.blocking_tile_count;
+	walkable_tile_count -= other.walkable_tile_count;
+	spawn_count -= other.spawn_count;
+	creature_count -= other.creature_count;
+	item_count -= other.item_count;
+	loose_item_count -= other.loose_item_count;
+	depot_count -= other.depot_count;
+	action_item_count -= other.action_item_count;
+	unique_item_count -= other.unique_item_count;
+	container_count -= other.container_count;
+	return *this;
+}
 
-		if (tile->empty()) {
-			return; // Continue in loop becomes return in lambda
-		}
+void MapStatisticsCollector::AccumulateTile(const Tile* tile, TileStatistics& stats) {
+	if (tile->empty()) {
+		return;
+	}
 
-		stats.tile_count += 1;
+	stats.tile_count += 1;
 
-		bool is_detailed = false;
-		auto analyze_item = [&](Item* item) {
-			stats.item_count += 1;
-			if (!item->isGroundTile() && !item->isBorder()) {
-				is_detailed = true;
-				const auto it = item->getDefinition();
-				if (it.hasFlag(ItemFlag::Moveable)) {
-					stats.loose_item_count += 1;
-				}
-				if (it.isDepot()) {
-					stats.depot_count += 1;
-				}
-				if (item->getActionID() > 0) {
-					stats.action_item_count += 1;
-				}
-				if (item->getUniqueID() > 0) {
-					stats.unique_item_count += 1;
-				}
-				if (Container* c = item->asContainer()) {
-					if (c->getVector().size()) {
-						stats.container_count += 1;
-					}
+	bool is_detailed = false;
+	auto analyze_item = [&](const Item* item) {
+		stats.item_count += 1;
+		if (!item->isGroundTile() && !item->isBorder()) {
+			is_detailed = true;
+			const auto it = item->getDefinition();
+			if (it.hasFlag(ItemFlag::Moveable)) {
+				stats.loose_item_count += 1;
+			}
+			if (it.isDepot()) {
+				stats.depot_count += 1;
+			}
+			if (item->getActionID() > 0) {
+				stats.action_item_count += 1;
+			}
+			if (item->getUniqueID() > 0) {
+				stats.unique_item_count += 1;
+			}
+			if (const Container* c = item->asContainer()) {
+				if (c->getVector().size()) {
+					stats.container_count += 1;
 				}
 			}
-		};
-
-		if (tile->ground) {
-			analyze_item(tile->ground.get());
 		}
+	};
 
-		std::ranges::for_each(tile->items, [&](const auto& item) {
-			analyze_item(item.get());
-		});
+	if (tile->ground) {
+		analyze_item(tile->ground.get());
+	}
 
-		if (tile->spawn) {
-			stats.spawn_count += 1;
-		}
+	std::ranges::for_each(tile->items, [&](const auto& item) {
+		analyze_item(item.get());
+	});
 
-		if (tile->creature) {
-			stats.creature_count += 1;
-		}
+	if (tile->spawn) {
+		stats.spawn_count += 1;
+	}
 
-		if (tile->isBlocking()) {
-			stats.blocking_tile_count += 1;
-		} else {
-			stats.walkable_tile_count += 1;
-		}
+	if (tile->creature) {
+		stats.creature_count += 1;
+	}
 
-		if (is_detailed) {
-			stats.detailed_tile_count += 1;
-		}
+	if (tile->isBlocking()) {
+		stats.blocking_tile_count += 1;
+	} else {
+		stats.walkable_tile_count += 1;
+	}
 
-		load_counter += 1;
-	});
+	if (is_detailed) {
+		stats.detailed_tile_count += 1;
+	}
+}
+
+MapStatistics MapStatisticsCollector::Collect(Map* map) {
+	MapStatistics stats;
+	int load_counter = 0;
+
+	// Tile and item totals come from the per-cell counters of the map index;
+	// only cells edited since the last query are recounted.
+	stats.floors = map->index.floorStatistics();
+	TileStatistics total;
+	for (const TileStatistics& floor : stats.floors) {
+		total += floor;
+	}
+
+	stats.tile_count = total.tile_count;
+	stats.detailed_tile_count = total.detailed_tile_count;
+	stats.blocking_tile_count = total.blocking_tile_count;
+	stats.walkable_tile_count = total.walkable_tile_count;
+	stats.spawn_count = total.spawn_count;
+	stats.creature_count = total.creature_count;
+	stats.item_count = total.item_count;
+	stats.loose_item_count = total.loose_item_count;
+	stats.depot_count = total.depot_count;
+	stats.action_item_count = total.action_item_count;
+	stats.unique_item_count = total.unique_item_count;
+	stats.container_count = total.container_count;
+
+	g_gui.SetLoadDone(95);
 
 	stats.creatures_per_spawn = (stats.spawn_count != 0 ? static_cast<double>(stats.creature_count) / static_cast<double>(stats.spawn_count) : -1.0);
 	stats.percent_pathable = 100.0 * (stats.tile_count != 0 ? static_cast<double>(stats.walkable_tile_count) / static_cast<double>(stats.tile_count) : -1.0);
 	stats.percent_detailed = 100.0 * (stats.tile_count != 0 ? static_cast<double>(stats.detailed_tile_count) / static_cast<double>(stats.tile_count) : -1.0);
 
-	load_counter = 0;
 	stats.town_count = map->towns.count();
 	stats.house_count = map->houses.count();
 
+	std::map<uint32_t, TownStatistics> per_town;
+
+	const auto& house_tiles = map->index.houseStatistics();
 	Houses& houses = map->houses;
 	for (const auto& [house_id, house] : houses) {
 
-		if (load_counter % 64) {
+		if (load_counter % 64 == 0) {
 			g_gui.SetLoadDone(static_cast<unsigned int>(95ll + static_cast<int64_t>(load_counter) * 5ll / static_cast<int64_t>(stats.house_count)));
 		}
 
@@ -99,7 +146,15 @@ MapStatistics MapStatisticsCollector::Collect(Map* map) {
 			stats.largest_house_size = house->size();
 		}
 		stats.total_house_sqm += house->size();
-		town_sqm_count[house->townid] += house->size();
+		TownStatistics& town_stats = per_town[house->townid];
+		town_stats.town_id = house->townid;
+		town_stats.house_count += 1;
+		town_stats.house_sqm += house->size();
+
+		if (auto tiles = house_tiles.find(house_id); tiles != house_tiles.end()) {
+			town_stats.tile_count += tiles->second.tile_count;
+			town_stats.item_count += tiles->second.item_count;
+		}
 		load_counter++;
 	}
 
@@ -108,12 +163,14 @@ MapStatistics MapStatisticsCollector::Collect(Map* map) {
 	stats.sqm_per_town = (stats.town_count != 0 ? static_cast<double>(stats.total_house_sqm) / static_cast<double>(stats.town_count) : -1.0);
 
 	Towns& towns = map->towns;
-	for (const auto& [town_id, town_sqm] : town_sqm_count) {
+	for (auto& [town_id, town_stats] : per_town) {
 		Town* town = towns.getTown(town_id);
-		if (town && town_sqm > stats.largest_town_size) {
+		town_stats.town = town;
+		if (town && town_stats.house_sqm > stats.largest_town_size) {
 			stats.largest_town = town;
-			stats.largest_town_size = town_sqm;
+			stats.largest_town_size = town_stats.house_sqm;
 		}
+		stats.towns.push_back(town_stats);
 	}
 
 	return stats;
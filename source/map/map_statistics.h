@@ -2,12 +2,50 @@
 #define RME_MAP_STATISTICS_H_
 
 #include "app/main.h"
+#include <array>
 #include <string>
 #include <map>
+#include <vector>
 
 class Map;
 class Town;
 class House;
+class Tile;
+
+// Tile and item totals of one region (a grid cell, a floor or the whole map).
+// MapIndex keeps one per floor of every grid cell and the running sums, so
+// these never have to be recounted from scratch.
+struct TileStatistics {
+	uint64_t tile_count = 0;
+	uint64_t detailed_tile_count = 0;
+	uint64_t blocking_tile_count = 0;
+	uint64_t walkable_tile_count = 0;
+	uint64_t spawn_count = 0;
+	uint64_t creature_count = 0;
+
+	uint64_t item_count = 0;
+	uint64_t loose_item_count = 0;
+	uint64_t depot_count = 0;
+	uint64_t action_item_count = 0;
+	uint64_t unique_item_count = 0;
+	uint64_t container_count = 0;
+
+	TileStatistics& operator+=(const TileStatistics& other);
+	TileStatistics& operator-=(const TileStatistics& other);
+	bool empty() const {
+		return tile_count == 0;
+	}
+};
+
+struct TownStatistics {
+	const Town* town = nullptr;
+	uint32_t town_id = 0;
+	int house_count = 0;
+	uint64_t house_sqm = 0;
+	// Totals over the tiles of the town's houses, by the house id on the tiles
+	uint64_t tile_count = 0;
+	uint64_t item_count = 0;
+};
 
 struct MapStatistics {
 	uint64_t tile_count = 0;
@@ -37,11 +75,19 @@ struct MapStatistics {
 	double houses_per_town = 0.0;
 	double sqm_per_house = 0.0;
 	double sqm_per_town = 0.0;
+
+	// Breakdowns, summed from the same per-cell counters as the totals above.
+	std::array<TileStatistics, MAP_LAYERS> floors;
+	std::vector<TownStatistics> towns; // sorted by town id
 };
 
 class MapStatisticsCollector {
 public:
 	static MapStatistics Collect(Map* map);
+
+	// Adds one tile to a running total. This is the single definition of what
+	// the statistics count, used by MapIndex when it recounts a grid cell.
+	static void AccumulateTile(const Tile* tile, TileStatistics& stats);
 };
 
 #endif
@@ -63,6 +63,16 @@ public:
 		return cells_.size();
 	}
 
+	// Key of the cell containing tile (x, y); the same key getSortedCells reports.
+	[[nodiscard]] static uint64_t cellKeyOf(int x, int y) {
+		return makeKey(x, y);
+	}
+	// Cell lookup by key, nullptr when the cell was never allocated.
+	[[nodiscard]] const GridCell* findCell(uint64_t key) const {
+		const size_t idx = findCellIndex(key);
+		return idx < cells_.size() ? cells_[idx].cell.get() : nullptr;
+	}
+
 	template <typename Func>
 	void visitLeaves(int min_x, int min_y, int max_x, int max_y, Func&& func) {
 		if (max_x <= min_x || max_y <= min_y) {
@@ -41,6 +41,7 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <utility>
 
 namespace {
 	bool itemsMatch(const Item* lhs, const Item* rhs) {
@@ -84,7 +85,8 @@ Tile::Tile(int x, int y, int z) :
 	instanceZoneId(0),
 	mapflags(0),
 	statflags(0),
-	minimapColor(INVALID_MINIMAP_COLOR) {
+	minimapColor(INVALID_MINIMAP_COLOR),
+	borderSignature(0) {
 	ownedLocation->setPosition(Position(x, y, z));
 	location = ownedLocation;
 }
@@ -98,7 +100,8 @@ Tile::Tile(TileLocation& loc) :
 	instanceZoneId(0),
 	mapflags(0),
 	statflags(0),
-	minimapColor(INVALID_MINIMAP_COLOR) {
+	minimapColor(INVALID_MINIMAP_COLOR),
+	borderSignature(0) {
 	////
 }
 
@@ -194,6 +197,7 @@ std::unique_ptr<Tile> Tile::deepCopy() const {
 	copy->mapflags = mapflags;
 	copy->statflags = statflags;
 	copy->minimapColor = minimapColor;
+	copy->borderSignature = borderSignature;
 	if (invalidZones) {
 		copy->invalidZones = std::make_unique<InvalidZoneState>(*invalidZones);
 	}
@@ -333,6 +337,16 @@ Item* Tile::getItemAt(int index) const {
 	return nullptr;
 }
 
+Item* Tile::getTopItem() {
+	items.unshare();
+	return std::as_const(*this).getTopItem();
+}
+
+Item* Tile::getItemAt(int index) {
+	items.unshare();
+	return std::as_const(*this).getItemAt(index);
+}
+
 void Tile::setGround(std::unique_ptr<Item> item) {
 	if (!item) {
 		ground.reset();
@@ -476,6 +490,21 @@ Item* Tile::getTable() const {
 	return (it != items.end()) ? it->get() : nullptr;
 }
 
+Item* Tile::getWall() {
+	items.unshare();
+	return std::as_const(*this).getWall();
+}
+
+Item* Tile::getCarpet() {
+	items.unshare();
+	return std::as_const(*this).getCarpet();
+}
+
+Item* Tile::getTable() {
+	items.unshare();
+	return std::as_const(*this).getTable();
+}
+
 void Tile::setHouse(House* _house) {
 	house_id = (_house ? _house->getID() : 0);
 }
@@ -489,10 +518,60 @@ bool Tile::isTownExit(Map& map) const {
 	return loc && loc->getTownCount() > 0;
 }
 
+uint32_t Tile::contentHash() const {
+	// FNV-1a over the fields isContentEqual compares first; collisions only
+	// cost a full comparison.
+	uint32_t hash = 2166136261u;
+	auto mix = [&hash](uint32_t value) {
+		hash = (hash ^ value) * 16777619u;
+	};
+	mix(mapflags);
+	mix(statflags & TILESTATE_OP_BORDER);
+	mix(house_id);
+	mix(soundZoneId);
+	mix(instanceZoneId);
+	mix((creature ? 1u : 0u) | (spawn ? 2u : 0u) | (invalidZones ? 4u : 0u));
+	if (ground) {
+		mix((uint32_t(ground->getID()) << 16) | ground->getSubtype());
+	}
+	mix(static_cast<uint32_t>(items.size()));
+	for (const auto& item : items) {
+		mix((uint32_t(item->getID()) << 16) | item->getSubtype());
+	}
+	return hash;
+}
+
 bool Tile::isContentEqual(const Tile* other) const {
 	if (!other) {
 		return false;
 	}
+	if (this == other) {
+		return true;
+	}
+
+	if (mapflags != other->mapflags || house_id != other->house_id) {
+		return false;
+	}
+	// The optional border is map content: it is saved and drives border drawing
+	if ((statflags & TILESTATE_OP_BORDER) != (other->statflags & TILESTATE_OP_BORDER)) {
+		return false;
+	}
+	if (soundZoneId != other->soundZoneId || instanceZoneId != other->instanceZoneId) {
+		return false;
+	}
+
+	if (static_cast<bool>(creature) != static_cast<bool>(other->creature)) {
+		return false;
+	}
+	if (creature && (creature->getName() != other->creature->getName() || creature->getDirection() != other->creature->getDirection() || creature->getSpawnTime() != other->creature->getSpawnTime())) {
+		return false;
+	}
+	if (static_cast<bool>(spawn) != static_cast<bool>(other->spawn)) {
+		return false;
+	}
+	if (spawn && spawn->getSize() != other->spawn->getSize()) {
+		return false;
+	}
 
 	if (static_cast<bool>(invalidZones) != static_cast<bool>(other->invalidZones)) {
 		return false;
@@ -20,6 +20,7 @@
 
 #include "map/position.h"
 #include "game/item.h"
+#include "map/item_list.h"
 #include "io/otbm/invalid_otbm_content.h"
 
 namespace TileOperations {
@@ -70,7 +71,7 @@ public: // Members
 	TileLocation* location;
 	TileLocation* ownedLocation;
 	std::unique_ptr<Item> ground;
-	std::vector<std::unique_ptr<Item>> items;
+	ItemList items; // May be shared with other tiles, see ItemList
 	std::unique_ptr<Creature> creature;
 	std::unique_ptr<Spawn> spawn;
 	uint32_t house_id; // House id for this tile (pointer not safe)
@@ -79,6 +80,8 @@ public: // Members
 	uint32_t mapflags;
 	uint16_t statflags;
 	uint8_t minimapColor;
+	// Inputs and result of the last ground border pass, 0 = unknown (see GroundBorderCalculator)
+	uint32_t borderSignature;
 	std::unique_ptr<InvalidZoneState> invalidZones;
 
 public:
@@ -111,8 +114,13 @@ public:
 	int getZ() const;
 
 public: // Functions
-	// Compare the content (ground and items) of two tiles
+	// Compare the content of two tiles: ground, items, creature, spawn, house,
+	// map flags, the optional border flag and zones. The other state flags
+	// (selection, modification, cached item properties) are ignored.
 	bool isContentEqual(const Tile* other) const;
+	// Hash of the cheap-to-read content; tiles with different hashes are never
+	// content-equal.
+	uint32_t contentHash() const;
 
 	// Has tile been modified since the map was loaded/created?
 	bool isModified() const {
@@ -151,8 +159,12 @@ public: // Functions
 	bool hasProperty(enum ITEMPROPERTY prop) const;
 
 	int getIndexOf(Item* item) const;
+	// The non-const item getters unshare the item list first, so the item
+	// returned can be modified
 	Item* getTopItem() const; // Returns the topmost item, or nullptr if the tile is empty
+	Item* getTopItem();
 	Item* getItemAt(int index) const;
+	Item* getItemAt(int index);
 	void setGround(std::unique_ptr<Item> item);
 	void addItem(std::unique_ptr<Item> item);
 	InvalidZoneState& getOrCreateInvalidZones();
@@ -193,11 +205,13 @@ public: // Functions
 		return testFlags(statflags, TILESTATE_HAS_TABLE);
 	}
 	Item* getTable() const;
+	Item* getTable();
 
 	bool hasCarpet() const {
 		return testFlags(statflags, TILESTATE_HAS_CARPET);
 	}
 	Item* getCarpet() const;
+	Item* getCarpet();
 
 	bool hasHookSouth() const {
 		return testFlags(statflags, TILESTATE_HOOK_SOUTH);
@@ -224,6 +238,7 @@ public: // Functions
 
 	// Get the (first) wall of this tile
 	Item* getWall() const;
+	Item* getWall();
 	bool hasWall() const;
 
 	// Has to do with houses
@@ -23,6 +23,7 @@
 #include <functional>
 #include <ranges>
 #include <queue>
+#include <utility>
 
 namespace TileOperations {
 
@@ -36,6 +37,30 @@ namespace TileOperations {
 			items.erase(first_to_remove, items.end());
 		}
 
+		std::unique_ptr<Tile> copyAllButItems(const Tile* tile, TileLocation* dest_location, BaseMap& map) {
+			std::unique_ptr<Tile> copy(map.allocator.allocateTile(dest_location));
+			copy->mapflags = tile->mapflags;
+			copy->statflags = tile->statflags;
+			copy->minimapColor = tile->minimapColor;
+			copy->borderSignature = tile->borderSignature;
+			copy->house_id = tile->house_id;
+			copy->soundZoneId = tile->soundZoneId; // BlackTalon: keep the sound zone on tile copies
+			if (tile->invalidZones) {
+				copy->invalidZones = std::make_unique<InvalidZoneState>(*tile->invalidZones);
+			}
+			if (tile->spawn) {
+				copy->spawn = tile->spawn->deepCopy();
+			}
+			if (tile->creature) {
+				copy->creature = tile->creature->deepCopy();
+			}
+			// Spawncount & exits are not transferred on copy!
+			if (tile->ground) {
+				copy->ground = tile->ground->deepCopy();
+			}
+			return copy;
+		}
+
 		void UpdateItemFlags(const Item* i, uint16_t& statflags, uint8_t& minimapColor) {
 			if (i->isSelected()) {
 				statflags |= TILESTATE_SELECTED;
@@ -132,26 +157,11 @@ namespace TileOperations {
 		if (!dest_location) {
 			dest_location = map.createTileL(tile->getX(), tile->getY(), tile->getZ());
 		}
-		std::unique_ptr<Tile> copy(map.allocator.allocateTile(dest_location));
-		copy->mapflags = tile->mapflags;
-		copy->statflags = tile->statflags;
-		copy->minimapColor = tile->minimapColor;
-		copy->house_id = tile->house_id;
-		copy->soundZoneId = tile->soundZoneId; // BlackTalon: keep the sound zone on tile copies
-		if (tile->invalidZones) {
-			copy->invalidZones = std::make_unique<InvalidZoneState>(*tile->invalidZones);
-		}
-		if (tile->spawn) {
-			copy->spawn = tile->spawn->deepCopy();
-		}
-		if (tile->creature) {
-			copy->creature = tile->creature->deepCopy();
-		}
-		// Spawncount & exits are not transferred on copy!
-		if (tile->ground) {
-			copy->ground = tile->ground->deepCopy();
-		}
+		return deepCopy(tile, dest_location, map);
+	}
 
+	std::unique_ptr<Tile> deepCopy(const Tile* tile, TileLocation* dest_location, BaseMap& map) {
+		std::unique_ptr<Tile> copy = copyAllButItems(tile, dest_location, map);
 		copy->items.reserve(tile->items.size());
 		std::ranges::transform(tile->items, std::back_inserter(copy->items), [](const auto& item) {
 			return item->deepCopy();
@@ -160,6 +170,12 @@ namespace TileOperations {
 		return copy;
 	}
 
+	std::unique_ptr<Tile> sharedCopy(Tile* tile, TileLocation* dest_location, BaseMap& map) {
+		std::unique_ptr<Tile> copy = copyAllButItems(tile, dest_location, map);
+		copy->items.share(tile->items);
+		return copy;
+	}
+
 	void merge(Tile* dest, Tile* src) {
 		if (src->isPZ()) {
 			dest->setPZ(true);
@@ -501,7 +517,8 @@ namespace TileOperations {
 			}
 		}
 
-		std::ranges::for_each(tile->items, [&](const auto& i) {
+		// Read only, so a shared item list stays shared
+		std::ranges::for_each(std::as_const(tile->items), [&](const auto& i) {
 			UpdateItemFlags(i.get(), tile->statflags, discardedColor);
 		});
 
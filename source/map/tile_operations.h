@@ -10,6 +10,7 @@
 #include <vector>
 
 class Tile;
+class TileLocation;
 class BaseMap;
 class WallBrush;
 class CarpetBrush;
@@ -34,6 +35,13 @@ namespace TileOperations {
 
 	// Moved from Tile class
 	std::unique_ptr<Tile> deepCopy(const Tile* tile, BaseMap& map);
+	// Same, for a destination location the caller already holds. Does not touch
+	// the map's tile lookup, so it can run on worker threads.
+	std::unique_ptr<Tile> deepCopy(const Tile* tile, TileLocation* dest_location, BaseMap& map);
+	// Like deepCopy, but the copy shares the item list of tile until either of
+	// them writes to it (see ItemList). For sources that are not edited in
+	// place while the copies live, like the copy buffer.
+	std::unique_ptr<Tile> sharedCopy(Tile* tile, TileLocation* dest_location, BaseMap& map);
 	void merge(Tile* dest, Tile* src);
 	Item* transformItem(Item* old_item, uint16_t new_id, Tile* parent = nullptr);
 
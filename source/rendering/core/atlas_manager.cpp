@@ -1,24 +1,37 @@
 #include "rendering/core/atlas_manager.h"
+#include "rendering/core/image.h"
+#include "app/settings.h"
 #include <iostream>
 #include <algorithm>
+#include <utility>
 #include <spdlog/spdlog.h>
 
+namespace {
+	// Each layer is 4096x4096 RGBA8
+	constexpr int LAYER_MEGABYTES = TextureAtlas::ATLAS_SIZE * TextureAtlas::ATLAS_SIZE * 4 / (1024 * 1024);
+	// Candidates compared per eviction; the oldest of them is reclaimed
+	constexpr int EVICTION_SAMPLE = 32;
+}
+
 bool AtlasManager::ensureInitialized() {
 	if (atlas_.isValid()) {
 		return true;
 	}
 
-	// Pre-allocate 16 layers (16 * 16384 = 262K sprites capacity).
+	budget_layers_ = std::clamp(g_settings.getInteger(Config::ATLAS_VRAM_BUDGET) / LAYER_MEGABYTES, 2, TextureAtlas::MAX_LAYERS);
+
+	// Pre-allocate up to 16 layers (16 * 16384 = 262K sprites capacity).
 	// This fits in ~1GB VRAM and covers older clients/smaller Tibia 10+ datasets.
-	// Larger datasets will dynamically expand this via addLayer().
-	static constexpr int INITIAL_LAYERS = 16;
+	// Larger datasets will dynamically expand this via addLayer() until the budget is reached.
+	const int initial_layers = std::min(16, budget_layers_);
 
-	if (!atlas_.initialize(INITIAL_LAYERS)) {
+	atlas_.setGrowthLimit(budget_layers_);
+	if (!atlas_.initialize(initial_layers)) {
 		spdlog::error("AtlasManager: Failed to initialize texture array");
 		return false;
 	}
 
-	spdlog::info("AtlasManager: Texture array initialized ({}x{}, {} initial layers)", TextureAtlas::ATLAS_SIZE, TextureAtlas::ATLAS_SIZE, INITIAL_LAYERS);
+	spdlog::info("AtlasManager: Texture array initialized ({}x{}, {} initial layers, budget {} layers / {} MB)", TextureAtlas::ATLAS_SIZE, TextureAtlas::ATLAS_SIZE, initial_layers, budget_layers_, budget_layers_ * LAYER_MEGABYTES);
 
 	// Ensure white pixel exists (ID AtlasRegion::INVALID_SENTINEL)
 	std::vector<uint8_t> white_data(32 * 32 * 4, 255);
@@ -32,16 +45,10 @@ bool AtlasManager::ensureInitialized() {
 	return true;
 }
 
-const AtlasRegion* AtlasManager::addSprite(uint32_t sprite_id, const uint8_t* rgba_data) {
-	// Fast check via direct lookup for common sprites
-	if (sprite_id < DIRECT_LOOKUP_SIZE && direct_lookup_[sprite_id] != nullptr) {
-		return direct_lookup_[sprite_id];
-	}
-
-	// Check hash map for already-added sprites
-	auto it = sprite_regions_.find(sprite_id);
-	if (it != sprite_regions_.end()) {
-		return it->second;
+const AtlasRegion* AtlasManager::addSprite(uint32_t sprite_id, const uint8_t* rgba_data, Image* owner) {
+	// Fast check for already-added sprites
+	if (const AtlasRegion* existing = getRegion(sprite_id)) {
+		return existing;
 	}
 
 	if (!rgba_data) {
@@ -53,6 +60,14 @@ const AtlasRegion* AtlasManager::addSprite(uint32_t sprite_id, const uint8_t* rg
 		return nullptr;
 	}
 
+	// At the budget: reuse the least recently drawn slot instead of adding a layer
+	if (!atlas_.hasFreeSlot() && atlas_.getLayerCount() >= budget_layers_) {
+		if (!evictLeastRecentlyUsed() && !over_budget_logged_) {
+			spdlog::warn("AtlasManager: Every resident sprite was drawn this frame, growing past the {} MB budget", budget_layers_ * LAYER_MEGABYTES);
+			over_budget_logged_ = true;
+		}
+	}
+
 	// Add to texture array
 	auto region = atlas_.addSprite(rgba_data);
 	if (!region.has_value()) {
@@ -60,20 +75,22 @@ const AtlasRegion* AtlasManager::addSprite(uint32_t sprite_id, const uint8_t* rg
 		return nullptr;
 	}
 
-	// Store in stable deque
-	region_storage_.push_back(*region);
-	AtlasRegion* ptr = &region_storage_.back();
-
-	// Store pointer in hash map
-	ptr->debug_sprite_id = sprite_id;
-	sprite_regions_.emplace(sprite_id, ptr);
-
-	// Also store in direct lookup for O(1) access
-	if (sprite_id < DIRECT_LOOKUP_SIZE) {
-		direct_lookup_[sprite_id] = ptr;
+	const size_t index = TextureAtlas::slotIndex(*region);
+	if (index >= slots_.size()) {
+		slots_.resize(index + 1);
 	}
 
-	return ptr;
+	Slot& slot = slots_[index];
+	slot.region = *region;
+	slot.region.debug_sprite_id = sprite_id;
+	slot.region.last_used_frame = frame_;
+	slot.owner = owner;
+	slot.occupied = true;
+	++resident_count_;
+	++uploads_;
+
+	setMapping(sprite_id, &slot.region);
+	return &slot.region;
 }
 
 void AtlasManager::removeSprite(uint32_t sprite_id) {
@@ -81,13 +98,89 @@ void AtlasManager::removeSprite(uint32_t sprite_id) {
 		white_pixel_cache_ = nullptr;
 	}
 
-	AtlasRegion* region = nullptr;
+	AtlasRegion* region = takeMapping(sprite_id);
+	if (region) {
+		releaseSlot(slots_[TextureAtlas::slotIndex(*region)]);
+	}
+}
+
+void AtlasManager::releaseSlot(Slot& slot) {
+	if (!slot.occupied) {
+		return;
+	}
+
+	// 1. Free the slot in the texture array (requires valid UVs)
+	atlas_.freeSlot(slot.region);
+
+	// 2. MARK AS INVALID to trigger Self-Healing in stale GameSprites
+	// This prevents "Double Allocation" visual bugs where a stale sprite references
+	// this region object after the slot has been reused for a new sprite.
+	slot.region.debug_sprite_id = AtlasRegion::INVALID_SENTINEL;
+	slot.region.atlas_index = AtlasRegion::INVALID_SENTINEL;
+	slot.owner = nullptr;
+	slot.occupied = false;
+	--resident_count_;
+}
+
+bool AtlasManager::evictLeastRecentlyUsed() {
+	if (slots_.empty()) {
+		return false;
+	}
+
+	// Clock sweep: look at slots in order from the hand and take the oldest of
+	// the first EVICTION_SAMPLE candidates, so a call costs a bounded scan while
+	// the hand still visits every slot over time.
+	Slot* victim = nullptr;
+	size_t victim_index = 0;
+	int candidates = 0;
+	for (size_t scanned = 0; scanned < slots_.size() && candidates < EVICTION_SAMPLE; ++scanned) {
+		const size_t index = (clock_hand_ + scanned) % slots_.size();
+		Slot& slot = slots_[index];
+		if (!slot.occupied || !slot.owner || slot.region.last_used_frame >= frame_) {
+			continue;
+		}
+		++candidates;
+		if (!victim || slot.region.last_used_frame < victim->region.last_used_frame) {
+			victim = &slot;
+			victim_index = index;
+		}
+	}
+
+	if (!victim) {
+		return false;
+	}
+	clock_hand_ = (victim_index + 1) % slots_.size();
+
+	// The owner is only told when the mapping still points here; a slot left
+	// behind by clearMapping() belongs to nobody anymore.
+	const uint32_t sprite_id = victim->region.debug_sprite_id;
+	if (getRegion(sprite_id) == &victim->region) {
+		takeMapping(sprite_id);
+		victim->owner->onAtlasEvicted();
+	}
+	releaseSlot(*victim);
+	++evictions_;
+	return true;
+}
 
+void AtlasManager::setMapping(uint32_t sprite_id, AtlasRegion* region) {
 	if (sprite_id < DIRECT_LOOKUP_SIZE) {
-		if (direct_lookup_[sprite_id] != nullptr) {
-			region = direct_lookup_[sprite_id];
-			direct_lookup_[sprite_id] = nullptr;
-			sprite_regions_.erase(sprite_id);
+		auto& page = lookup_pages_[sprite_id >> PAGE_SHIFT];
+		if (!page) {
+			page = std::make_unique<LookupPage>();
+		}
+		(*page)[sprite_id & PAGE_MASK] = region;
+	} else {
+		sprite_regions_[sprite_id] = region;
+	}
+}
+
+AtlasRegion* AtlasManager::takeMapping(uint32_t sprite_id) {
+	AtlasRegion* region = nullptr;
+	if (sprite_id < DIRECT_LOOKUP_SIZE) {
+		auto& page = lookup_pages_[sprite_id >> PAGE_SHIFT];
+		if (page) {
+			region = std::exchange((*page)[sprite_id & PAGE_MASK], nullptr);
 		}
 	} else {
 		auto it = sprite_regions_.find(sprite_id);
@@ -96,17 +189,7 @@ void AtlasManager::removeSprite(uint32_t sprite_id) {
 			sprite_regions_.erase(it);
 		}
 	}
-
-	if (region) {
-		// 1. Free the slot in the texture array (requires valid UVs)
-		atlas_.freeSlot(*region);
-
-		// 2. MARK AS INVALID to trigger Self-Healing in stale GameSprites
-		// This prevents "Double Allocation" visual bugs where a stale sprite references
-		// this region object after the slot has been reused for a new sprite.
-		region->debug_sprite_id = AtlasRegion::INVALID_SENTINEL;
-		region->atlas_index = AtlasRegion::INVALID_SENTINEL;
-	}
+	return region;
 }
 
 void AtlasManager::clearMapping(uint32_t sprite_id) {
@@ -114,28 +197,31 @@ void AtlasManager::clearMapping(uint32_t sprite_id) {
 		white_pixel_cache_ = nullptr;
 	}
 
-	if (sprite_id < DIRECT_LOOKUP_SIZE) {
-		direct_lookup_[sprite_id] = nullptr;
-	}
-	sprite_regions_.erase(sprite_id);
+	takeMapping(sprite_id);
 }
 
 const AtlasRegion* AtlasManager::getWhitePixel() const {
 	if (white_pixel_cache_) {
 		return white_pixel_cache_;
 	}
-	if (sprite_regions_.count(WHITE_PIXEL_ID)) {
-		return sprite_regions_.at(WHITE_PIXEL_ID);
-	}
 	// Should have been initialized in ensureInitialized()
-	return nullptr;
+	return getRegion(WHITE_PIXEL_ID);
 }
 
 bool AtlasManager::hasSprite(uint32_t sprite_id) const {
-	if (sprite_id < DIRECT_LOOKUP_SIZE) {
-		return direct_lookup_[sprite_id] != nullptr;
-	}
-	return sprite_regions_.contains(sprite_id);
+	return getRegion(sprite_id) != nullptr;
+}
+
+AtlasManager::Stats AtlasManager::getStats() const {
+	Stats stats;
+	stats.resident_sprites = resident_count_;
+	stats.capacity = static_cast<size_t>(budget_layers_) * TextureAtlas::SPRITES_PER_LAYER;
+	stats.layers = atlas_.getLayerCount();
+	stats.budget_layers = budget_layers_;
+	stats.uploads = uploads_;
+	stats.evictions = evictions_;
+	stats.frame = frame_;
+	return stats;
 }
 
 void AtlasManager::bind(uint32_t slot) const {
@@ -148,9 +234,14 @@ GLuint AtlasManager::getTextureId() const {
 
 void AtlasManager::clear() {
 	atlas_.release();
-	region_storage_.clear();
+	slots_.clear();
+	resident_count_ = 0;
+	clock_hand_ = 0;
 	sprite_regions_.clear();
-	std::fill(direct_lookup_.begin(), direct_lookup_.end(), nullptr);
+	for (auto& page : lookup_pages_) {
+		page.reset();
+	}
 	white_pixel_cache_ = nullptr;
-	spdlog::info("AtlasManager cleared");
+	over_budget_logged_ = false;
+	spdlog::info("AtlasManager cleared (uploads={}, evictions={})", uploads_, evictions_);
 }
@@ -2,25 +2,48 @@
 #define RME_RENDERING_CORE_ATLAS_MANAGER_H_
 
 #include "rendering/core/texture_atlas.h"
+#include <array>
 #include <cstdint>
 #include <deque>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
+class Image;
+
 /**
  * AtlasManager manages sprite registration and provides O(1) lookup.
  *
  * Uses a single TextureAtlas for all sprites.
  * Sprites are stored by sprite_id for fast lookup during rendering.
  *
+ * Residency: the atlas is kept within a VRAM budget (Config::ATLAS_VRAM_BUDGET,
+ * in MB, rounded to whole layers). Every draw stamps the region with the
+ * current frame; once the budget is reached, new sprites take the slot of the
+ * least recently drawn one (clock sweep over the slots) and its owning Image is
+ * told to drop its region. Sprites drawn in the current frame and sprites
+ * without an owner (white pixel) are never evicted; if nothing can be evicted
+ * the atlas grows past the budget instead of failing.
+ *
  * Based on imgui_renderer_example_readonly reference implementation.
  */
 class AtlasManager {
 public:
-	// Max sprite ID for O(1) direct lookup
+	// Sprite IDs below this are looked up through on-demand pages, the rest
+	// (template images, white pixel) through a hash map.
 	static constexpr uint32_t DIRECT_LOOKUP_SIZE = 2000000; // Support 10.x+ sprite counts
 	static constexpr uint32_t WHITE_PIXEL_ID = 0xFFFFFFFF;
 
+	struct Stats {
+		size_t resident_sprites = 0;
+		size_t capacity = 0; // Slots available within the budget
+		int layers = 0;
+		int budget_layers = 0;
+		uint64_t uploads = 0;
+		uint64_t evictions = 0;
+		uint32_t frame = 0;
+	};
+
 	AtlasManager() = default;
 	~AtlasManager() = default;
 
@@ -32,9 +55,11 @@ public:
 	 * Add a sprite to the atlas.
 	 * @param sprite_id Unique sprite ID for later lookup
 	 * @param rgba_data 32x32x4 bytes of RGBA pixel data
+	 * @param owner Image notified through onAtlasEvicted() when the slot is
+	 *        reclaimed; sprites without an owner are pinned
 	 * @return Pointer to the region info, or nullptr on failure
 	 */
-	const AtlasRegion* addSprite(uint32_t sprite_id, const uint8_t* rgba_data);
+	const AtlasRegion* addSprite(uint32_t sprite_id, const uint8_t* rgba_data, Image* owner = nullptr);
 
 	/**
 	 * Remove a sprite from the atlas, freeing its slot for reuse.
@@ -55,7 +80,8 @@ public:
 	 */
 	inline const AtlasRegion* getRegion(uint32_t sprite_id) const {
 		if (sprite_id < DIRECT_LOOKUP_SIZE) {
-			return direct_lookup_[sprite_id];
+			const auto& page = lookup_pages_[sprite_id >> PAGE_SHIFT];
+			return page ? (*page)[sprite_id & PAGE_MASK] : nullptr;
 		}
 		auto it = sprite_regions_.find(sprite_id);
 		return it != sprite_regions_.end() ? it->second : nullptr;
@@ -98,17 +124,59 @@ public:
 	 */
 	bool ensureInitialized();
 
+	/**
+	 * Start a new frame. Regions drawn from now on are stamped with it, and
+	 * the uploads staged during the previous frame are fenced.
+	 */
+	void beginFrame() {
+		++frame_;
+		atlas_.fenceUploads();
+	}
+
+	uint32_t currentFrame() const {
+		return frame_;
+	}
+
+	Stats getStats() const;
+
 private:
+	static constexpr uint32_t PAGE_SHIFT = 12;
+	static constexpr uint32_t PAGE_SIZE = 1u << PAGE_SHIFT;
+	static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+	static constexpr uint32_t PAGE_COUNT = (DIRECT_LOOKUP_SIZE + PAGE_SIZE - 1) >> PAGE_SHIFT;
+	using LookupPage = std::array<AtlasRegion*, PAGE_SIZE>;
+
+	// One entry per atlas slot; the region object is reused by whichever
+	// sprite occupies the slot, so stale holders see a foreign debug_sprite_id.
+	struct Slot {
+		AtlasRegion region;
+		Image* owner = nullptr;
+		bool occupied = false;
+	};
+
+	void setMapping(uint32_t sprite_id, AtlasRegion* region);
+	AtlasRegion* takeMapping(uint32_t sprite_id);
+	void releaseSlot(Slot& slot);
+	bool evictLeastRecentlyUsed();
+
 	TextureAtlas atlas_;
 
-	// Stable storage for AtlasRegions (deque doesn't invalidate pointers)
-	std::deque<AtlasRegion> region_storage_;
+	// Indexed by TextureAtlas::slotIndex (deque doesn't invalidate pointers)
+	std::deque<Slot> slots_;
+	size_t resident_count_ = 0;
+	size_t clock_hand_ = 0;
 
-	// Map from sprite_id to AtlasRegion pointer
+	// Map from sprite_id to AtlasRegion pointer, for IDs >= DIRECT_LOOKUP_SIZE
 	std::unordered_map<uint32_t, AtlasRegion*> sprite_regions_;
 
-	// O(1) direct lookup for sprite IDs < DIRECT_LOOKUP_SIZE
-	std::vector<AtlasRegion*> direct_lookup_ { DIRECT_LOOKUP_SIZE, nullptr };
+	// Two-level lookup for sprite IDs < DIRECT_LOOKUP_SIZE, pages allocated on first use
+	std::vector<std::unique_ptr<LookupPage>> lookup_pages_ = std::vector<std::unique_ptr<LookupPage>>(PAGE_COUNT);
+
+	int budget_layers_ = TextureAtlas::MAX_LAYERS;
+	bool over_budget_logged_ = false;
+	uint32_t frame_ = 1;
+	uint64_t uploads_ = 0;
+	uint64_t evictions_ = 0;
 
 	// Cache for white pixel region to avoid hash map lookup
 	const AtlasRegion* white_pixel_cache_ = nullptr;
@@ -88,31 +88,7 @@ void GameSprite::invalidateCache(const AtlasRegion* region) {
 }
 
 void GameSprite::ColorizeTemplatePixels(uint8_t* dest, const uint8_t* mask, size_t pixelCount, int lookHead, int lookBody, int lookLegs, int lookFeet, bool destHasAlpha) {
-	const int dest_step = destHasAlpha ? RGBA_COMPONENTS : RGB_COMPONENTS;
-	const int mask_step = RGB_COMPONENTS;
-
-	std::span<uint8_t> destSpan(dest, pixelCount * dest_step);
-	std::span<const uint8_t> maskSpan(mask, pixelCount * mask_step);
-
-	for (size_t i : std::views::iota(0u, pixelCount)) {
-		uint8_t& red = destSpan[i * dest_step + 0];
-		uint8_t& green = destSpan[i * dest_step + 1];
-		uint8_t& blue = destSpan[i * dest_step + 2];
-
-		const uint8_t& tred = maskSpan[i * mask_step + 0];
-		const uint8_t& tgreen = maskSpan[i * mask_step + 1];
-		const uint8_t& tblue = maskSpan[i * mask_step + 2];
-
-		if (tred && tgreen && !tblue) { // yellow => head
-			OutfitColorizer::ColorizePixel(lookHead, red, green, blue);
-		} else if (tred && !tgreen && !tblue) { // red => body
-			OutfitColorizer::ColorizePixel(lookBody, red, green, blue);
-		} else if (!tred && tgreen && !tblue) { // green => legs
-			OutfitColorizer::ColorizePixel(lookLegs, red, green, blue);
-		} else if (!tred && !tgreen && tblue) { // blue => feet
-			OutfitColorizer::ColorizePixel(lookFeet, red, green, blue);
-		}
-	}
+	OutfitColorizer::ColorizeTemplate(dest, mask, pixelCount, static_cast<uint8_t>(lookHead), static_cast<uint8_t>(lookBody), static_cast<uint8_t>(lookLegs), static_cast<uint8_t>(lookFeet), destHasAlpha);
 }
 
 void GameSprite::clean(time_t time, int longevity) {
@@ -240,29 +216,43 @@ const AtlasRegion* GameSprite::getAtlasRegion(int _x, int _y, int _layer, int _c
 }
 
 TemplateImage* GameSprite::getTemplateImage(int sprite_index, const Outfit& outfit) {
-	// While this is linear lookup, it is very rare for the list to contain more than 4-8 entries,
-	// so it's faster than a hashmap anyways.
-	auto it = std::ranges::find_if(instanced_templates, [sprite_index, &outfit](const auto& img) {
-		if (img->sprite_index != sprite_index) {
-			return false;
-		}
-		uint32_t lookHash = img->lookHead << 24 | img->lookBody << 16 | img->lookLegs << 8 | img->lookFeet;
-		return outfit.getColorHash() == lookHash;
-	});
-
-	if (it != instanced_templates.end()) {
-		// Move-to-front optimization
-		if (it != instanced_templates.begin()) {
-			std::iter_swap(it, instanced_templates.begin());
-			return instanced_templates.front().get();
-		}
-		return it->get();
+	// Keyed by sprite index (direction, addon, mount pattern and frame) and the outfit colors
+	const uint64_t key = static_cast<uint64_t>(static_cast<uint32_t>(sprite_index)) << 32 | outfit.getColorHash();
+	if (auto it = template_lookup.find(key); it != template_lookup.end()) {
+		return it->second;
 	}
 
-	auto img = std::make_unique<TemplateImage>(this, sprite_index, outfit);
-	TemplateImage* ptr = img.get();
-	instanced_templates.push_back(std::move(img));
-	return ptr;
+	TemplateImage* img = nullptr;
+	if (instanced_templates.size() >= MAX_TEMPLATE_INSTANCES) {
+		img = recycleTemplateImage();
+	}
+	if (img) {
+		template_lookup.erase(img->cache_key);
+		img->reset(sprite_index, outfit);
+	} else {
+		instanced_templates.push_back(std::make_unique<TemplateImage>(this, sprite_index, outfit));
+		img = instanced_templates.back().get();
+	}
+
+	img->cache_key = key;
+	template_lookup.emplace(key, img);
+	return img;
+}
+
+TemplateImage* GameSprite::recycleTemplateImage() {
+	// Least recently drawn colorization, as long as it was not drawn this second
+	// (its region may still be queued in the current sprite batch).
+	const int64_t now = static_cast<int64_t>(g_gui.gfx.getCachedTime());
+	TemplateImage* oldest = nullptr;
+	int64_t oldest_access = now;
+	for (const auto& img : instanced_templates) {
+		const int64_t access = img->lastaccess.load(std::memory_order_relaxed);
+		if (access < oldest_access) {
+			oldest = img.get();
+			oldest_access = access;
+		}
+	}
+	return oldest;
 }
 
 const AtlasRegion* GameSprite::getAtlasRegion(int _x, int _y, int _dir, int _addon, int _pattern_z, const Outfit& _outfit, int _frame) {
@@ -116,6 +116,7 @@ protected:
 	wxMemoryDC* getDC(SpriteSize size);
 	wxMemoryDC* getDC(SpriteSize size, const Outfit& outfit);
 	TemplateImage* getTemplateImage(int sprite_index, const Outfit& outfit);
+	TemplateImage* recycleTemplateImage();
 
 	uint32_t id;
 	std::unique_ptr<wxMemoryDC> dc[SPRITE_SIZE_COUNT];
@@ -148,7 +149,12 @@ public:
 	SpriteLight light;
 
 	std::vector<NormalImage*> spriteList;
+	// Colorized outfit variants of this sprite. Past MAX_TEMPLATE_INSTANCES the
+	// least recently drawn one is recolored for the next new combination, so
+	// the objects stay alive (they are referenced from resident_images).
+	static constexpr size_t MAX_TEMPLATE_INSTANCES = 1024;
 	std::vector<std::unique_ptr<TemplateImage>> instanced_templates; // Templates that use this sprite
+	std::unordered_map<uint64_t, TemplateImage*> template_lookup; // (sprite index << 32 | color hash) -> template
 	struct CachedDC {
 		std::unique_ptr<wxMemoryDC> dc;
 		std::unique_ptr<wxBitmap> bm;
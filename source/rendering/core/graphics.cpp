@@ -20,6 +20,8 @@
 #include "game/sprites.h"
 #include "rendering/core/graphics.h"
 #include "rendering/core/sprite_preloader.h"
+#include "rendering/core/sprite_archive.h"
+#include "rendering/core/sprite_disk_cache.h"
 #include <nanovg.h>
 #include <spdlog/spdlog.h>
 #include <nanovg_gl.h>
@@ -68,6 +70,9 @@ bool GraphicManager::isUnloaded() const {
 
 void GraphicManager::updateTime() {
 	cached_time_ = time(nullptr);
+	if (atlas_manager_) {
+		atlas_manager_->beginFrame();
+	}
 	SpritePreloader::get().update();
 }
 
@@ -85,6 +90,8 @@ void GraphicManager::clear() {
 	creature_count = 0;
 	collector.Clear();
 	spritefile = "";
+	// Written out on a worker, the unload does not wait for it
+	SpriteDiskCache::saveInBackground(std::move(sprite_cache_), sprite_archive_);
 	sprite_archive_.reset();
 
 	// Cleanup atlas manager (will be reinitialized lazily when needed)
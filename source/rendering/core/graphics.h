@@ -42,6 +42,7 @@ class GraphicManager;
 class FileReadHandle;
 class Animator;
 class SpriteArchive;
+class SpriteDiskCache;
 
 #include "rendering/core/sprite_light.h"
 #include "rendering/core/texture_garbage_collector.h"
@@ -113,6 +114,10 @@ public:
 	std::shared_ptr<SpriteArchive> getSpriteArchive() const {
 		return sprite_archive_;
 	}
+	// Decoded-sprite disk cache of the loaded archive; null when disabled.
+	std::shared_ptr<SpriteDiskCache> getSpriteCache() const {
+		return sprite_cache_;
+	}
 
 	ClientVersion* client_version;
 
@@ -130,6 +135,7 @@ private:
 	std::atomic<bool> unloaded;
 	std::string spritefile;
 	std::shared_ptr<SpriteArchive> sprite_archive_;
+	std::shared_ptr<SpriteDiskCache> sprite_cache_;
 
 	// Atlas manager for Phase 2 texture array rendering
 	std::unique_ptr<AtlasManager> atlas_manager_ = nullptr;
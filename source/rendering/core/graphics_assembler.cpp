@@ -5,10 +5,14 @@
 #include "rendering/core/game_sprite.h"
 #include "rendering/core/graphics.h"
 #include "rendering/core/normal_image.h"
+#include "app/settings.h"
 #include "rendering/core/sprite_archive.h"
+#include "rendering/core/sprite_disk_cache.h"
 #include "rendering/core/sprite_preloader.h"
+#include "util/parallel.h"
 
 #include <algorithm>
+#include <atomic>
 #include <format>
 #include <memory>
 #include <wx/string.h>
@@ -27,6 +31,12 @@ namespace {
 			return false;
 		}
 
+		// install() indexes entries directly over 100..lastEntryId()
+		if (catalog.entries.size() <= catalog.lastEntryId()) {
+			const size_t client_id = std::max<size_t>(100, catalog.entries.size());
+			error = wxString::FromUTF8(std::format("Missing DAT catalog entry for client id {}.", client_id));
+			return false;
+		}
 		for (uint32_t client_id = 100; client_id <= catalog.lastEntryId(); ++client_id) {
 			const auto* entry = catalog.entry(client_id);
 			if (!entry) {
@@ -39,20 +49,6 @@ namespace {
 	}
 }
 
-NormalImage* GraphicsAssembler::ensureImage(GraphicManager& manager, uint32_t sprite_id) {
-	if (sprite_id >= manager.image_space.size()) {
-		return nullptr;
-	}
-
-	auto& slot = manager.image_space[sprite_id];
-	if (!slot) {
-		auto image = std::make_unique<NormalImage>();
-		image->id = sprite_id;
-		slot = std::move(image);
-	}
-	return static_cast<NormalImage*>(slot.get());
-}
-
 void GraphicsAssembler::installAnimation(GameSprite& sprite, const DatCatalogEntry& entry) {
 	if (!entry.animation.has_value()) {
 		sprite.animator.reset();
@@ -68,7 +64,7 @@ void GraphicsAssembler::installAnimation(GameSprite& sprite, const DatCatalogEnt
 	sprite.animator->reset();
 }
 
-bool GraphicsAssembler::installSpriteEntry(GraphicManager& manager, const DatCatalogEntry& entry, std::vector<std::string>& warnings) {
+std::unique_ptr<GameSprite> GraphicsAssembler::buildSprite(const GraphicManager& manager, const DatCatalogEntry& entry) {
 	auto sprite = std::make_unique<GameSprite>();
 	auto* sprite_ptr = sprite.get();
 
@@ -92,22 +88,16 @@ bool GraphicsAssembler::installSpriteEntry(GraphicManager& manager, const DatCat
 	sprite_ptr->spriteList.clear();
 	sprite_ptr->spriteList.reserve(entry.sprite_ids.size());
 	for (uint32_t sprite_id : entry.sprite_ids) {
-		NormalImage* image = ensureImage(manager, sprite_id);
-		if (!image) {
-			warnings.push_back(std::format("GraphicsAssembler: sprite {} references out-of-range image {}.", entry.client_id, sprite_id));
-			return false;
-		}
-		sprite_ptr->spriteList.push_back(image);
+		sprite_ptr->spriteList.push_back(static_cast<NormalImage*>(manager.image_space[sprite_id].get()));
 	}
 	sprite_ptr->updateSimpleStatus();
-
-	manager.sprite_space[entry.client_id] = std::move(sprite);
-	return true;
+	return sprite;
 }
 
 void GraphicsAssembler::resetRuntimeState(GraphicManager& manager) {
 	SpritePreloader::get().clear();
 	manager.unloaded = true;
+	SpriteDiskCache::saveInBackground(std::move(manager.sprite_cache_), manager.sprite_archive_);
 	manager.sprite_archive_.reset();
 	manager.spritefile.clear();
 	manager.sprite_space.clear();
@@ -138,18 +128,52 @@ bool GraphicsAssembler::install(GraphicManager& manager, const DatCatalog& catal
 	manager.sprite_space.resize(sprite_space_size);
 	manager.image_space.resize(image_space_size);
 
-	for (uint32_t client_id = 100; client_id <= catalog.lastEntryId(); ++client_id) {
-		const auto* entry = catalog.entry(client_id);
-		if (!entry) {
-			error = wxString::FromUTF8(std::format("Missing DAT catalog entry for client id {}.", client_id));
-			return false;
+	// Entries are independent, so they are installed in parallel in three
+	// passes: mark the images in use, create them (each slot written by one
+	// thread), then build the sprites into their own slots. validateCatalog
+	// made sure entries holds every client id up to lastEntryId().
+	std::vector<uint8_t> image_used(image_space_size, 0);
+	std::atomic<bool> out_of_range = false;
+	parallelFor(100, static_cast<size_t>(catalog.lastEntryId()) + 1, 2048, [&](size_t start, size_t end) {
+		for (size_t client_id = start; client_id < end; ++client_id) {
+			for (uint32_t sprite_id : catalog.entries[client_id].sprite_ids) {
+				if (sprite_id >= image_space_size) {
+					out_of_range.store(true, std::memory_order_relaxed);
+					continue;
+				}
+				std::atomic_ref(image_used[sprite_id]).store(1, std::memory_order_relaxed);
+			}
 		}
-		if (!installSpriteEntry(manager, *entry, warnings)) {
-			error = wxString::FromUTF8(std::format("Failed to install graphics for client id {}.", client_id));
-			return false;
+	});
+	if (out_of_range) {
+		// Can't happen with a catalog from DatItemParser; report the first one.
+		for (uint32_t client_id = 100; client_id <= catalog.lastEntryId(); ++client_id) {
+			for (uint32_t sprite_id : catalog.entries[client_id].sprite_ids) {
+				if (sprite_id >= image_space_size) {
+					warnings.push_back(std::format("GraphicsAssembler: sprite {} references out-of-range image {}.", client_id, sprite_id));
+					error = wxString::FromUTF8(std::format("Failed to install graphics for client id {}.", client_id));
+					return false;
+				}
+			}
 		}
 	}
 
+	parallelFor(0, image_space_size, 2048, [&](size_t start, size_t end) {
+		for (size_t sprite_id = start; sprite_id < end; ++sprite_id) {
+			if (image_used[sprite_id]) {
+				auto image = std::make_unique<NormalImage>();
+				image->id = static_cast<uint32_t>(sprite_id);
+				manager.image_space[sprite_id] = std::move(image);
+			}
+		}
+	});
+
+	parallelFor(100, static_cast<size_t>(catalog.lastEntryId()) + 1, 2048, [&](size_t start, size_t end) {
+		for (size_t client_id = start; client_id < end; ++client_id) {
+			manager.sprite_space[client_id] = buildSprite(manager, catalog.entries[client_id]);
+		}
+	});
+
 	manager.dat_format = catalog.format;
 	manager.item_count = catalog.item_count;
 	manager.creature_count = catalog.creature_count;
@@ -161,5 +185,10 @@ bool GraphicsAssembler::install(GraphicManager& manager, const DatCatalog& catal
 	manager.spritefile = manager.sprite_archive_->fileName();
 	manager.unloaded = false;
 
+	if (g_settings.getBoolean(Config::SPRITE_DISK_CACHE)) {
+		manager.sprite_cache_ = SpriteDiskCache::open(*manager.sprite_archive_, manager.has_transparency);
+		SpritePreloader::get().prewarm(manager.sprite_cache_->warmList(SpritePreloader::MAX_PREWARM_SPRITES));
+	}
+
 	return true;
 }
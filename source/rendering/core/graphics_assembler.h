@@ -8,7 +8,6 @@
 
 class GraphicManager;
 class GameSprite;
-class NormalImage;
 class SpriteArchive;
 class wxString;
 struct DatCatalog;
@@ -19,9 +18,9 @@ public:
 	static bool install(GraphicManager& manager, const DatCatalog& catalog, std::shared_ptr<SpriteArchive> sprite_archive, wxString& error, std::vector<std::string>& warnings);
 
 private:
-	static NormalImage* ensureImage(GraphicManager& manager, uint32_t sprite_id);
 	static void installAnimation(GameSprite& sprite, const DatCatalogEntry& entry);
-	static bool installSpriteEntry(GraphicManager& manager, const DatCatalogEntry& entry, std::vector<std::string>& warnings);
+	// Needs every image the entry references to exist in image_space already.
+	static std::unique_ptr<GameSprite> buildSprite(const GraphicManager& manager, const DatCatalogEntry& entry);
 	static void resetRuntimeState(GraphicManager& manager);
 };
 
@@ -15,6 +15,15 @@ void Image::clean(time_t time, int longevity) {
 	// Base implementation does nothing
 }
 
+void Image::trackResident() {
+	// An image evicted by the atlas stays listed until the next collection, so
+	// reloading it must not add it twice.
+	if (!inResidentSet) {
+		inResidentSet = true;
+		g_gui.gfx.resident_images.push_back(this); // Add to resident set
+	}
+}
+
 const AtlasRegion* Image::EnsureAtlasSprite(uint32_t sprite_id, std::unique_ptr<uint8_t[]> preloaded_data) {
 	if (g_gui.gfx.ensureAtlasManager()) {
 		AtlasManager* atlas_mgr = g_gui.gfx.getAtlasManager();
@@ -31,6 +40,10 @@ const AtlasRegion* Image::EnsureAtlasSprite(uint32_t sprite_id, std::unique_ptr<
 				atlas_mgr->clearMapping(sprite_id);
 				region = nullptr; // Force reload
 			} else {
+				if (!isGLLoaded) {
+					isGLLoaded = true;
+					trackResident();
+				}
 				return region;
 			}
 		}
@@ -60,12 +73,12 @@ const AtlasRegion* Image::EnsureAtlasSprite(uint32_t sprite_id, std::unique_ptr<
 		}
 
 		// 3. Add to Atlas
-		region = atlas_mgr->addSprite(sprite_id, rgba.get());
+		region = atlas_mgr->addSprite(sprite_id, rgba.get(), this);
 
 		if (region) {
 			if (!isGLLoaded) {
 				isGLLoaded = true;
-				g_gui.gfx.resident_images.push_back(this); // Add to resident set
+				trackResident();
 			}
 			g_gui.gfx.collector.NotifyTextureLoaded();
 			return region;
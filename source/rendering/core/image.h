@@ -12,11 +12,15 @@ public:
 	virtual ~Image() = default;
 
 	bool isGLLoaded = false;
+	bool inResidentSet = false; // Listed in GraphicManager::resident_images
 	mutable std::atomic<int64_t> lastaccess;
 	uint32_t generation_id = 0;
 
 	void visit() const;
 	virtual void clean(time_t time, int longevity);
+	// Called by AtlasManager after it reclaimed this image's slot. The region
+	// is still readable during the call and invalid afterwards.
+	virtual void onAtlasEvicted() { }
 
 	virtual std::unique_ptr<uint8_t[]> getRGBData() = 0;
 	virtual std::unique_ptr<uint8_t[]> getRGBAData() = 0;
@@ -26,6 +30,8 @@ public:
 	}
 
 protected:
+	void trackResident();
+
 	// Helper to handle atlas interactions
 	const AtlasRegion* EnsureAtlasSprite(uint32_t sprite_id, std::unique_ptr<uint8_t[]> preloaded_data = nullptr);
 };
@@ -35,31 +35,26 @@ void NormalImage::fulfillPreload(std::unique_ptr<uint8_t[]> data) {
 }
 
 void NormalImage::clean(time_t time, int longevity) {
-	// Evict from atlas if expired
-	if (longevity == -1) {
-		longevity = g_settings.getInteger(Config::TEXTURE_LONGEVITY);
+	// Atlas slots are reclaimed by AtlasManager under its VRAM budget (see onAtlasEvicted)
+	if (time - static_cast<time_t>(lastaccess.load(std::memory_order_relaxed)) > 5 && !g_settings.getInteger(Config::USE_MEMCACHED_SPRITES)) { // We keep dumps around for 5 seconds.
+		dump.reset();
 	}
-	if (isGLLoaded && time - static_cast<time_t>(lastaccess.load(std::memory_order_relaxed)) > longevity) {
-		if (g_gui.gfx.hasAtlasManager()) {
-			g_gui.gfx.getAtlasManager()->removeSprite(id);
-		}
-		if (parent) {
-			parent->invalidateCache(atlas_region);
-		}
+}
 
-		isGLLoaded = false;
-		atlas_region = nullptr;
+void NormalImage::onAtlasEvicted() {
+	if (parent) {
+		parent->invalidateCache(atlas_region);
+	}
 
-		// Invalidate any pending preloads for this sprite ID
-		generation_id++;
+	isGLLoaded = false;
+	atlas_region = nullptr;
 
-		g_gui.gfx.collector.NotifyTextureUnloaded();
-	}
+	// Invalidate any pending preloads for this sprite ID
+	generation_id++;
 
-	if (time - static_cast<time_t>(lastaccess.load(std::memory_order_relaxed)) > 5 && !g_settings.getInteger(Config::USE_MEMCACHED_SPRITES)) { // We keep dumps around for 5 seconds.
-		dump.reset();
-	}
+	g_gui.gfx.collector.NotifyTextureUnloaded();
 }
+
 std::unique_ptr<uint8_t[]> NormalImage::getRGBData() {
 	if (id == 0) {
 		const int pixels_data_size = SPRITE_PIXELS * SPRITE_PIXELS * RGB_COMPONENTS;
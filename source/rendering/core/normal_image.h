@@ -25,6 +25,7 @@ public:
 	std::unique_ptr<uint8_t[]> dump;
 
 	void clean(time_t time, int longevity) override;
+	void onAtlasEvicted() override;
 
 	std::unique_ptr<uint8_t[]> getRGBData() override;
 	std::unique_ptr<uint8_t[]> getRGBAData() override;
@@ -5,6 +5,33 @@
 #include "app/main.h"
 #include "rendering/core/outfit_colorizer.h"
 #include "rendering/core/outfit_colors.h"
+#include <array>
+#include <vector>
+
+namespace {
+	// tables[color][channel][value] == value scaled by that palette color,
+	// rounded exactly like ColorizePixel.
+	using ChannelTables = std::array<std::array<uint8_t, 256>, 3>;
+
+	const std::vector<ChannelTables>& scaleTables() {
+		static const std::vector<ChannelTables> tables = [] {
+			std::vector<ChannelTables> result(TemplateOutfitLookupTableSize);
+			for (unsigned int color = 0; color < TemplateOutfitLookupTableSize; ++color) {
+				const uint8_t ro = (TemplateOutfitLookupTable[color] & 0xFF0000) >> 16;
+				const uint8_t go = (TemplateOutfitLookupTable[color] & 0xFF00) >> 8;
+				const uint8_t bo = (TemplateOutfitLookupTable[color] & 0xFF);
+				for (int value = 0; value < 256; ++value) {
+					const uint8_t v = static_cast<uint8_t>(value);
+					result[color][0][value] = (uint8_t)(v * (ro / 255.f));
+					result[color][1][value] = (uint8_t)(v * (go / 255.f));
+					result[color][2][value] = (uint8_t)(v * (bo / 255.f));
+				}
+			}
+			return result;
+		}();
+		return tables;
+	}
+}
 
 void OutfitColorizer::ColorizePixel(uint8_t color, uint8_t& red, uint8_t& green, uint8_t& blue) {
 	// Thanks! Khaos, or was it mips? Hmmm... =)
@@ -15,3 +42,26 @@ void OutfitColorizer::ColorizePixel(uint8_t color, uint8_t& red, uint8_t& green,
 	green = (uint8_t)(green * (go / 255.f));
 	blue = (uint8_t)(blue * (bo / 255.f));
 }
+
+void OutfitColorizer::ColorizeTemplate(uint8_t* dest, const uint8_t* mask, size_t pixelCount, uint8_t head, uint8_t body, uint8_t legs, uint8_t feet, bool destHasAlpha) {
+	const auto& tables = scaleTables();
+	auto tableFor = [&tables](uint8_t color) {
+		return &tables[color < tables.size() ? color : 0];
+	};
+
+	// Indexed by (red != 0) << 2 | (green != 0) << 1 | (blue != 0); mixed masks other than yellow are left alone
+	const std::array<const ChannelTables*, 8> parts = {
+		nullptr, tableFor(feet), tableFor(legs), nullptr, tableFor(body), nullptr, tableFor(head), nullptr
+	};
+
+	const size_t dest_step = destHasAlpha ? 4 : 3;
+	for (size_t i = 0; i < pixelCount; ++i, dest += dest_step, mask += 3) {
+		const ChannelTables* part = parts[(mask[0] != 0) << 2 | (mask[1] != 0) << 1 | (mask[2] != 0)];
+		if (!part) {
+			continue;
+		}
+		dest[0] = (*part)[0][dest[0]];
+		dest[1] = (*part)[1][dest[1]];
+		dest[2] = (*part)[2][dest[2]];
+	}
+}
@@ -5,11 +5,18 @@
 #ifndef RME_RENDERING_CORE_OUTFIT_COLORIZER_H_
 #define RME_RENDERING_CORE_OUTFIT_COLORIZER_H_
 
+#include <cstddef>
 #include <cstdint>
 
 class OutfitColorizer {
 public:
 	static void ColorizePixel(uint8_t color, uint8_t& red, uint8_t& green, uint8_t& blue);
+
+	// Recolors dest (RGB, or RGBA when destHasAlpha) by an RGB template mask:
+	// yellow pixels take the head color, red the body, green the legs and blue
+	// the feet. Same result as ColorizePixel per pixel, through per-color
+	// channel tables instead of float math. Colors outside the palette act as 0.
+	static void ColorizeTemplate(uint8_t* dest, const uint8_t* mask, size_t pixelCount, uint8_t head, uint8_t body, uint8_t legs, uint8_t feet, bool destHasAlpha);
 };
 
 #endif
@@ -137,6 +137,17 @@ void* RingBuffer::waitAndMap(size_t count) {
 	return static_cast<char*>(mapped_ptr_) + (current_section_ * section_size_);
 }
 
+void* RingBuffer::tryMap(size_t count) {
+	if (!initialized_ || count > max_elements_) {
+		return nullptr;
+	}
+	if (!fences_[current_section_].isSignaled()) {
+		return nullptr;
+	}
+	fences_[current_section_].reset();
+	return static_cast<char*>(mapped_ptr_) + (current_section_ * section_size_);
+}
+
 void RingBuffer::finishWrite() {
 	// Persistent mapping: buffer stays mapped, nothing to unmap
 }
@@ -55,6 +55,12 @@ public:
 	 */
 	void* waitAndMap(size_t count);
 
+	/**
+	 * Like waitAndMap, but never blocks: returns nullptr if the GPU has not
+	 * finished reading the current section yet.
+	 */
+	void* tryMap(size_t count);
+
 	/**
 	 * Signal that we've finished writing.
 	 * For persistent mapping, this is a no-op but kept for API compatibility.
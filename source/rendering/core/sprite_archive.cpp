@@ -3,6 +3,8 @@
 #include "app/definitions.h"
 #include "io/filehandle.h"
 
+#include <algorithm>
+#include <filesystem>
 #include <format>
 #include <utility>
 #include <wx/filename.h>
@@ -33,6 +35,33 @@ namespace {
 		}
 		return true;
 	}
+
+	constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+	constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+	void hashBytes(uint64_t& hash, const void* data, size_t size) {
+		// FNV-1a
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= kFnvPrime;
+		}
+	}
+
+	// Size, modification time and sprite offset table: any edit to the
+	// sprites moves at least one of them. Uses only what the header read
+	// already brought in, so the sprite data itself stays unmapped.
+	uint64_t computeFingerprint(const std::string& filename, uint64_t file_size, bool is_extended, const std::vector<uint32_t>& offsets) {
+		std::error_code ec;
+		const int64_t modified = std::filesystem::last_write_time(filename, ec).time_since_epoch().count();
+
+		uint64_t hash = kFnvOffsetBasis;
+		hashBytes(hash, &file_size, sizeof(file_size));
+		hashBytes(hash, &modified, sizeof(modified));
+		hashBytes(hash, &is_extended, sizeof(is_extended));
+		hashBytes(hash, offsets.data(), offsets.size() * sizeof(uint32_t));
+		return hash;
+	}
 }
 
 SpriteArchive::SpriteArchive(std::string filename, bool is_extended, uint32_t sprite_count, std::vector<uint32_t> sprite_offsets) :
@@ -71,12 +100,29 @@ std::shared_ptr<SpriteArchive> SpriteArchive::load(const wxFileName& path, bool
 		warnings.push_back("Sprite archive contains zero sprites.");
 	}
 
-	return std::shared_ptr<SpriteArchive>(new SpriteArchive(path.GetFullPath().ToStdString(), is_extended, sprite_count, std::move(offsets)));
+	const std::string filename = path.GetFullPath().ToStdString();
+	const uint64_t fingerprint = computeFingerprint(filename, file.size(), is_extended, offsets);
+	std::shared_ptr<SpriteArchive> archive(new SpriteArchive(filename, is_extended, sprite_count, std::move(offsets)));
+	archive->fingerprint_ = fingerprint;
+
+	std::string map_error;
+	if (archive->mapping_.open(filename, map_error)) {
+		archive->bytes_ = archive->mapping_.data();
+	} else {
+		warnings.push_back(std::format("{}; reading the whole sprite file into memory instead.", map_error));
+		archive->contents_.resize(file.size());
+		if (!file.seek(0) || !file.getRAW(archive->contents_.data(), archive->contents_.size())) {
+			error = "Failed to read sprites file.";
+			return nullptr;
+		}
+		archive->bytes_ = archive->contents_;
+	}
+
+	return archive;
 }
 
-bool SpriteArchive::readCompressed(uint32_t sprite_id, std::unique_ptr<uint8_t[]>& target, uint16_t& size) const {
-	size = 0;
-	target.reset();
+bool SpriteArchive::readCompressed(uint32_t sprite_id, std::span<const uint8_t>& data) const {
+	data = {};
 
 	if (sprite_id == 0) {
 		return true;
@@ -90,25 +136,36 @@ bool SpriteArchive::readCompressed(uint32_t sprite_id, std::unique_ptr<uint8_t[]
 		return true;
 	}
 
-	FileReadHandle file(filename_);
-	if (!file.isOk()) {
-		return false;
-	}
-	if (!file.seek(offset + kSpriteDataOffset)) {
+	// Each entry is a 3 byte color key followed by the u16 data size.
+	const size_t size_offset = static_cast<size_t>(offset) + kSpriteDataOffset;
+	if (size_offset + sizeof(uint16_t) > bytes_.size()) {
 		return false;
 	}
+	const uint16_t compressed_size = static_cast<uint16_t>(bytes_[size_offset] | (bytes_[size_offset + 1] << 8));
 
-	uint16_t compressed_size = 0;
-	if (!file.getU16(compressed_size)) {
+	const size_t data_offset = size_offset + sizeof(uint16_t);
+	if (data_offset + compressed_size > bytes_.size()) {
 		return false;
 	}
 
-	auto buffer = std::make_unique<uint8_t[]>(compressed_size);
-	if (!file.getRAW(buffer.get(), compressed_size)) {
+	data = bytes_.subspan(data_offset, compressed_size);
+	return true;
+}
+
+bool SpriteArchive::readCompressed(uint32_t sprite_id, std::unique_ptr<uint8_t[]>& target, uint16_t& size) const {
+	size = 0;
+	target.reset();
+
+	std::span<const uint8_t> data;
+	if (!readCompressed(sprite_id, data)) {
 		return false;
 	}
+	if (data.empty()) {
+		return true;
+	}
 
-	size = compressed_size;
-	target = std::move(buffer);
+	target = std::make_unique<uint8_t[]>(data.size());
+	std::ranges::copy(data, target.get());
+	size = static_cast<uint16_t>(data.size());
 	return true;
 }
@@ -1,8 +1,11 @@
 #ifndef RME_RENDERING_CORE_SPRITE_ARCHIVE_H_
 #define RME_RENDERING_CORE_SPRITE_ARCHIVE_H_
 
+#include "io/mapped_file.h"
+
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -25,6 +28,17 @@ public:
 		return filename_;
 	}
 
+	// Identifies the archive contents: a hash of the file size, modification
+	// time and sprite offset table, so any edit to the sprites shows up here.
+	[[nodiscard]] uint64_t fingerprint() const {
+		return fingerprint_;
+	}
+
+	// Points data at the compressed pixels of the sprite, inside the archive's
+	// memory mapping. No copy, allocation or file access; safe to call from any
+	// thread while the archive is alive. Blank sprites yield an empty span.
+	[[nodiscard]] bool readCompressed(uint32_t sprite_id, std::span<const uint8_t>& data) const;
+	// Same, copied into an owned buffer.
 	[[nodiscard]] bool readCompressed(uint32_t sprite_id, std::unique_ptr<uint8_t[]>& target, uint16_t& size) const;
 
 private:
@@ -34,6 +48,12 @@ private:
 	bool is_extended_ = false;
 	uint32_t sprite_count_ = 0;
 	std::vector<uint32_t> sprite_offsets_;
+
+	// Whole file contents: the mapping, or a heap copy when mapping failed.
+	MappedFile mapping_;
+	std::vector<uint8_t> contents_;
+	std::span<const uint8_t> bytes_;
+	uint64_t fingerprint_ = 0;
 };
 
 #endif
@@ -128,6 +128,7 @@ bool SpriteBatch::initialize() {
 void SpriteBatch::begin(const glm::mat4& projection, const AtlasManager& atlas_manager) {
 	projection_ = projection;
 	current_atlas_manager_ = &atlas_manager;
+	current_frame_ = atlas_manager.currentFrame();
 	pending_sprites_.clear();
 	in_batch_ = true;
 	draw_call_count_ = 0;
@@ -178,6 +179,10 @@ void SpriteBatch::draw(float x, float y, float w, float h, const AtlasRegion& re
 		flush(*current_atlas_manager_);
 	}
 
+	// Regions are fetched right before they are drawn, so stamping here keeps
+	// everything on screen out of the atlas eviction candidates.
+	region.last_used_frame = current_frame_;
+
 	SpriteInstance& inst = pending_sprites_.emplace_back();
 	inst.x = x;
 	inst.y = y;
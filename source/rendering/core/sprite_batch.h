@@ -115,6 +115,7 @@ private:
 	glm::mat4 projection_ { 1.0f };
 	glm::vec4 global_tint_ { 1.0f };
 	const AtlasManager* current_atlas_manager_ = nullptr;
+	uint32_t current_frame_ = 0;
 
 	// Scoped state for batch duration
 	std::optional<ScopedGLCapability> blend_capability_;
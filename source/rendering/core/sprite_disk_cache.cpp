@@ -0,0 +1,294 @@
+#include "app/main.h"
+#include "rendering/core/sprite_disk_cache.h"
+#include "rendering/core/game_sprite.h"
+#include "rendering/core/sprite_archive.h"
+#include "util/file_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <span>
+#include <spdlog/spdlog.h>
+
+namespace {
+	constexpr char kCacheMagic[4] = { 'R', 'S', 'P', 'C' };
+	constexpr uint32_t kCacheVersion = 1;
+	constexpr size_t kSpriteBytes = SPRITE_PIXELS_SIZE * PixelFormatRGBA;
+
+	struct CacheHeader {
+		char magic[4];
+		uint32_t version;
+		uint64_t fingerprint;
+		uint32_t has_transparency;
+		uint32_t count;
+	};
+
+	// Each record is the sprite id followed by its RGBA pixels.
+	constexpr size_t kRecordBytes = sizeof(uint32_t) + kSpriteBytes;
+
+	// Cache files kept in the directory, most recently written first. Older
+	// ones belong to archives that were edited or are no longer used.
+	constexpr size_t kMaxCacheFiles = 4;
+
+	void pruneCacheFiles(const std::string& current_path) {
+		const std::filesystem::path current(current_path);
+		std::error_code ec;
+		std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> files;
+		for (const auto& entry : std::filesystem::directory_iterator(current.parent_path(), ec)) {
+			if (entry.path().extension() != ".bin" || entry.path() == current) {
+				continue;
+			}
+			files.emplace_back(entry.last_write_time(ec), entry.path());
+		}
+		if (files.size() < kMaxCacheFiles) {
+			return;
+		}
+
+		std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+			return a.first > b.first;
+		});
+		// The current file takes one of the slots
+		for (size_t i = kMaxCacheFiles - 1; i < files.size(); ++i) {
+			if (std::filesystem::remove(files[i].second, ec)) {
+				spdlog::info("Sprite cache: removed superseded {}", files[i].second.string());
+			}
+		}
+	}
+
+	// Background saves with the file they write
+	std::mutex g_saves_mutex;
+	std::vector<std::pair<std::string, std::future<void>>> g_saves;
+
+	// Waits for the saves writing path, or for all of them if path is empty
+	void waitForSavesOf(const std::string& path) {
+		std::vector<std::future<void>> waiting;
+		{
+			std::lock_guard lock(g_saves_mutex);
+			std::erase_if(g_saves, [&](auto& save) {
+				if (!path.empty() && save.first != path) {
+					return false;
+				}
+				waiting.push_back(std::move(save.second));
+				return true;
+			});
+		}
+		for (auto& save : waiting) {
+			save.wait();
+		}
+	}
+
+	std::string cachePath(uint64_t fingerprint, bool has_transparency) {
+		FileName dir = FileSystem::GetLocalDirectory();
+		dir.AppendDir("sprite_cache");
+		dir.Mkdir(0755, wxPATH_MKDIR_FULL);
+		dir.SetFullName(wxString::FromUTF8(std::format("{:016x}_{}.bin", fingerprint, has_transparency ? "rgba" : "rgb")));
+		return dir.GetFullPath().ToStdString();
+	}
+}
+
+SpriteDiskCache::SpriteDiskCache(std::string path, uint64_t fingerprint, bool has_transparency) :
+	path_(std::move(path)),
+	fingerprint_(fingerprint),
+	has_transparency_(has_transparency) {
+}
+
+std::shared_ptr<SpriteDiskCache> SpriteDiskCache::open(const SpriteArchive& archive, bool has_transparency) {
+	std::shared_ptr<SpriteDiskCache> cache(new SpriteDiskCache(cachePath(archive.fingerprint(), has_transparency), archive.fingerprint(), has_transparency));
+	// Reloading the same archive right after unloading it: let its save finish
+	waitForSavesOf(cache->path_);
+	if (cache->load()) {
+		spdlog::info("Sprite cache: {} decoded sprites available from {}", cache->cached_order_.size(), cache->path_);
+	}
+	return cache;
+}
+
+bool SpriteDiskCache::load() {
+	if (!std::filesystem::exists(path_)) {
+		return false;
+	}
+
+	std::string error;
+	if (!mapping_.open(path_, error)) {
+		spdlog::warn("Sprite cache: {}", error);
+		return false;
+	}
+
+	const std::span<const uint8_t> bytes = mapping_.data();
+	CacheHeader header;
+	bool valid = bytes.size() >= sizeof(header);
+	if (valid) {
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		valid = std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) == 0
+			&& header.version == kCacheVersion
+			&& header.fingerprint == fingerprint_
+			&& header.has_transparency == (has_transparency_ ? 1u : 0u)
+			&& bytes.size() == sizeof(header) + static_cast<size_t>(header.count) * kRecordBytes;
+	}
+	if (!valid) {
+		spdlog::info("Sprite cache: ignoring stale or damaged {}", path_);
+		mapping_.close();
+		return false;
+	}
+
+	index_.reserve(header.count);
+	cached_order_.reserve(header.count);
+	size_t offset = sizeof(header);
+	for (uint32_t i = 0; i < header.count; ++i, offset += kRecordBytes) {
+		uint32_t sprite_id;
+		std::memcpy(&sprite_id, bytes.data() + offset, sizeof(sprite_id));
+		if (index_.try_emplace(sprite_id, offset + sizeof(sprite_id)).second) {
+			cached_order_.push_back(sprite_id);
+		}
+	}
+	return true;
+}
+
+bool SpriteDiskCache::copyPixels(uint32_t sprite_id, uint8_t* target) const {
+	std::shared_lock lock(mapping_mutex_);
+	const auto it = index_.find(sprite_id);
+	if (it == index_.end()) {
+		return false;
+	}
+	std::memcpy(target, mapping_.data().data() + it->second, kSpriteBytes);
+	return true;
+}
+
+std::unique_ptr<uint8_t[]> SpriteDiskCache::read(uint32_t sprite_id) const {
+	auto pixels = std::make_unique<uint8_t[]>(kSpriteBytes);
+	if (!copyPixels(sprite_id, pixels.get())) {
+		return nullptr;
+	}
+	return pixels;
+}
+
+void SpriteDiskCache::noteUsed(uint32_t sprite_id) {
+	std::lock_guard lock(used_mutex_);
+	if (!used_.insert(sprite_id).second) {
+		return;
+	}
+	used_order_.push_back(sprite_id);
+	if (!has_new_sprites_) {
+		std::shared_lock mapping_lock(mapping_mutex_);
+		has_new_sprites_ = !index_.contains(sprite_id);
+	}
+}
+
+std::vector<uint32_t> SpriteDiskCache::warmList(size_t limit) const {
+	std::shared_lock lock(mapping_mutex_);
+	const size_t count = std::min(limit, cached_order_.size());
+	return std::vector<uint32_t>(cached_order_.begin(), cached_order_.begin() + count);
+}
+
+void SpriteDiskCache::save(const SpriteArchive& archive) {
+	std::vector<uint32_t> order;
+	{
+		std::lock_guard lock(used_mutex_);
+		if (!has_new_sprites_) {
+			return;
+		}
+		order = used_order_;
+
+		// Sprites of earlier sessions go behind this session's.
+		std::shared_lock mapping_lock(mapping_mutex_);
+		for (uint32_t sprite_id : cached_order_) {
+			if (order.size() >= MAX_CACHED_SPRITES) {
+				break;
+			}
+			if (!used_.contains(sprite_id)) {
+				order.push_back(sprite_id);
+			}
+		}
+	}
+	if (order.size() > MAX_CACHED_SPRITES) {
+		order.resize(MAX_CACHED_SPRITES);
+	}
+
+	const std::string temp_path = path_ + ".tmp";
+	uint32_t written = 0;
+	{
+		std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			spdlog::warn("Sprite cache: cannot write {}", temp_path);
+			return;
+		}
+
+		CacheHeader header {};
+		std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+		header.version = kCacheVersion;
+		header.fingerprint = fingerprint_;
+		header.has_transparency = has_transparency_ ? 1 : 0;
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		std::vector<uint8_t> pixels(kSpriteBytes);
+		for (uint32_t sprite_id : order) {
+			if (!copyPixels(sprite_id, pixels.data())) {
+				std::span<const uint8_t> dump;
+				if (!archive.readCompressed(sprite_id, dump) || dump.empty()) {
+					continue;
+				}
+				const auto rgba = GameSprite::Decompress(dump, has_transparency_, static_cast<int>(sprite_id));
+				std::memcpy(pixels.data(), rgba.get(), kSpriteBytes);
+			}
+			out.write(reinterpret_cast<const char*>(&sprite_id), sizeof(sprite_id));
+			out.write(reinterpret_cast<const char*>(pixels.data()), kSpriteBytes);
+			++header.count;
+		}
+
+		written = header.count;
+		out.seekp(0);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (!out) {
+			spdlog::warn("Sprite cache: failed writing {}", temp_path);
+			out.close();
+			std::error_code ec;
+			std::filesystem::remove(temp_path, ec);
+			return;
+		}
+	}
+
+	// Drop the mapping before replacing the file (required on Windows).
+	{
+		std::unique_lock lock(mapping_mutex_);
+		mapping_.close();
+		index_.clear();
+		cached_order_.clear();
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temp_path, path_, ec);
+	if (ec) {
+		spdlog::warn("Sprite cache: cannot replace {}: {}", path_, ec.message());
+		std::filesystem::remove(temp_path, ec);
+		return;
+	}
+
+	pruneCacheFiles(path_);
+
+	std::lock_guard lock(used_mutex_);
+	has_new_sprites_ = false;
+	spdlog::info("Sprite cache: saved {} sprites to {}", written, path_);
+}
+
+void SpriteDiskCache::saveInBackground(std::shared_ptr<SpriteDiskCache> cache, std::shared_ptr<const SpriteArchive> archive) {
+	if (!cache || !archive) {
+		return;
+	}
+
+	std::lock_guard lock(g_saves_mutex);
+	std::erase_if(g_saves, [](const auto& save) {
+		return save.second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	});
+	const std::string path = cache->path_;
+	g_saves.emplace_back(path, std::async(std::launch::async, [cache = std::move(cache), archive = std::move(archive)]() {
+		cache->save(*archive);
+	}));
+}
+
+void SpriteDiskCache::waitForSaves() {
+	waitForSavesOf(std::string());
+}
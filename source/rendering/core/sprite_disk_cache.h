@@ -0,0 +1,74 @@
+#ifndef RME_RENDERING_CORE_SPRITE_DISK_CACHE_H_
+#define RME_RENDERING_CORE_SPRITE_DISK_CACHE_H_
+
+#include "io/mapped_file.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class SpriteArchive;
+
+// Decoded RGBA sprites of one sprite archive, kept on disk between sessions.
+//
+// The file is keyed by the archive fingerprint and the transparency mode and
+// holds the sprites used in the previous sessions, most recent first. It is
+// memory-mapped on open; preload workers copy pixels out of it instead of
+// decoding, and the startup pre-warm walks it to fill the atlas before those
+// sprites scroll into view. The file is rewritten on save() only when the
+// session used sprites it did not hold yet; saving also deletes all but the
+// few most recently written cache files, so files of edited or retired
+// archives do not pile up.
+class SpriteDiskCache {
+public:
+	// Sprites kept per archive; 16384 sprites of 32x32 RGBA is 64 MiB.
+	static constexpr size_t MAX_CACHED_SPRITES = 16384;
+
+	[[nodiscard]] static std::shared_ptr<SpriteDiskCache> open(const SpriteArchive& archive, bool has_transparency);
+
+	SpriteDiskCache(const SpriteDiskCache&) = delete;
+	SpriteDiskCache& operator=(const SpriteDiskCache&) = delete;
+
+	// Decoded pixels of the sprite, nullptr when not cached. Thread-safe.
+	[[nodiscard]] std::unique_ptr<uint8_t[]> read(uint32_t sprite_id) const;
+	// Records that the sprite was shown in this session. Thread-safe.
+	void noteUsed(uint32_t sprite_id);
+	// Cached sprite ids, most recently used first.
+	[[nodiscard]] std::vector<uint32_t> warmList(size_t limit) const;
+
+	// Writes this session's sprites (then the older ones) back to disk. Workers
+	// still holding the cache simply stop getting hits afterwards.
+	void save(const SpriteArchive& archive);
+	// Runs save() on a worker thread that keeps the cache and the archive alive
+	// until it is done, so unloading the sprites does not wait for the disk.
+	static void saveInBackground(std::shared_ptr<SpriteDiskCache> cache, std::shared_ptr<const SpriteArchive> archive);
+	// Waits for the background saves; called before the application exits.
+	static void waitForSaves();
+
+private:
+	SpriteDiskCache(std::string path, uint64_t fingerprint, bool has_transparency);
+
+	bool load();
+	bool copyPixels(uint32_t sprite_id, uint8_t* target) const;
+
+	std::string path_;
+	uint64_t fingerprint_;
+	bool has_transparency_;
+
+	mutable std::shared_mutex mapping_mutex_;
+	MappedFile mapping_;
+	std::unordered_map<uint32_t, size_t> index_; // sprite id -> pixel offset in mapping_
+	std::vector<uint32_t> cached_order_;
+
+	std::mutex used_mutex_;
+	std::vector<uint32_t> used_order_;
+	std::unordered_set<uint32_t> used_;
+	bool has_new_sprites_ = false;
+};
+
+#endif
@@ -6,12 +6,28 @@
 #include "rendering/core/graphics.h"
 #include "rendering/core/normal_image.h"
 #include "rendering/core/sprite_archive.h"
+#include "rendering/core/sprite_disk_cache.h"
+#include "map/position.h"
 #include "ui/gui.h"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
 #include <span>
 
+namespace {
+	// A floor away costs as much as this many tiles away.
+	constexpr int FLOOR_DISTANCE_WEIGHT = 8;
+	constexpr uint64_t DISTANCE_BITS = 24;
+	constexpr uint64_t MAX_DISTANCE = (uint64_t { 1 } << DISTANCE_BITS) - 1;
+
+	// Main thread time spent uploading finished sprites per frame. At least
+	// MIN_UPLOADS_PER_FRAME go through regardless, so streaming always advances.
+	constexpr auto UPLOAD_TIME_BUDGET = std::chrono::microseconds(3000);
+	constexpr size_t MIN_UPLOADS_PER_FRAME = 32;
+}
+
 SpritePreloader& SpritePreloader::get() {
 	static SpritePreloader instance;
 	return instance;
@@ -49,17 +65,71 @@ void SpritePreloader::clear() {
 	std::lock_guard<std::mutex> lock(queue_mutex);
 	// Bump the epoch so any in-flight worker result becomes stale.
 	++active_epoch;
-	task_queue = std::queue<Task>();
-	result_queue = std::queue<Result>();
+	task_heap.clear();
+	result_queue.clear();
+	upload_queue.clear();
 	pending_ids.clear();
 }
 
-void SpritePreloader::preload(GameSprite* spr, int pattern_x, int pattern_y, int pattern_z, int frame) {
+void SpritePreloader::setViewFocus(int center_x, int center_y, int floor) {
+	if (center_x == focus_x && center_y == focus_y && floor == focus_floor) {
+		return;
+	}
+	focus_x = center_x;
+	focus_y = center_y;
+	focus_floor = floor;
+
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	++view_round;
+}
+
+uint64_t SpritePreloader::priorityFor(const Position& position, uint64_t round) const {
+	// Newer rounds first, then nearest to the view center.
+	const uint64_t distance = std::max(std::abs(position.x - focus_x), std::abs(position.y - focus_y)) + FLOOR_DISTANCE_WEIGHT * std::abs(position.z - focus_floor);
+	return (round << DISTANCE_BITS) | (MAX_DISTANCE - std::min(distance, MAX_DISTANCE));
+}
+
+bool SpritePreloader::isExpiredLocked(const PendingState& state) const {
+	return state.view_round != 0 && view_round - state.view_round > CANCEL_AFTER_VIEW_MOVES;
+}
+
+void SpritePreloader::enqueueLocked(const PendingSpriteKey& key, uint64_t priority, uint64_t round, const std::shared_ptr<SpriteArchive>& archive, const std::shared_ptr<SpriteDiskCache>& cache, bool has_transparency) {
+	auto [it, inserted] = pending_ids.try_emplace(key);
+	PendingState& state = it->second;
+	if (inserted) {
+		state.view_round = round;
+	} else {
+		if (round != 0) {
+			// Asked for again while visible: keep it from expiring.
+			state.view_round = std::max(state.view_round, round);
+		}
+		if (state.in_flight || priority <= state.priority) {
+			return;
+		}
+	}
+	state.priority = priority;
+	task_heap.push_back({ priority, { key, archive, cache, has_transparency } });
+	std::push_heap(task_heap.begin(), task_heap.end());
+}
+
+void SpritePreloader::compactLocked() {
+	std::erase_if(pending_ids, [this](const auto& entry) {
+		return !entry.second.in_flight && isExpiredLocked(entry.second);
+	});
+	std::erase_if(task_heap, [this](const QueuedTask& queued) {
+		const auto it = pending_ids.find(queued.task.pending);
+		return it == pending_ids.end() || it->second.in_flight || it->second.priority != queued.priority;
+	});
+	std::make_heap(task_heap.begin(), task_heap.end());
+}
+
+void SpritePreloader::preload(GameSprite* spr, int pattern_x, int pattern_y, int pattern_z, int frame, const Position& position) {
 	if (!spr) {
 		return;
 	}
 
 	const auto archive = g_gui.gfx.getSpriteArchive();
+	const auto cache = g_gui.gfx.getSpriteCache();
 	const bool has_transparency = g_gui.gfx.hasTransparency();
 	if (!archive) {
 		return;
@@ -108,50 +178,119 @@ void SpritePreloader::preload(GameSprite* spr, int pattern_x, int pattern_y, int
 
 	if (!ids_to_enqueue.empty()) {
 		std::lock_guard<std::mutex> lock(queue_mutex);
-		if (task_queue.size() > MAX_QUEUE_SIZE) {
-			return; // Drop requests if queue is slammed
+		if (task_heap.size() > MAX_QUEUE_SIZE) {
+			compactLocked();
+			if (task_heap.size() > MAX_QUEUE_SIZE) {
+				return; // Drop requests if queue is slammed
+			}
 		}
 
+		const uint64_t priority = priorityFor(position, view_round);
 		for (const auto& pending : ids_to_enqueue) {
 			const PendingSpriteKey pending_key {
 				.key = pending.key,
 				.generation_id = pending.generation_id,
 				.epoch = active_epoch,
 			};
-			if (pending_ids.insert(pending_key).second) {
-				task_queue.push({ pending_key, archive, has_transparency });
-			}
+			enqueueLocked(pending_key, priority, view_round, archive, cache, has_transparency);
 		}
 		cv.notify_all();
 	}
 }
 
+void SpritePreloader::prewarm(const std::vector<uint32_t>& sprite_ids) {
+	const auto archive = g_gui.gfx.getSpriteArchive();
+	const auto cache = g_gui.gfx.getSpriteCache();
+	const bool has_transparency = g_gui.gfx.hasTransparency();
+	if (!archive || sprite_ids.empty()) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	for (size_t index = 0; index < sprite_ids.size(); ++index) {
+		const uint32_t id = sprite_ids[index];
+		if (task_heap.size() > MAX_QUEUE_SIZE) {
+			break;
+		}
+		if (id >= g_gui.gfx.image_space.size()) {
+			continue;
+		}
+		const auto& img_ptr = g_gui.gfx.image_space[id];
+		if (!img_ptr || !img_ptr->isNormalImage()) {
+			continue;
+		}
+		const auto* img = static_cast<NormalImage*>(img_ptr.get());
+		if (img->isGLLoaded) {
+			continue;
+		}
+
+		const PendingSpriteKey pending_key {
+			.key = { archive.get(), id },
+			.generation_id = img->generation_id,
+			.epoch = active_epoch,
+		};
+		// Below any view request, keeping the warm list's most-recent-first order.
+		enqueueLocked(pending_key, sprite_ids.size() - index, 0, archive, cache, has_transparency);
+	}
+	cv.notify_all();
+}
+
 void SpritePreloader::workerLoop(std::stop_token stop_token) {
 	while (!stop_token.stop_requested()) {
 		Task task;
 		{
 			std::unique_lock<std::mutex> lock(queue_mutex);
-			cv.wait(lock, [this, &stop_token] { return stop_token.stop_requested() || !task_queue.empty(); });
-			if (stop_token.stop_requested()) {
+			bool found = false;
+			while (!found) {
+				cv.wait(lock, [this, &stop_token] { return stop_token.stop_requested() || !task_heap.empty(); });
+				if (stop_token.stop_requested()) {
+					break;
+				}
+				std::pop_heap(task_heap.begin(), task_heap.end());
+				QueuedTask queued = std::move(task_heap.back());
+				task_heap.pop_back();
+
+				const auto it = pending_ids.find(queued.task.pending);
+				if (it == pending_ids.end() || it->second.in_flight || it->second.priority != queued.priority) {
+					continue; // cleared or superseded by a better entry
+				}
+				if (isExpiredLocked(it->second)) {
+					pending_ids.erase(it); // scrolled out of view
+					continue;
+				}
+				it->second.in_flight = true;
+				task = std::move(queued.task);
+				found = true;
+			}
+			if (!found) {
 				break;
 			}
-			task = std::move(task_queue.front());
-			task_queue.pop();
 		}
 
-		std::unique_ptr<uint8_t[]> dump;
-		uint16_t size = 0;
-		const bool success = task.archive && task.archive->readCompressed(task.pending.key.id, dump, size);
-
+		const uint32_t sprite_id = task.pending.key.id;
 		std::unique_ptr<uint8_t[]> rgba;
-		if (success && dump) {
-			rgba = GameSprite::Decompress(std::span { dump.get(), size }, task.has_transparency, task.pending.key.id);
+		if (task.cache) {
+			rgba = task.cache->read(sprite_id);
+		}
+
+		if (!rgba) {
+			// Decompress straight out of the archive's file mapping; the task holds
+			// a reference to the archive, which keeps the mapping alive.
+			std::span<const uint8_t> dump;
+			const bool success = task.archive && task.archive->readCompressed(sprite_id, dump);
+			if (success && !dump.empty()) {
+				rgba = GameSprite::Decompress(dump, task.has_transparency, sprite_id);
+			}
+		}
+
+		if (rgba && task.cache) {
+			task.cache->noteUsed(sprite_id);
 		}
 
 		{
 			std::lock_guard<std::mutex> lock(queue_mutex);
 			if (rgba) {
-				result_queue.push({ task.pending, std::move(rgba), std::move(task.archive) });
+				result_queue.push_back({ task.pending, std::move(rgba), std::move(task.archive) });
 			} else {
 				pending_ids.erase(task.pending);
 			}
@@ -163,28 +302,38 @@ void SpritePreloader::update() {
 	// CRITICAL: This method MUST only be called from the main GUI/OpenGL thread.
 	assert(wxIsMainThread());
 
-	// Move results to a local queue under lock to minimize holding time.
-	std::queue<Result> results;
+	// Move results to the upload queue under lock to minimize holding time.
 	uint64_t current_epoch = 0;
 	{
 		std::lock_guard<std::mutex> lock(queue_mutex);
-		if (result_queue.empty()) {
+		if (result_queue.empty() && upload_queue.empty()) {
 			return;
 		}
-		results = std::move(result_queue);
+		for (Result& res : result_queue) {
+			upload_queue.push_back(std::move(res));
+		}
+		result_queue.clear();
 		current_epoch = active_epoch;
 	}
 
 	thread_local std::vector<PendingSpriteKey> keys_processed;
 	keys_processed.clear();
-	keys_processed.reserve(results.size());
 
 	const auto current_archive = g_gui.gfx.getSpriteArchive();
 	const bool graphics_unloaded = g_gui.gfx.isUnloaded();
 
-	while (!results.empty()) {
-		Result res = std::move(results.front());
-		results.pop();
+	// Uploads past the frame budget wait for the next frame; their keys stay
+	// pending so the sprites are not requested again meanwhile. A sprite drawn
+	// before its turn is loaded synchronously and its result dropped below.
+	const auto deadline = std::chrono::steady_clock::now() + UPLOAD_TIME_BUDGET;
+	size_t uploads = 0;
+	while (!upload_queue.empty()) {
+		if (uploads >= MIN_UPLOADS_PER_FRAME && std::chrono::steady_clock::now() >= deadline) {
+			break;
+		}
+
+		Result res = std::move(upload_queue.front());
+		upload_queue.pop_front();
 
 		const auto pending = res.pending;
 		const auto id = pending.key.id;
@@ -205,6 +354,7 @@ void SpritePreloader::update() {
 				// Check ID match, Generation match, and GLLoaded state
 				if (img->id == id && img->generation_id == pending.generation_id && !img->isGLLoaded) {
 					img->fulfillPreload(std::move(res.data));
+					++uploads;
 				}
 			}
 		}
@@ -219,7 +369,7 @@ void SpritePreloader::update() {
 }
 
 namespace rme {
-	void collectTileSprites(GameSprite* spr, int pattern_x, int pattern_y, int pattern_z, int frame) {
-		SpritePreloader::get().preload(spr, pattern_x, pattern_y, pattern_z, frame);
+	void collectTileSprites(GameSprite* spr, int pattern_x, int pattern_y, int pattern_z, int frame, const Position& position) {
+		SpritePreloader::get().preload(spr, pattern_x, pattern_y, pattern_z, frame, position);
 	}
 }
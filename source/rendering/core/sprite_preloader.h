@@ -12,10 +12,22 @@
 #include <thread>
 #include <condition_variable>
 #include <cstdint>
-#include <queue>
-#include <unordered_set>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 
 class SpriteArchive;
+class SpriteDiskCache;
+class Position;
+
+// Decodes sprites on worker threads ahead of their first draw.
+//
+// Requests are served by priority rather than arrival: sprites asked for
+// since the view last moved come first, nearest to the view center (and on
+// the current floor) before the rest. A request that nobody repeats for a few
+// view moves, i.e. a sprite that scrolled out of view, is dropped when a
+// worker reaches it, so jumping across the map doesn't leave the workers
+// decoding the old area first.
 
 class SpritePreloader {
 public:
@@ -26,9 +38,23 @@ public:
 
 	// Schedules sprites for preloading based on the given view parameters.
 	// This corresponds to the loop logic previously in collectTileSprites.
-	void preload(GameSprite* spr, int pattern_x, int pattern_y, int pattern_z, int frame);
+	// position is the tile being drawn, used to order the requests.
+	void preload(GameSprite* spr, int pattern_x, int pattern_y, int pattern_z, int frame, const Position& position);
 
-	// Processes finished preload tasks and uploads data to the GPU.
+	// Tells the preloader where the map view is, once per frame before drawing.
+	// Moving the view starts a new request round. Main thread only.
+	void setViewFocus(int center_x, int center_y, int floor);
+
+	// Queues sprites by id ahead of use, e.g. the disk cache's recent sprites
+	// right after the graphics are loaded.
+	void prewarm(const std::vector<uint32_t>& sprite_ids);
+
+	static constexpr size_t MAX_PREWARM_SPRITES = 2048;
+	// Requests not repeated within this many view moves are cancelled.
+	static constexpr uint64_t CANCEL_AFTER_VIEW_MOVES = 2;
+
+	// Processes finished preload tasks and uploads data to the GPU, within a
+	// per-frame time budget; the rest is carried over to the next call.
 	// Should be called on the main thread.
 	void update();
 
@@ -78,9 +104,27 @@ private:
 	struct Task {
 		PendingSpriteKey pending;
 		std::shared_ptr<SpriteArchive> archive;
+		std::shared_ptr<SpriteDiskCache> cache;
 		bool has_transparency;
 	};
 
+	// Heap entry; larger priority is served first. A sprite re-requested with a
+	// better priority gets a new entry and the old one is skipped when popped.
+	struct QueuedTask {
+		uint64_t priority = 0;
+		Task task;
+
+		bool operator<(const QueuedTask& other) const {
+			return priority < other.priority;
+		}
+	};
+
+	struct PendingState {
+		uint64_t priority = 0;
+		uint64_t view_round = 0; // 0 for prewarm requests, which never expire
+		bool in_flight = false;
+	};
+
 	struct Result {
 		PendingSpriteKey pending;
 		std::unique_ptr<uint8_t[]> data;
@@ -88,6 +132,12 @@ private:
 	};
 
 	void workerLoop(std::stop_token stop_token);
+	// Queues or re-prioritizes a request. queue_mutex must be held.
+	void enqueueLocked(const PendingSpriteKey& key, uint64_t priority, uint64_t view_round, const std::shared_ptr<SpriteArchive>& archive, const std::shared_ptr<SpriteDiskCache>& cache, bool has_transparency);
+	// Drops expired requests and superseded heap entries. queue_mutex must be held.
+	void compactLocked();
+	[[nodiscard]] bool isExpiredLocked(const PendingState& state) const;
+	[[nodiscard]] uint64_t priorityFor(const Position& position, uint64_t view_round) const;
 
 	static constexpr unsigned int MIN_WORKER_THREADS = 2u;
 	static constexpr unsigned int MAX_WORKER_THREADS = 8u;
@@ -99,14 +149,21 @@ private:
 	bool stopping = false;
 	std::vector<std::jthread> workers;
 
-	std::queue<Task> task_queue;
-	std::queue<Result> result_queue;
-	std::unordered_set<PendingSpriteKey, PendingSpriteKeyHash> pending_ids; // To avoid duplicate tasks for the same archive/id/generation/epoch
+	std::vector<QueuedTask> task_heap; // std::push_heap/pop_heap ordered
+	std::vector<Result> result_queue;
+	std::deque<Result> upload_queue; // Main thread only: results waiting for their upload turn
+	std::unordered_map<PendingSpriteKey, PendingState, PendingSpriteKeyHash> pending_ids; // To avoid duplicate tasks for the same archive/id/generation/epoch
 	uint64_t active_epoch = 0;
+
+	// View focus, written by the main thread; view_round changes under queue_mutex.
+	int focus_x = 0;
+	int focus_y = 0;
+	int focus_floor = 0;
+	uint64_t view_round = 1;
 };
 
 namespace rme {
-	void collectTileSprites(GameSprite* spr, int pattern_x, int pattern_y, int pattern_z, int frame);
+	void collectTileSprites(GameSprite* spr, int pattern_x, int pattern_y, int pattern_z, int frame, const Position& position);
 }
 
 #endif
@@ -2,7 +2,6 @@
 #include "rendering/core/game_sprite.h"
 #include "rendering/core/normal_image.h"
 #include "rendering/core/outfit_colors.h"
-#include "app/settings.h"
 #include "ui/gui.h"
 #include <atomic>
 #include <spdlog/spdlog.h>
@@ -28,20 +27,25 @@ TemplateImage::~TemplateImage() {
 	}
 }
 
-void TemplateImage::clean(time_t time, int longevity) {
-	// Evict from atlas if expired
-	if (longevity == -1) {
-		longevity = g_settings.getInteger(Config::TEXTURE_LONGEVITY);
-	}
-	if (isGLLoaded && time - static_cast<time_t>(lastaccess.load(std::memory_order_relaxed)) > longevity) {
+void TemplateImage::reset(int v, const Outfit& outfit) {
+	if (isGLLoaded) {
 		if (g_gui.gfx.hasAtlasManager()) {
 			g_gui.gfx.getAtlasManager()->removeSprite(texture_id);
 		}
-		isGLLoaded = false;
-		atlas_region = nullptr;
-		generation_id++;
-		g_gui.gfx.collector.NotifyTextureUnloaded();
+		onAtlasEvicted();
 	}
+	sprite_index = v;
+	lookHead = outfit.lookHead;
+	lookBody = outfit.lookBody;
+	lookLegs = outfit.lookLegs;
+	lookFeet = outfit.lookFeet;
+}
+
+void TemplateImage::onAtlasEvicted() {
+	isGLLoaded = false;
+	atlas_region = nullptr;
+	generation_id++;
+	g_gui.gfx.collector.NotifyTextureUnloaded();
 }
 
 namespace {
@@ -11,7 +11,10 @@ public:
 	TemplateImage(GameSprite* parent, int v, const Outfit& outfit);
 	~TemplateImage() override;
 
-	void clean(time_t time, int longevity) override;
+	void onAtlasEvicted() override;
+
+	// Turns this image into another colorization, dropping its atlas sprite
+	void reset(int v, const Outfit& outfit);
 
 	virtual std::unique_ptr<uint8_t[]> getRGBData() override;
 	virtual std::unique_ptr<uint8_t[]> getRGBAData() override;
@@ -26,6 +29,7 @@ public:
 	uint8_t lookBody;
 	uint8_t lookLegs;
 	uint8_t lookFeet;
+	uint64_t cache_key = 0; // Key in GameSprite::template_lookup
 };
 
 #endif
@@ -1,6 +1,7 @@
 #include "rendering/core/texture_atlas.h"
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 #include <spdlog/spdlog.h>
 
 TextureAtlas::TextureAtlas() = default;
@@ -17,15 +18,21 @@ TextureAtlas::TextureAtlas(TextureAtlas&& other) noexcept
 	total_sprite_count_(other.total_sprite_count_),
 	current_layer_(other.current_layer_), next_x_(other.next_x_),
 	next_y_(other.next_y_),
+	growth_limit_(other.growth_limit_),
 	free_slots_(std::move(other.free_slots_)),
-	pbo_(std::move(other.pbo_)) {
+	staging_(std::move(other.staging_)),
+	staging_section_(other.staging_section_),
+	staged_in_section_(other.staged_in_section_),
+	sections_this_frame_(other.sections_this_frame_) {
 	other.layer_count_ = 0;
 	other.allocated_layers_ = 0;
 	other.total_sprite_count_ = 0;
 	other.current_layer_ = 0;
 	other.next_x_ = 0;
 	other.next_y_ = 0;
-	other.pbo_.reset();
+	other.staging_section_ = nullptr;
+	other.staged_in_section_ = 0;
+	other.sections_this_frame_ = 0;
 }
 
 TextureAtlas& TextureAtlas::operator=(TextureAtlas&& other) noexcept {
@@ -38,15 +45,21 @@ TextureAtlas& TextureAtlas::operator=(TextureAtlas&& other) noexcept {
 		current_layer_ = other.current_layer_;
 		next_x_ = other.next_x_;
 		next_y_ = other.next_y_;
+		growth_limit_ = other.growth_limit_;
 		free_slots_ = std::move(other.free_slots_);
-		pbo_ = std::move(other.pbo_);
+		staging_ = std::move(other.staging_);
+		staging_section_ = other.staging_section_;
+		staged_in_section_ = other.staged_in_section_;
+		sections_this_frame_ = other.sections_this_frame_;
 		other.layer_count_ = 0;
 		other.allocated_layers_ = 0;
 		other.total_sprite_count_ = 0;
 		other.current_layer_ = 0;
 		other.next_x_ = 0;
 		other.next_y_ = 0;
-		other.pbo_.reset();
+		other.staging_section_ = nullptr;
+		other.staged_in_section_ = 0;
+		other.sections_this_frame_ = 0;
 	}
 	return *this;
 }
@@ -80,14 +93,13 @@ bool TextureAtlas::initialize(int initial_layers) {
 	next_x_ = 0;
 	next_y_ = 0;
 
-	// Gate PBO because it currently causes random sprite corruption
-#ifdef USE_PBO_FOR_SPRITE_UPLOAD
-	pbo_ = std::make_unique<PixelBufferObject>();
-	if (!pbo_->initialize(SPRITE_SIZE * SPRITE_SIZE * 4)) {
-		spdlog::error("TextureAtlas: Failed to initialize PBO");
-		return false;
+	// Not fatal: without the staging ring every upload is synchronous
+	if (!staging_.initialize(SPRITE_BYTES, UPLOAD_SECTION_SPRITES)) {
+		spdlog::warn("TextureAtlas: Staging buffer unavailable, using synchronous sprite uploads");
 	}
-#endif
+	staging_section_ = nullptr;
+	staged_in_section_ = 0;
+	sections_this_frame_ = 0;
 
 	spdlog::info("TextureAtlas created: {}x{} x {} layers, id={}", ATLAS_SIZE, ATLAS_SIZE, initial_layers, texture_id_->GetID());
 	return true;
@@ -104,6 +116,9 @@ bool TextureAtlas::addLayer() {
 		// Linear growth to prevent massive VRAM spikes
 		// 4 layers = ~268 MB VRAM
 		int new_allocated = std::min(allocated_layers_ + 4, MAX_LAYERS);
+		if (allocated_layers_ < growth_limit_) {
+			new_allocated = std::min(new_allocated, growth_limit_);
+		}
 
 		spdlog::info("TextureAtlas: Expanding {} -> {} layers", allocated_layers_, new_allocated);
 
@@ -191,25 +206,7 @@ std::optional<AtlasRegion> TextureAtlas::addSprite(const uint8_t* rgba_data) {
 	}
 
 	// Upload sprite data to texture array
-	bool uploaded = false;
-	if (pbo_) {
-		void* ptr = pbo_->mapWrite();
-		if (ptr) {
-			memcpy(ptr, rgba_data, SPRITE_SIZE * SPRITE_SIZE * 4);
-			pbo_->unmap();
-
-			pbo_->bind(); // Binds GL_PIXEL_UNPACK_BUFFER
-
-			// Offset is 0 in PBO
-			glTextureSubImage3D(texture_id_->GetID(), 0, pixel_x, pixel_y, layer, SPRITE_SIZE, SPRITE_SIZE, 1, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-
-			pbo_->unbind();
-			pbo_->advance();
-			uploaded = true;
-		}
-	}
-
-	if (!uploaded) {
+	if (!uploadStaged(pixel_x, pixel_y, layer, rgba_data)) {
 		// Fallback synchronously
 		glTextureSubImage3D(texture_id_->GetID(), 0, pixel_x, pixel_y, layer, SPRITE_SIZE, SPRITE_SIZE, 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba_data);
 	}
@@ -230,6 +227,55 @@ std::optional<AtlasRegion> TextureAtlas::addSprite(const uint8_t* rgba_data) {
 	return region;
 }
 
+bool TextureAtlas::uploadStaged(int pixel_x, int pixel_y, int layer, const uint8_t* rgba_data) {
+	if (!staging_.isPersistentlyMapped()) {
+		return false;
+	}
+
+	// A section is only started if the GPU is done reading it from its last
+	// round; rather than wait for that, the upload goes synchronously. Within
+	// a frame the ring wraps around onto sections fenced that same frame,
+	// which are never done yet, so don't even poll past one ring per frame.
+	if (!staging_section_) {
+		if (sections_this_frame_ >= RingBuffer::BUFFER_COUNT) {
+			return false;
+		}
+		staging_section_ = static_cast<uint8_t*>(staging_.tryMap(UPLOAD_SECTION_SPRITES));
+		if (!staging_section_) {
+			return false;
+		}
+		staged_in_section_ = 0;
+		++sections_this_frame_;
+	}
+
+	const size_t offset = staged_in_section_ * SPRITE_BYTES;
+	memcpy(staging_section_ + offset, rgba_data, SPRITE_BYTES);
+
+	// With an unpack buffer bound, the data pointer is an offset into it
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_.getBufferId());
+	glTextureSubImage3D(texture_id_->GetID(), 0, pixel_x, pixel_y, layer, SPRITE_SIZE, SPRITE_SIZE, 1, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(staging_.getCurrentSectionOffset() + offset));
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (++staged_in_section_ == UPLOAD_SECTION_SPRITES) {
+		closeSection();
+	}
+	return true;
+}
+
+void TextureAtlas::closeSection() {
+	if (!staging_section_) {
+		return;
+	}
+	staging_.signalFinished();
+	staging_section_ = nullptr;
+	staged_in_section_ = 0;
+}
+
+void TextureAtlas::fenceUploads() {
+	closeSection();
+	sections_this_frame_ = 0;
+}
+
 void TextureAtlas::freeSlot(const AtlasRegion& region) {
 	FreeSlot slot;
 	slot.pixel_x = region.pixel_x;
@@ -262,6 +308,10 @@ void TextureAtlas::release() {
 		spdlog::info("TextureAtlas releasing resources [ID={}]", texture_id_->GetID());
 	}
 	texture_id_.reset();
+	staging_.cleanup();
+	staging_section_ = nullptr;
+	staged_in_section_ = 0;
+	sections_this_frame_ = 0;
 	layer_count_ = 0;
 	allocated_layers_ = 0;
 	total_sprite_count_ = 0;
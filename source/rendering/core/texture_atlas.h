@@ -2,7 +2,7 @@
 #define RME_RENDERING_CORE_TEXTURE_ATLAS_H_
 
 #include "app/main.h"
-#include "rendering/core/pixel_buffer_object.h"
+#include "rendering/core/ring_buffer.h"
 #include "rendering/core/gl_resources.h"
 #include <optional>
 #include <cstdint>
@@ -21,6 +21,7 @@ struct AtlasRegion {
 	uint32_t debug_sprite_id = 0; // DEBUG: Track which sprite ID owns this region
 	int pixel_x = 0; // Pre-calculated pixel X in the atlas layer
 	int pixel_y = 0; // Pre-calculated pixel Y in the atlas layer
+	mutable uint32_t last_used_frame = 0; // Stamped by SpriteBatch::draw, drives LRU eviction
 
 	static constexpr uint32_t INVALID_SENTINEL = 0xFFFFFFFE;
 };
@@ -32,6 +33,16 @@ struct AtlasRegion {
  * Each sprite is SPRITE_SIZE x SPRITE_SIZE (32x32).
  * This gives SPRITES_PER_ROW (128) sprites per row, and SPRITES_PER_LAYER (16384) per layer.
  *
+ * Uploads are staged through a persistently mapped RingBuffer used as pixel
+ * unpack buffer, so glTextureSubImage3D returns without copying client memory
+ * and the GPU pulls the pixels by DMA. Each ring section holds
+ * UPLOAD_SECTION_SPRITES sprites and is fenced once full or at the end of the
+ * frame (fenceUploads()); a section is only rewritten after its fence signals.
+ * Staging never waits for a fence: at most one ring's worth of sections is
+ * filled per frame, and uploads beyond that, or while the next section is
+ * still in use by the GPU, are synchronous. So is every upload if the ring
+ * is unavailable.
+ *
  * Based on the imgui_renderer_example_readonly reference implementation.
  */
 class TextureAtlas {
@@ -41,6 +52,8 @@ public:
 	static constexpr int SPRITES_PER_ROW = ATLAS_SIZE / SPRITE_SIZE; // 128
 	static constexpr int SPRITES_PER_LAYER = SPRITES_PER_ROW * SPRITES_PER_ROW; // 16384
 	static constexpr int MAX_LAYERS = 64; // 64 * 16384 = 1M+ sprites
+	static constexpr size_t SPRITE_BYTES = SPRITE_SIZE * SPRITE_SIZE * 4;
+	static constexpr size_t UPLOAD_SECTION_SPRITES = 256; // 1 MB per ring section
 
 	TextureAtlas();
 	~TextureAtlas();
@@ -73,6 +86,33 @@ public:
 	 */
 	void freeSlot(const AtlasRegion& region);
 
+	/**
+	 * Check if a sprite can be added without starting a new layer.
+	 */
+	bool hasFreeSlot() const {
+		return !free_slots_.empty() || (isValid() && next_y_ < SPRITES_PER_ROW);
+	}
+
+	/**
+	 * Cap storage reallocation at this many layers while growing below it.
+	 * Growth past the limit is still possible, in the usual steps.
+	 */
+	void setGrowthLimit(int layers) {
+		growth_limit_ = layers;
+	}
+
+	/**
+	 * Flat slot index of a region: layer * SPRITES_PER_LAYER + row * SPRITES_PER_ROW + column.
+	 */
+	static size_t slotIndex(const AtlasRegion& region) {
+		return static_cast<size_t>(region.atlas_index) * SPRITES_PER_LAYER + static_cast<size_t>(region.pixel_y / SPRITE_SIZE) * SPRITES_PER_ROW + static_cast<size_t>(region.pixel_x / SPRITE_SIZE);
+	}
+
+	/**
+	 * Fence the staging section written since the last call, once per frame.
+	 */
+	void fenceUploads();
+
 	/**
 	 * Bind the texture array to a texture slot.
 	 */
@@ -111,9 +151,14 @@ public:
 
 private:
 	bool addLayer();
+	bool uploadStaged(int pixel_x, int pixel_y, int layer, const uint8_t* rgba_data);
+	void closeSection();
 
-	// PBO for async uploads
-	std::unique_ptr<PixelBufferObject> pbo_;
+	// Staging buffer for async uploads
+	RingBuffer staging_;
+	uint8_t* staging_section_ = nullptr; // Mapped start of the section being filled
+	size_t staged_in_section_ = 0;
+	size_t sections_this_frame_ = 0; // Sections started since the last fenceUploads()
 
 	std::unique_ptr<GLTextureResource> texture_id_;
 	int layer_count_ = 0;
@@ -122,6 +167,7 @@ private:
 	int current_layer_ = 0;
 	int next_x_ = 0; // Next slot X in grid
 	int next_y_ = 0; // Next slot Y in grid
+	int growth_limit_ = MAX_LAYERS;
 
 	// Freed slots stored as integer coordinates to avoid float round-trip precision loss
 	struct FreeSlot {
@@ -72,7 +72,8 @@ void TextureGarbageCollector::GarbageCollect(std::vector<GameSprite*>& resident_
 				img->clean(current_time, longevity);
 
 				if (!img->isGLLoaded) {
-					// Image evicted itself during clean()
+					// Image was evicted from the atlas since the last pass
+					img->inResidentSet = false;
 					if (i - 1 < resident_images.size() - 1) {
 						resident_images[i - 1] = resident_images.back();
 					}
@@ -14,6 +14,8 @@
 #include "editor/editor.h"
 #include "ui/map_tab.h"
 
+#include <utility>
+
 PreviewDrawer::PreviewDrawer() {
 }
 
@@ -103,7 +105,7 @@ void PreviewDrawer::draw(SpriteBatch& sprite_batch, MapCanvas* canvas, const Ren
 
 					// Draw items on the tile
 					if (view.zoom <= 10.0 || !options.hide_items_when_zoomed) {
-						for (const auto& item : tile->items) {
+						for (const auto& item : std::as_const(tile->items)) {
 							BlitItemParams params(tile, item.get(), options);
 							params.ephemeral = true;
 							params.alpha = base_alpha;
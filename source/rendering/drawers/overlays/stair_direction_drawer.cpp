@@ -187,7 +187,7 @@ void StairDirectionDrawer::draw(NVGcontext* vg, const RenderView& view, Editor&
 
 	for (int y = view.start_y; y <= view.end_y; ++y) {
 		for (int x = view.start_x; x <= view.end_x; ++x) {
-			Tile* tile = editor.map.getTile(x, y, view.floor);
+			const Tile* tile = editor.map.getTile(x, y, view.floor);
 			if (!tile) continue;
 
 			int direction = resolveDirection(tile->ground.get());
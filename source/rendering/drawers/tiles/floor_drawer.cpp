@@ -15,6 +15,8 @@
 #include "editor/editor.h"
 #include "map/tile.h"
 
+#include <utility>
+
 FloorDrawer::FloorDrawer() {
 }
 
@@ -57,7 +59,7 @@ void FloorDrawer::draw(SpriteBatch& sprite_batch, ItemDrawer* item_drawer, Sprit
 						item_drawer->BlitItem(sprite_batch, sprite_drawer, creature_drawer, draw_x, draw_y, params);
 					}
 					if (view.zoom <= 10.0 || !options.hide_items_when_zoomed) {
-						for (const auto& item : tile->items) {
+						for (const auto& item : std::as_const(tile->items)) {
 							if (options.show_only_grounds && !item->isBorder() && !item->isOptionalBorder())
 								continue;
 							BlitItemParams params(tile, item.get(), options);
@@ -29,6 +29,8 @@
 #include "rendering/core/custom_item_light.h"
 #include "rendering/core/render_timer.h"
 
+#include <utility>
+
 static void tryAddCustomItemLight(LightBuffer* light_buffer, const Position& position, uint16_t clientId, uint32_t elapsed) {
 	const auto* customLight = CustomItemLightManager::instance().find(clientId);
 	if (!customLight) {
@@ -321,7 +323,7 @@ void TileRenderer::DrawTile(SpriteBatch& sprite_batch, TileLocation* location, c
 
 					// Inline preload check â€” skip function call when sprite is simple and loaded (95%+ case)
 					if (!ground_sprite->isSimpleAndLoaded()) {
-						rme::collectTileSprites(ground_sprite, patterns.x, patterns.y, patterns.z, patterns.frame);
+						rme::collectTileSprites(ground_sprite, patterns.x, patterns.y, patterns.z, patterns.frame, position);
 					}
 
 					BlitItemParams params(position, tile->ground.get(), options);
@@ -399,8 +401,9 @@ void TileRenderer::DrawTile(SpriteBatch& sprite_batch, TileLocation* location, c
 
 			bool process_tooltips = options.show_tooltips && map_z == view.floor;
 
-			// items on tile
-			for (const auto& item : tile->items) {
+			// items on tile; read through const so pasted tiles keep sharing
+			// their item list with the copy buffer
+			for (const auto& item : std::as_const(tile->items)) {
 				// Skip non-ground items when show_only_grounds is enabled
 				if (options.show_only_grounds && !item->isBorder() && !item->isOptionalBorder())
 					continue;
@@ -459,7 +462,7 @@ void TileRenderer::DrawTile(SpriteBatch& sprite_batch, TileLocation* location, c
 
 					// Inline preload check â€” skip function call when sprite is simple and loaded
 					if (!sprite->isSimpleAndLoaded()) {
-						rme::collectTileSprites(sprite, patterns.x, patterns.y, patterns.z, patterns.frame);
+						rme::collectTileSprites(sprite, patterns.x, patterns.y, patterns.z, patterns.frame, position);
 					}
 
 					BlitItemParams params(position, item.get(), options);
@@ -536,6 +539,6 @@ void TileRenderer::PreloadItem(const Tile* tile, Item* item, const ItemDefinitio
 		} else {
 			patterns = PatternCalculator::Calculate(spr, it, item, tile, tile->getPosition());
 		}
-		rme::collectTileSprites(spr, patterns.x, patterns.y, patterns.z, patterns.frame);
+		rme::collectTileSprites(spr, patterns.x, patterns.y, patterns.z, patterns.frame, tile->getPosition());
 	}
 }
@@ -30,6 +30,7 @@
 #include "editor/copybuffer.h"
 #include "live/live_socket.h"
 #include "rendering/core/graphics.h"
+#include "rendering/core/sprite_preloader.h"
 
 #include "brushes/doodad/doodad_brush.h"
 #include "brushes/creature/creature_brush.h"
@@ -350,6 +351,7 @@ void MapDrawer::Release() {
 
 void MapDrawer::Draw() {
 	g_gui.gfx.updateTime();
+	SpritePreloader::get().setViewFocus((view.start_x + view.end_x) / 2, (view.start_y + view.end_y) / 2, view.floor);
 
 	light_buffer.Clear();
 
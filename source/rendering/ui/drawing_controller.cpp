@@ -179,6 +179,7 @@ void DrawingController::HandleClick(const Position& mouse_map_pos, bool shift_do
 						int tiles_h = static_cast<int>(sh * canvas->zoom / TILE_SIZE) + 2;
 						fill_area.width = std::max(tiles_w, 10);
 						fill_area.height = std::max(tiles_h, 10);
+						fill_area.max_tiles = std::max(1, g_settings.getInteger(Config::FLOOD_FILL_LIMIT));
 					}
 					BrushUtility::GetTilesToDraw(mouse_map_pos.x, mouse_map_pos.y, mouse_map_pos.z, &tilestodraw, &tilestoborder, fill, fill_area);
 
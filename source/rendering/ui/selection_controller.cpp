@@ -463,7 +463,6 @@ void SelectionController::ExecuteBoundboxSelection(const Position& start_pos, co
 		std::swap(start_y, end_y);
 	}
 
-	int numtiles = 0;
 	int threadcount = std::max(g_settings.getInteger(Config::WORKER_THREADS), 1);
 
 	int s_x = 0, s_y = 0, s_z = 0;
@@ -493,8 +492,6 @@ void SelectionController::ExecuteBoundboxSelection(const Position& start_pos, co
 				e_x -= (floor < GROUND_LAYER ? GROUND_LAYER - floor : 0);
 				e_y -= (floor < GROUND_LAYER ? GROUND_LAYER - floor : 0);
 			}
-
-			numtiles = (s_z - e_z) * (e_x - s_x) * (e_y - s_y);
 			break;
 		}
 		case SELECT_VISIBLE_FLOORS: {
@@ -520,36 +517,34 @@ void SelectionController::ExecuteBoundboxSelection(const Position& start_pos, co
 		}
 	}
 
+	const int numtiles = (s_z - e_z + 1) * (e_x - s_x + 1) * (e_y - s_y + 1);
 	if (numtiles < 500) {
 		// No point in threading for such a small set.
 		threadcount = 1;
 	}
-	// Subdivide the selection area
-	// We know it's a square, just split it into several areas
-	int width = e_x - s_x;
-	if (width < threadcount) {
-		threadcount = std::min(1, width);
-	}
-	// Let's divide!
-	int remainder = width;
-	int cleared = 0;
+	// Subdivide the selection area into bands of whole SpatialHashGrid cells
+	// along its longer side. Bands never overlap, so every tile is copied by
+	// exactly one worker and each worker walks its own cells.
+	const bool split_x = (e_x - s_x) >= (e_y - s_y);
+	const int band_start = split_x ? s_x : s_y;
+	const int band_end = split_x ? e_x : e_y;
+	const int first_cell = band_start >> SpatialHashGrid::CELL_SHIFT;
+	const int cell_count = (band_end >> SpatialHashGrid::CELL_SHIFT) - first_cell + 1;
+	threadcount = std::min(threadcount, cell_count);
+
 	std::vector<std::unique_ptr<SelectionThread>> threads;
-	if (width == 0) {
-		threads.push_back(std::make_unique<SelectionThread>(editor, Position(s_x, s_y, s_z), Position(s_x, e_y, e_z), creatures_only));
-	} else {
-		for (int i = 0; i < threadcount; ++i) {
-			int chunksize = width / threadcount;
-			// The last threads takes all the remainder
-			if (i == threadcount - 1) {
-				chunksize = remainder;
-			}
-			threads.push_back(std::make_unique<SelectionThread>(editor, Position(s_x + cleared, s_y, s_z), Position(s_x + cleared + chunksize, e_y, e_z), creatures_only));
-			cleared += chunksize;
-			remainder -= chunksize;
+	int next_cell = first_cell;
+	for (int i = 0; i < threadcount; ++i) {
+		const int cells = cell_count / threadcount + (i < cell_count % threadcount ? 1 : 0);
+		const int from = std::max(band_start, next_cell << SpatialHashGrid::CELL_SHIFT);
+		next_cell += cells;
+		const int to = std::min(band_end, (next_cell << SpatialHashGrid::CELL_SHIFT) - 1);
+		if (split_x) {
+			threads.push_back(std::make_unique<SelectionThread>(editor, Position(from, s_y, s_z), Position(to, e_y, e_z), creatures_only));
+		} else {
+			threads.push_back(std::make_unique<SelectionThread>(editor, Position(s_x, from, s_z), Position(e_x, to, e_z), creatures_only));
 		}
 	}
-	ASSERT(cleared == width);
-	ASSERT(remainder == 0);
 
 	editor.selection.start(); // Start a selection session
 	for (auto& thread : threads) {
@@ -19,8 +19,9 @@
 #include "rendering/utilities/light_drawer.h"
 #include "rendering/utilities/light_calculator.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
 #include <format>
-#include <limits>
 #include "map/tile.h"
 #include "game/item.h"
 #include "rendering/core/drawing_options.h"
@@ -31,6 +32,24 @@
 
 // GPULight struct moved to header
 
+namespace {
+	// Uploads data into an immutable SSBO, recreating it with 1.5x headroom when too small
+	void uploadStorage(std::unique_ptr<GLBuffer>& buffer, size_t& capacity, const void* data, size_t size) {
+		if (!buffer || size > capacity) {
+			capacity = std::max(size, static_cast<size_t>(capacity * 1.5));
+			if (capacity < 1024) {
+				capacity = 1024;
+			}
+			// Destroy and recreate buffer for Immutable Storage
+			buffer = std::make_unique<GLBuffer>();
+			glNamedBufferStorage(buffer->GetID(), capacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+		}
+		if (size > 0) {
+			glNamedBufferSubData(buffer->GetID(), 0, size, data);
+		}
+	}
+}
+
 LightDrawer::LightDrawer() {
 }
 
@@ -123,22 +142,11 @@ void LightDrawer::draw(const RenderView& view, bool fog, const LightBuffer& ligh
 								.color = { (c.Red() / 255.0f) * light_intensity, (c.Green() / 255.0f) * light_intensity, (c.Blue() / 255.0f) * light_intensity, 1.0f } });
 	}
 
-	if (gpu_lights_.empty()) {
-		// Just render ambient? We still need to clear the FBO/screen area or simpy fill it.
-		// If no lights, the overlay should just be ambient color.
-	} else {
-		// Upload Lights
-		size_t needed_size = gpu_lights_.size() * sizeof(GPULight);
-		if (needed_size > light_ssbo_capacity_) {
-			light_ssbo_capacity_ = std::max(needed_size, static_cast<size_t>(light_ssbo_capacity_ * 1.5));
-			if (light_ssbo_capacity_ < 1024) {
-				light_ssbo_capacity_ = 1024;
-			}
-			// Destroy and recreate buffer for Immutable Storage
-			light_ssbo = std::make_unique<GLBuffer>();
-			glNamedBufferStorage(light_ssbo->GetID(), light_ssbo_capacity_, nullptr, GL_DYNAMIC_STORAGE_BIT);
-		}
-		glNamedBufferSubData(light_ssbo->GetID(), 0, needed_size, gpu_lights_.data());
+	if (!gpu_lights_.empty()) {
+		uploadStorage(light_ssbo, light_ssbo_capacity_, gpu_lights_.data(), gpu_lights_.size() * sizeof(GPULight));
+		binLights(buffer_w, buffer_h, static_cast<float>(TILE_SIZE) / view.zoom);
+		uploadStorage(tile_ssbo, tile_ssbo_capacity_, tile_ranges_.data(), tile_ranges_.size() * sizeof(uint32_t));
+		uploadStorage(tile_index_ssbo, tile_index_ssbo_capacity_, tile_light_indices_.data(), tile_light_indices_.size() * sizeof(uint32_t));
 	}
 
 	// 3. Render to FBO
@@ -172,49 +180,24 @@ void LightDrawer::draw(const RenderView& view, bool fog, const LightBuffer& ligh
 
 		if (!gpu_lights_.empty()) {
 			shader->Use();
-
-			// Setup Projection for FBO: Ortho 0..buffer_w, buffer_h..0 (Y-down)
-			// This matches screen coordinate system and avoids flips
-			glm::mat4 fbo_projection = glm::ortho(0.0f, static_cast<float>(buffer_w), static_cast<float>(buffer_h), 0.0f);
-			shader->SetMat4("uProjection", fbo_projection);
+			shader->SetInt("uMode", 0);
 			shader->SetFloat("uTileSize", static_cast<float>(TILE_SIZE) / view.zoom);
+			shader->SetFloat("uBufferHeight", static_cast<float>(buffer_h));
+			shader->SetInt("uLightTileSize", LIGHT_TILE_SIZE);
+			shader->SetInt("uTilesX", tiles_x_);
 
-			// Shadow occlusion: upload blocking grid as SSBO
+			// Shadow occlusion: blocking grid as R8UI texture on unit 1
 			bool use_shadow = shadow_occlusion && blocking && blocking->width > 0 && blocking->height > 0;
 			shader->SetInt("uShadowEnabled", use_shadow ? 1 : 0);
 
 			if (use_shadow) {
-				// Prepare blocking SSBO data: 4 ints header + flat data
-				size_t header_size = 4 * sizeof(int32_t);
-				size_t data_size = blocking->data.size() * sizeof(int32_t); // expand to int32 for SSBO alignment
-				size_t total_size = header_size + data_size;
-
-				if (total_size > blocking_ssbo_capacity_) {
-					blocking_ssbo_capacity_ = std::max(total_size, static_cast<size_t>(blocking_ssbo_capacity_ * 1.5));
-					if (blocking_ssbo_capacity_ < 1024) {
-						blocking_ssbo_capacity_ = 1024;
-					}
-					blocking_ssbo = std::make_unique<GLBuffer>();
-					glNamedBufferStorage(blocking_ssbo->GetID(), blocking_ssbo_capacity_, nullptr, GL_DYNAMIC_STORAGE_BIT);
-				}
-
-				// Upload header
-				int32_t header[4] = {
-					static_cast<int32_t>(blocking->origin_x),
-					static_cast<int32_t>(blocking->origin_y),
-					static_cast<int32_t>(blocking->width),
-					static_cast<int32_t>(blocking->height)
-				};
-				glNamedBufferSubData(blocking_ssbo->GetID(), 0, header_size, header);
-
-				// Upload blocking data (expand uint8 to int32 for shader)
-				std::vector<int32_t> blocking_int(blocking->data.size());
-				for (size_t i = 0; i < blocking->data.size(); ++i) {
-					blocking_int[i] = blocking->data[i];
-				}
-				glNamedBufferSubData(blocking_ssbo->GetID(), header_size, data_size, blocking_int.data());
-
-				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, blocking_ssbo->GetID());
+				uploadBlockingGrid(*blocking);
+				glBindTextureUnit(1, blocking_texture->GetID());
+				shader->SetInt("uBlocking", 1);
+				shader->SetInt("uGridOriginX", blocking->origin_x);
+				shader->SetInt("uGridOriginY", blocking->origin_y);
+				shader->SetInt("uGridWidth", blocking->width);
+				shader->SetInt("uGridHeight", blocking->height);
 
 				// Pass view parameters for tile coordinate conversion
 				shader->SetFloat("uViewScrollX", static_cast<float>(view.view_scroll_x));
@@ -223,21 +206,22 @@ void LightDrawer::draw(const RenderView& view, bool fog, const LightBuffer& ligh
 			}
 
 			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, light_ssbo->GetID());
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, tile_ssbo->GetID());
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, tile_index_ssbo->GetID());
 			glBindVertexArray(vao->GetID());
 
-			// Enable MAX blending
+			// One screen-covering pass: each fragment only visits the lights of
+			// its tile and writes their maximum, MAX-blended over the ambient.
 			{
 				ScopedGLCapability blendCap(GL_BLEND);
 				ScopedGLBlend blendState(GL_ONE, GL_ONE, GL_MAX); // Factors don't matter much for MAX, but usually 1,1 is safe
-
-				if (gpu_lights_.size() > static_cast<size_t>(std::numeric_limits<GLsizei>::max())) {
-					spdlog::error("Too many lights for glDrawArraysInstanced");
-					return;
-				}
-				glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, static_cast<GLsizei>(gpu_lights_.size()));
+				glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 			}
 
 			glBindVertexArray(0);
+			if (use_shadow) {
+				glBindTextureUnit(1, 0);
+			}
 		}
 	}
 
@@ -302,58 +286,116 @@ void LightDrawer::draw(const RenderView& view, bool fog, const LightBuffer& ligh
 	shader->SetInt("uMode", 0); // Reset
 }
 
+void LightDrawer::binLights(int buffer_w, int buffer_h, float tile_size_px) {
+	tiles_x_ = (buffer_w + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+	tiles_y_ = (buffer_h + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+	const size_t tile_count = static_cast<size_t>(tiles_x_) * tiles_y_;
+
+	// Tile span of every light, clamped to the screen
+	auto tileSpan = [&](const GPULight& light, int& x0, int& y0, int& x1, int& y1) {
+		const float radius = light.intensity * tile_size_px;
+		x0 = std::clamp(static_cast<int>(std::floor((light.position.x - radius) / LIGHT_TILE_SIZE)), 0, tiles_x_ - 1);
+		y0 = std::clamp(static_cast<int>(std::floor((light.position.y - radius) / LIGHT_TILE_SIZE)), 0, tiles_y_ - 1);
+		x1 = std::clamp(static_cast<int>(std::floor((light.position.x + radius) / LIGHT_TILE_SIZE)), 0, tiles_x_ - 1);
+		y1 = std::clamp(static_cast<int>(std::floor((light.position.y + radius) / LIGHT_TILE_SIZE)), 0, tiles_y_ - 1);
+	};
+
+	// Counting sort: count per tile, turn counts into offsets, then fill
+	tile_ranges_.assign(tile_count * 2, 0);
+	for (const GPULight& light : gpu_lights_) {
+		int x0, y0, x1, y1;
+		tileSpan(light, x0, y0, x1, y1);
+		for (int ty = y0; ty <= y1; ++ty) {
+			for (int tx = x0; tx <= x1; ++tx) {
+				++tile_ranges_[(static_cast<size_t>(ty) * tiles_x_ + tx) * 2 + 1];
+			}
+		}
+	}
+
+	uint32_t offset = 0;
+	for (size_t tile = 0; tile < tile_count; ++tile) {
+		tile_ranges_[tile * 2] = offset;
+		offset += tile_ranges_[tile * 2 + 1];
+		tile_ranges_[tile * 2 + 1] = 0;
+	}
+
+	tile_light_indices_.resize(offset);
+	for (uint32_t index = 0; index < gpu_lights_.size(); ++index) {
+		int x0, y0, x1, y1;
+		tileSpan(gpu_lights_[index], x0, y0, x1, y1);
+		for (int ty = y0; ty <= y1; ++ty) {
+			for (int tx = x0; tx <= x1; ++tx) {
+				const size_t tile = static_cast<size_t>(ty) * tiles_x_ + tx;
+				tile_light_indices_[tile_ranges_[tile * 2] + tile_ranges_[tile * 2 + 1]++] = index;
+			}
+		}
+	}
+}
+
+void LightDrawer::uploadBlockingGrid(const LightBuffer::BlockingGrid& grid) {
+	if (!blocking_texture || grid.width > blocking_texture_width_ || grid.height > blocking_texture_height_) {
+		blocking_texture_width_ = std::max(grid.width, blocking_texture_width_);
+		blocking_texture_height_ = std::max(grid.height, blocking_texture_height_);
+		blocking_texture = std::make_unique<GLTextureResource>(GL_TEXTURE_2D);
+		glTextureStorage2D(blocking_texture->GetID(), 1, GL_R8UI, blocking_texture_width_, blocking_texture_height_);
+		glTextureParameteri(blocking_texture->GetID(), GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(blocking_texture->GetID(), GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		uploaded_blocking_ = {};
+	}
+
+	// Rows are tightly packed bytes
+	GLint previous_alignment = 4;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &previous_alignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	auto uploadRows = [&](int first, int count) {
+		glTextureSubImage2D(blocking_texture->GetID(), 0, 0, first, grid.width, count, GL_RED_INTEGER, GL_UNSIGNED_BYTE, grid.data.data() + static_cast<size_t>(first) * grid.width);
+	};
+
+	const bool same_layout = uploaded_blocking_.origin_x == grid.origin_x && uploaded_blocking_.origin_y == grid.origin_y && uploaded_blocking_.width == grid.width && uploaded_blocking_.height == grid.height && uploaded_blocking_.data.size() == grid.data.size();
+	if (!same_layout) {
+		uploadRows(0, grid.height);
+	} else {
+		// Send each run of consecutive changed rows as one sub-image
+		const size_t row_bytes = static_cast<size_t>(grid.width);
+		int run_start = -1;
+		for (int row = 0; row <= grid.height; ++row) {
+			const bool changed = row < grid.height && !std::equal(grid.data.begin() + row * row_bytes, grid.data.begin() + (row + 1) * row_bytes, uploaded_blocking_.data.begin() + row * row_bytes);
+			if (changed && run_start < 0) {
+				run_start = row;
+			} else if (!changed && run_start >= 0) {
+				uploadRows(run_start, row - run_start);
+				run_start = -1;
+			}
+		}
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, previous_alignment);
+	uploaded_blocking_ = grid;
+}
+
 void LightDrawer::initRenderResources() {
-	// Modes: 0 = Light Generation (Instanced), 1 = Composite (Simple Texture)
+	// Modes: 0 = Tiled Light Accumulation (screen quad), 1 = Composite (Simple Texture)
 	const char* vs = R"(
 		#version 450 core
 		layout (location = 0) in vec2 aPos; // 0..1 Quad
 
 		uniform int uMode;
 		uniform mat4 uProjection;
-		uniform float uTileSize;
 		uniform vec2 uUVMin;
 		uniform vec2 uUVMax;
 
-		struct Light {
-			vec2 position;
-			float intensity;
-			float padding;
-			vec4 color;
-		};
-		layout(std430, binding = 0) buffer LightBlock {
-			Light uLights[];
-		};
-
 		out vec2 TexCoord;
-		out vec4 FragColor; // For Mode 0
-		flat out vec2 LightScreenPos; // Light center in screen pixels (for shadow)
-		flat out float LightIntensity; // Light intensity in tiles (for shadow)
 
 		void main() {
 			if (uMode == 0) {
-				// LIGHT GENERATION
-				Light l = uLights[gl_InstanceID];
-
-				float radiusPx = l.intensity * uTileSize;
-				float size = radiusPx * 2.0;
-
-				vec2 center = l.position;
-
-				vec2 localPos = (aPos - 0.5) * size;
-				vec2 worldPos = center + localPos;
-
-				gl_Position = uProjection * vec4(worldPos, 0.0, 1.0);
-
-				TexCoord = aPos - 0.5; // -0.5 to 0.5
-				FragColor = l.color;
-				LightScreenPos = center;
-				LightIntensity = l.intensity;
+				// LIGHT ACCUMULATION: cover the whole viewport
+				gl_Position = vec4(aPos * 2.0 - 1.0, 0.0, 1.0);
+				TexCoord = aPos;
 			} else {
 				// COMPOSITE
 				gl_Position = uProjection * vec4(aPos, 0.0, 1.0);
 				TexCoord = mix(uUVMin, uUVMax, aPos);
-				LightScreenPos = vec2(0.0);
-				LightIntensity = 0.0;
 			}
 		}
 	)";
@@ -361,31 +403,44 @@ void LightDrawer::initRenderResources() {
 	const char* fs = R"(
 		#version 450 core
 		in vec2 TexCoord;
-		in vec4 FragColor; // From VS
-		flat in vec2 LightScreenPos;
-		flat in float LightIntensity;
 
 		uniform int uMode;
 		uniform sampler2D uTexture;
+		uniform usampler2D uBlocking;
 		uniform int uShadowEnabled;
 		uniform float uViewScrollX;
 		uniform float uViewScrollY;
 		uniform float uZoom;
-		uniform float uTileSize;
-
-		layout(std430, binding = 1) buffer BlockingBlock {
-			int gridOriginX;
-			int gridOriginY;
-			int gridWidth;
-			int gridHeight;
-			int blockingData[];
+		uniform float uTileSize; // Screen pixels per map tile
+		uniform float uBufferHeight;
+		uniform int uLightTileSize;
+		uniform int uTilesX;
+		uniform int uGridOriginX;
+		uniform int uGridOriginY;
+		uniform int uGridWidth;
+		uniform int uGridHeight;
+
+		struct Light {
+			vec2 position;
+			float intensity;
+			float padding;
+			vec4 color;
+		};
+		layout(std430, binding = 0) readonly buffer LightBlock {
+			Light uLights[];
+		};
+		layout(std430, binding = 2) readonly buffer TileBlock {
+			uvec2 uTileRanges[]; // offset, count into uTileLights
+		};
+		layout(std430, binding = 3) readonly buffer TileLightBlock {
+			uint uTileLights[];
 		};
 
 		bool isTileBlocked(int tx, int ty) {
-			int lx = tx - gridOriginX;
-			int ly = ty - gridOriginY;
-			if (lx < 0 || lx >= gridWidth || ly < 0 || ly >= gridHeight) return false;
-			return blockingData[ly * gridWidth + lx] != 0;
+			int lx = tx - uGridOriginX;
+			int ly = ty - uGridOriginY;
+			if (lx < 0 || lx >= uGridWidth || ly < 0 || ly >= uGridHeight) return false;
+			return texelFetch(uBlocking, ivec2(lx, ly), 0).r != 0u;
 		}
 
 		bool rayBlocked(ivec2 from, ivec2 to) {
@@ -408,43 +463,41 @@ void LightDrawer::initRenderResources() {
 			return false;
 		}
 
-		float getShadowVisibility(vec2 fragScreenPos) {
-			// Convert screen position to map tile coordinates
-			float tilePixels = uTileSize * uZoom; // should not be needed, uTileSize is already in screen pixels
-			// Actually uTileSize = TILE_SIZE / zoom in the draw code
-			// fragScreenPos is in FBO screen pixels
-			// map_x = (fragScreenPos.x * zoom + viewScrollX) / TILE_SIZE
+		// Map tile under a point given in FBO screen pixels (Y-down)
+		ivec2 mapTileAt(vec2 screenPos) {
 			float tileSizeMap = uTileSize * uZoom; // = TILE_SIZE (map pixels per tile)
-			int fragTileX = int(floor((fragScreenPos.x * uZoom + uViewScrollX) / tileSizeMap));
-			int fragTileY = int(floor((fragScreenPos.y * uZoom + uViewScrollY) / tileSizeMap));
-			int lightTileX = int(floor((LightScreenPos.x * uZoom + uViewScrollX) / tileSizeMap));
-			int lightTileY = int(floor((LightScreenPos.y * uZoom + uViewScrollY) / tileSizeMap));
-
-			// Single-sample ray for performance
-			if (rayBlocked(ivec2(lightTileX, lightTileY), ivec2(fragTileX, fragTileY))) {
-				return 0.0;
-			}
-			return 1.0;
+			return ivec2(floor((screenPos * uZoom + vec2(uViewScrollX, uViewScrollY)) / tileSizeMap));
 		}
 
 		out vec4 OutColor;
 
 		void main() {
 			if (uMode == 0) {
-				// Light Falloff
-				float dist = length(TexCoord) * 2.0;
-				if (dist > 1.0) discard;
-
-				float falloff = 1.0 - dist;
+				// The FBO projection is Y-down, gl_FragCoord is Y-up
+				vec2 screenPos = vec2(gl_FragCoord.x, uBufferHeight - gl_FragCoord.y);
+				ivec2 tile = ivec2(screenPos) / uLightTileSize;
+				uvec2 range = uTileRanges[tile.y * uTilesX + tile.x];
+				if (range.y == 0u) discard;
+
+				ivec2 fragTile = uShadowEnabled != 0 ? mapTileAt(screenPos) : ivec2(0);
+				vec4 result = vec4(0.0);
+				for (uint i = 0u; i < range.y; ++i) {
+					Light l = uLights[uTileLights[range.x + i]];
+
+					// Light Falloff
+					float dist = length(screenPos - l.position) / (l.intensity * uTileSize);
+					if (dist > 1.0) continue;
+					float falloff = 1.0 - dist;
+
+					// Shadow occlusion (single-sample ray for performance)
+					if (uShadowEnabled != 0 && rayBlocked(mapTileAt(l.position), fragTile)) {
+						continue;
+					}
 
-				// Shadow occlusion
-				if (uShadowEnabled != 0) {
-					// Get fragment position in screen pixels from gl_FragCoord
-					float visibility = getShadowVisibility(gl_FragCoord.xy);
-					falloff *= visibility;
+					result = max(result, l.color * falloff);
 				}
-
-				OutColor = FragColor * falloff;
+				if (result == vec4(0.0)) discard;
+				OutColor = result;
 			} else {
 				// Texture fetch
 				OutColor = texture(uTexture, TexCoord);
@@ -51,6 +51,9 @@ public:
 	// Draw zone-based ambient darkening overlay on the FBO
 	void drawZoneAmbient(const RenderView& view, const ForcedLightZone& zone);
 
+	// Lights are binned into square screen tiles of this many FBO pixels
+	static constexpr int LIGHT_TILE_SIZE = 32;
+
 private:
 	std::unique_ptr<ShaderProgram> shader;
 	std::unique_ptr<GLVertexArray> vao;
@@ -58,10 +61,27 @@ private:
 	std::unique_ptr<GLBuffer> light_ssbo;
 	size_t light_ssbo_capacity_ = 0;
 
-	std::unique_ptr<GLBuffer> blocking_ssbo;
-	size_t blocking_ssbo_capacity_ = 0;
+	// Per-tile light lists: (offset, count) per tile into tile_light_indices_
+	std::unique_ptr<GLBuffer> tile_ssbo;
+	size_t tile_ssbo_capacity_ = 0;
+	std::unique_ptr<GLBuffer> tile_index_ssbo;
+	size_t tile_index_ssbo_capacity_ = 0;
 
 	std::vector<GPULight> gpu_lights_;
+	std::vector<uint32_t> tile_ranges_;
+	std::vector<uint32_t> tile_light_indices_;
+	int tiles_x_ = 0;
+	int tiles_y_ = 0;
+
+	// Blocking grid as an R8UI texture; only rows that changed since the last
+	// upload are sent again while the grid keeps its origin and size.
+	std::unique_ptr<GLTextureResource> blocking_texture;
+	int blocking_texture_width_ = 0;
+	int blocking_texture_height_ = 0;
+	LightBuffer::BlockingGrid uploaded_blocking_;
+
+	void binLights(int buffer_w, int buffer_h, float tile_size_px);
+	void uploadBlockingGrid(const LightBuffer::BlockingGrid& grid);
 
 	std::unique_ptr<GLFramebuffer> fbo;
 	std::unique_ptr<GLTextureResource> fbo_texture;
@@ -289,7 +289,15 @@ bool MainFrame::DoQuerySave(bool doclose) {
 
 		editor.live_manager.CloseServer();
 		return DoQuerySave(doclose);
-	} else if (g_gui.ShouldSave()) {
+	}
+
+	// A save still being written decides whether anything is left to save; if
+	// it failed, its error has been shown and the map stays open
+	if (!editor.background_save.wait().empty()) {
+		return false;
+	}
+
+	if (g_gui.ShouldSave()) {
 		long ret = DialogUtil::PopupDialog(
 			"Save changes",
 			"Do you want to save your changes to \"" + wxstr(g_gui.GetCurrentMap().getName()) + "\"?",
@@ -308,6 +316,11 @@ bool MainFrame::DoQuerySave(bool doclose) {
 					return false;
 				}
 			}
+
+			// Closing waits for the files to reach the disk
+			if (!editor.background_save.wait().empty() || editor.map.hasChanged()) {
+				return false;
+			}
 		} else if (ret == wxID_CANCEL) {
 			return false;
 		}
@@ -4,6 +4,7 @@
 
 #include "app/main.h"
 #include "ui/managers/minimap_manager.h"
+#include "editor/dirty_list.h"
 #include "app/managers/version_manager.h"
 #include "map/map.h"
 #include "map/position.h"
@@ -123,6 +124,30 @@ void MinimapManager::MarkTileDirty(const Map& map, const Position& position) {
 	});
 }
 
+void MinimapManager::MarkNodesDirty(const Map& map, const DirtyList& dirty_list) {
+	if (dirty_list.Empty()) {
+		return;
+	}
+
+	auto& pending = pending_invalidations_[makeKey(map)];
+	if (pending.invalidate_all) {
+		return;
+	}
+
+	dirty_list.ForEachNodeRect([&pending](const DirtyList::NodeRect& rect) {
+		for (int z = 0; z < MAP_LAYERS; ++z) {
+			if (rect.floors & (1u << z)) {
+				pending.floor_rects[z].push_back(MinimapDirtyRect {
+					.x = rect.x,
+					.y = rect.y,
+					.width = rect.width,
+					.height = rect.height,
+				});
+			}
+		}
+	});
+}
+
 PendingMinimapInvalidation MinimapManager::TakePendingInvalidation(const Map& map) {
 	const InvalidationKey key = makeKey(map);
 	auto it = pending_invalidations_.find(key);
@@ -14,15 +14,17 @@
 #include <vector>
 
 class MinimapWindow;
+class DirtyList;
 class Map;
 class Position;
 
 struct PendingMinimapInvalidation {
 	bool invalidate_all = false;
-	// One rect per tile modification; we intentionally do not union them into a
-	// bounding box because the uploader would then re-write every tile inside
-	// the box (including empty ones) with color 0, which previously produced
-	// visible black streaks between distant painted points.
+	// One rect per modified tile or per coalesced run of modified nodes; we
+	// intentionally do not union them into a bounding box because the uploader
+	// would then re-write every tile inside the box (including empty ones) with
+	// color 0, which previously produced visible black streaks between distant
+	// painted points.
 	std::array<std::vector<MinimapDirtyRect>, MAP_LAYERS> floor_rects;
 };
 
@@ -38,6 +40,8 @@ public:
 	bool IsVisible() const;
 	void InvalidateAll(const Map& map);
 	void MarkTileDirty(const Map& map, const Position& position);
+	// Marks every node of the list dirty, one rect per coalesced node run.
+	void MarkNodesDirty(const Map& map, const DirtyList& dirty_list);
 	PendingMinimapInvalidation TakePendingInvalidation(const Map& map);
 
 	MinimapWindow* GetWindow() {
@@ -82,6 +82,23 @@ void MapStatisticsDialog::Show(wxWindow* parent) {
 		os << "\t\tLargest House: \"" << stats.largest_house->name << "\" (" << stats.largest_house_size << " sqm)\n";
 	}
 
+	os << "\tFloors:\n";
+	for (size_t z = 0; z < stats.floors.size(); ++z) {
+		const TileStatistics& floor = stats.floors[z];
+		if (floor.empty()) {
+			continue;
+		}
+		os << "\t\tFloor " << z << ": " << floor.tile_count << " tiles, " << floor.item_count << " items, " << floor.spawn_count << " spawns, " << floor.creature_count << " creatures\n";
+	}
+
+	if (!stats.towns.empty()) {
+		os << "\tTowns:\n";
+		for (const TownStatistics& town : stats.towns) {
+			const std::string town_name = town.town ? std::string(town.town->getName()) : "Town #" + std::to_string(town.town_id);
+			os << "\t\t\"" << town_name << "\": " << town.house_count << " houses, " << town.house_sqm << " sqm, " << town.tile_count << " tiles, " << town.item_count << " items\n";
+		}
+	}
+
 	os << "\n";
 	os << "Generated by Remere's Map Editor version " + __RME_VERSION__ + "\n";
 
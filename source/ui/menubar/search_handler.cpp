@@ -59,7 +59,7 @@ namespace {
 		const uint32_t page_limit = searchResultsLimit();
 		EditorOperations::ItemSearcher finder(item_id, page_limit, page_offset);
 		g_gui.CreateLoadBar(load_bar_label);
-		foreach_ItemOnMap(*search_map, finder, false);
+		foreach_ItemWithIdOnMap(*search_map, item_id, finder);
 		g_gui.DestroyLoadBar();
 
 		SearchResultWindow* window = g_gui.ShowSearchWindow();
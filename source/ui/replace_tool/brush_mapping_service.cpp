@@ -60,13 +60,13 @@ const char* BrushMappingService::GetFamilyName(const Brush* brush) {
 namespace {
 
 	// Maps a ground-brush item (center or border) onto the destination ground brush.
-	BrushMappingService::MapResult MapGroundItem(const Item* item, GroundBrush* fromGround, GroundBrush* toGround) {
+	BrushMappingService::MapResult MapGroundItem(const Item* item, GroundBrush* fromGround, GroundBrush* toGround, std::mt19937& rng) {
 		BrushMappingService::MapResult result;
 
 		// 1. Ground center: the item is the brush's own ground tile.
 		if (item->getGroundBrush() == fromGround) {
 			result.matched = true;
-			result.newId = toGround->getRandomGroundItemId();
+			result.newId = toGround->getRandomGroundItemId(rng);
 			result.resolved = (result.newId != 0);
 			return result;
 		}
@@ -123,7 +123,7 @@ namespace {
 				return result; // matched but unresolved: caller keeps the original item
 			}
 
-			result.newId = (uint16_t)destBorder->getRandomTileId(dir);
+			result.newId = (uint16_t)destBorder->getRandomTileId(dir, rng);
 			result.resolved = (result.newId != 0);
 			return result;
 		}
@@ -133,7 +133,7 @@ namespace {
 
 	// Maps a wall item onto the destination wall brush, preserving the segment
 	// alignment and, for doors/windows, the DoorType (and locked flag when possible).
-	BrushMappingService::MapResult MapWallItem(const Item* item, WallBrush* fromWall, WallBrush* toWall) {
+	BrushMappingService::MapResult MapWallItem(const Item* item, WallBrush* fromWall, WallBrush* toWall, std::mt19937& rng) {
 		BrushMappingService::MapResult result;
 		const uint16_t id = item->getID();
 		if (id == 0) {
@@ -143,7 +143,7 @@ namespace {
 		for (int align = 0; align < WallBrushItems::WALL_ALIGNMENT_COUNT; ++align) {
 			if (fromWall->items.hasWall(id, align)) {
 				result.matched = true;
-				result.newId = toWall->items.getRandomWallId(align);
+				result.newId = toWall->items.getRandomWallId(align, rng);
 				result.resolved = (result.newId != 0);
 				return result;
 			}
@@ -185,7 +185,7 @@ namespace {
 					// The destination brush has no door of this type in this
 					// alignment: fall back to a solid wall segment rather than
 					// leaving an orphan item from the old brush behind.
-					result.newId = toWall->items.getRandomWallId(align);
+					result.newId = toWall->items.getRandomWallId(align, rng);
 				}
 				result.resolved = (result.newId != 0);
 				return result;
@@ -196,7 +196,7 @@ namespace {
 	}
 
 	// Maps a carpet item onto the destination carpet brush by alignment group.
-	BrushMappingService::MapResult MapCarpetItem(const Item* item, CarpetBrush* fromCarpet, CarpetBrush* toCarpet) {
+	BrushMappingService::MapResult MapCarpetItem(const Item* item, CarpetBrush* fromCarpet, CarpetBrush* toCarpet, std::mt19937& rng) {
 		BrushMappingService::MapResult result;
 		const uint16_t id = item->getID();
 		if (id == 0) {
@@ -220,13 +220,13 @@ namespace {
 		result.matched = true;
 
 		const auto& toGroups = toCarpet->getItems().getGroups();
-		result.newId = CarpetBrushItems::pickFromGroup(toGroups[dir]);
+		result.newId = CarpetBrushItems::pickFromGroup(toGroups[dir], rng);
 		if (result.newId == 0) {
 			// Cascading fallback so a sparsely defined destination still swaps.
-			result.newId = CarpetBrushItems::pickFromGroup(toGroups[CARPET_CENTER]);
+			result.newId = CarpetBrushItems::pickFromGroup(toGroups[CARPET_CENTER], rng);
 		}
 		if (result.newId == 0) {
-			result.newId = CarpetBrushItems::pickFromGroup(toGroups[0]);
+			result.newId = CarpetBrushItems::pickFromGroup(toGroups[0], rng);
 		}
 		result.resolved = (result.newId != 0);
 		return result;
@@ -605,7 +605,7 @@ std::vector<uint16_t> BrushMappingService::GetItemIds(const Selection& selection
 	return ids;
 }
 
-BrushMappingService::MapResult BrushMappingService::MapItem(const Item* item, Brush* fromBrush, Brush* toBrush) {
+BrushMappingService::MapResult BrushMappingService::MapItem(const Item* item, Brush* fromBrush, Brush* toBrush, std::mt19937& rng) {
 	MapResult result;
 	if (!item || !fromBrush || !toBrush) {
 		return result;
@@ -616,7 +616,7 @@ BrushMappingService::MapResult BrushMappingService::MapItem(const Item* item, Br
 		if (!toGround) {
 			return result;
 		}
-		return MapGroundItem(item, fromGround, toGround);
+		return MapGroundItem(item, fromGround, toGround, rng);
 	}
 
 	if (auto* fromWall = fromBrush->as<WallBrush>()) {
@@ -624,7 +624,7 @@ BrushMappingService::MapResult BrushMappingService::MapItem(const Item* item, Br
 		if (!toWall) {
 			return result;
 		}
-		return MapWallItem(item, fromWall, toWall);
+		return MapWallItem(item, fromWall, toWall, rng);
 	}
 
 	if (auto* fromCarpet = fromBrush->as<CarpetBrush>()) {
@@ -632,7 +632,7 @@ BrushMappingService::MapResult BrushMappingService::MapItem(const Item* item, Br
 		if (!toCarpet) {
 			return result;
 		}
-		return MapCarpetItem(item, fromCarpet, toCarpet);
+		return MapCarpetItem(item, fromCarpet, toCarpet, rng);
 	}
 
 	return result;
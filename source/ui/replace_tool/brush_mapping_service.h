@@ -6,6 +6,7 @@
 #define RME_BRUSH_MAPPING_SERVICE_H_
 
 #include <cstdint>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -42,8 +43,10 @@ public:
 	// therefore be swapped by role.
 	static bool AreCompatible(const Brush* from, const Brush* to);
 
-	// Maps one concrete map item. Mutates nothing.
-	static MapResult MapItem(const Item* item, Brush* fromBrush, Brush* toBrush);
+	// Maps one concrete map item. Mutates nothing. Random variations of the
+	// destination are drawn from rng, so a seeded caller gets the same result
+	// on every run.
+	static MapResult MapItem(const Item* item, Brush* fromBrush, Brush* toBrush, std::mt19937& rng);
 
 	// Representative item id used to draw the brush icon on a rule card.
 	static uint16_t GetPreviewItemId(const Brush* brush);
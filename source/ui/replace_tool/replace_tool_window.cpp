@@ -495,47 +495,81 @@ void ReplaceToolWindow::OnExecute(wxCommandEvent&) {
 		}
 	}
 
-	int confirm = wxMessageBox(
-		"Are you sure you want to execute replacements on the map?",
-		"Confirm Bulk Replacement",
-		wxYES_NO | wxNO_DEFAULT | wxICON_WARNING
-	);
-
-	if (confirm != wxYES) {
-		return;
-	}
-
+	std::vector<Position> pv;
 	if (scope == ReplaceScope::Viewport) {
 		MapTab* activeTab = g_gui.GetCurrentMapTab();
-		if (activeTab && activeTab->GetCanvas()) {
-			MapCanvas* canvas = activeTab->GetCanvas();
-			wxSize canvasSize = canvas->GetClientSize();
+		if (!activeTab || !activeTab->GetCanvas()) {
+			return;
+		}
+		MapCanvas* canvas = activeTab->GetCanvas();
+		wxSize canvasSize = canvas->GetClientSize();
 
-			int startX, startY, endX, endY;
-			canvas->ScreenToMap(0, 0, &startX, &startY);
-			canvas->ScreenToMap(canvasSize.x, canvasSize.y, &endX, &endY);
+		int startX, startY, endX, endY;
+		canvas->ScreenToMap(0, 0, &startX, &startY);
+		canvas->ScreenToMap(canvasSize.x, canvasSize.y, &endX, &endY);
 
-			// Ensure bounds are consistent
-			if (startX > endX) {
-				std::swap(startX, endX);
-			}
-			if (startY > endY) {
-				std::swap(startY, endY);
-			}
+		// Ensure bounds are consistent
+		if (startX > endX) {
+			std::swap(startX, endX);
+		}
+		if (startY > endY) {
+			std::swap(startY, endY);
+		}
 
-			int z = canvas->GetFloor();
+		int z = canvas->GetFloor();
 
-			std::vector<Position> pv;
-			for (int x = startX; x <= endX; ++x) {
-				for (int y = startY; y <= endY; ++y) {
-					pv.push_back(Position(x, y, z));
-				}
+		for (int x = startX; x <= endX; ++x) {
+			for (int y = startY; y <= endY; ++y) {
+				pv.push_back(Position(x, y, z));
 			}
-			engine.ExecuteReplacement(editor, rules, scope, &pv);
 		}
-	} else {
-		engine.ExecuteReplacement(editor, rules, scope);
 	}
+	const std::vector<Position>* posVec = scope == ReplaceScope::Viewport ? &pv : nullptr;
+
+	// Dry run first, so the confirmation can say how much is about to change.
+	wxString confirmMsg = "Are you sure you want to execute replacements on the map?";
+	{
+		wxBusyCursor busy;
+		const ReplacementPreview preview = engine.PreviewReplacement(editor, rules, scope, posVec);
+		if (preview.totalMatches == 0) {
+			wxMessageBox("No item in the chosen scope matches any rule.", "Replace", wxOK | wxICON_INFORMATION);
+			return;
+		}
+		confirmMsg << "\n\n" << wxString::Format("%llu matching items on %llu tiles:", (unsigned long long)preview.totalMatches, (unsigned long long)preview.tilesMatched);
+		// Keeps the message box on screen with large rule sets
+		constexpr size_t MAX_LISTED_RULES = 10;
+		size_t listed = 0;
+		size_t unlisted = 0;
+		for (size_t i = 0; i < rules.size(); ++i) {
+			if (preview.matchesPerRule[i] == 0) {
+				continue;
+			}
+			if (listed == MAX_LISTED_RULES) {
+				++unlisted;
+				continue;
+			}
+			const ReplacementRule& r = rules[i];
+			const wxString source = r.isBrushRule() ? wxString(r.fromBrushName) : wxString::Format("item %d", r.fromId);
+			confirmMsg << "\n  - " << source << ": " << wxString::Format("%llu", (unsigned long long)preview.matchesPerRule[i]);
+			++listed;
+		}
+		if (unlisted > 0) {
+			confirmMsg << "\n  " << wxString::Format("... and %zu more rules", unlisted);
+		}
+	}
+
+	int confirm = wxMessageBox(
+		confirmMsg,
+		"Confirm Bulk Replacement",
+		wxYES_NO | wxNO_DEFAULT | wxICON_WARNING
+	);
+
+	if (confirm != wxYES) {
+		return;
+	}
+
+	wxBusyCursor busy;
+	engine.ExecuteReplacement(editor, rules, scope, posVec);
 }
 
 void ReplaceToolWindow::OnAddVisibleTiles(wxCommandEvent&) {
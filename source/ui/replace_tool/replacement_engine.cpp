@@ -1,9 +1,35 @@
 #include "app/main.h"
 #include "replacement_engine.h"
 
+#include "editor/editor.h"
+#include "editor/action.h"
+#include "editor/action_queue.h"
+#include "ui/gui.h"
+#include "map/map.h"
+#include "map/map_region.h"
+#include "map/spatial_hash_grid.h"
+#include "map/tile.h"
+#include "map/tile_operations.h"
+#include "game/item.h"
+#include "game/complexitem.h"
+#include "brushes/brush.h"
+#include "ui/replace_tool/brush_mapping_service.h"
+#include "util/parallel.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
 ReplacementEngine::ReplacementEngine() : rng(std::random_device {}()) { }
 
 bool ReplacementEngine::ResolveReplacement(uint16_t& resultId, const ReplacementRule& rule) {
+	return ResolveReplacement(resultId, rule, rng);
+}
+
+bool ReplacementEngine::ResolveReplacement(uint16_t& resultId, const ReplacementRule& rule, std::mt19937& rng) {
 	if (rule.targets.empty()) {
 		return false;
 	}
@@ -36,127 +62,189 @@ bool ReplacementEngine::ResolveReplacement(uint16_t& resultId, const Replacement
 	return false;
 }
 
-#include "editor/editor.h"
-#include "editor/action.h"
-#include "editor/action_queue.h"
-#include "ui/gui.h"
-#include "map/tile.h"
-#include "map/tile_operations.h"
-#include "game/item.h"
-#include "game/complexitem.h"
-#include "brushes/brush.h"
-#include "ui/replace_tool/brush_mapping_service.h"
-#include <algorithm>
-#include <functional>
-#include <map>
-#include <memory>
-#include <string>
-
-void ReplacementEngine::ExecuteReplacement(Editor* editor, const std::vector<ReplacementRule>& rules, ReplaceScope scope, const std::vector<Position>* posVec) {
-	if (rules.empty() || !editor) {
-		return;
-	}
-
-	// Item rules are keyed by source id; brush rules cannot be (their fromId is 0),
-	// so they live in a separate list that is only consulted when no item rule
-	// matched. That ordering is what gives item rules precedence.
-	std::map<uint16_t, const ReplacementRule*> ruleMap;
+namespace {
+	// Item rules are looked up by source id in a flat table (one slot per server
+	// id); brush rules cannot be (their fromId is 0), so they live in a separate
+	// list that is only consulted when no item rule matched. That ordering is
+	// what gives item rules precedence.
 	struct BrushRule {
-		const ReplacementRule* rule = nullptr;
+		int ruleIndex = -1;
 		Brush* from = nullptr;
 		Brush* to = nullptr;
 		int probability = 100;
 		bool trash = false;
 	};
-	std::vector<BrushRule> brushRules;
-
-	for (const auto& rule : rules) {
-		if (rule.isBrushRule()) {
-			// Pre-resolve the brushes once, outside the tile loop.
-			Brush* from = BrushMappingService::FindBrush(rule.fromBrushName);
-			if (!from) {
-				wxLogWarning("Advanced Replace: source brush '%s' not found; rule skipped.", rule.fromBrushName);
-				continue;
-			}
 
-			// A brush rule carries exactly one brush target (enforced by the UI).
-			const ReplacementTarget* brushTarget = nullptr;
-			for (const auto& t : rule.targets) {
-				if (t.kind == SlotKind::Brush) {
-					brushTarget = &t;
-					break;
-				}
-			}
+	struct CompiledRules {
+		std::vector<int32_t> itemRuleIndex; // server id -> index into rules, -1 when none
+		std::vector<BrushRule> brushRules;
 
-			BrushRule br;
-			br.rule = &rule;
-			br.from = from;
+		bool empty() const {
+			return brushRules.empty() && std::ranges::all_of(itemRuleIndex, [](int32_t idx) { return idx < 0; });
+		}
+	};
 
-			if (brushTarget) {
-				br.to = BrushMappingService::FindBrush(brushTarget->brushName);
-				if (!br.to) {
-					wxLogWarning("Advanced Replace: destination brush '%s' not found; rule skipped.", brushTarget->brushName);
-					continue;
-				}
-				if (!BrushMappingService::AreCompatible(from, br.to)) {
-					wxLogWarning("Advanced Replace: brushes '%s' and '%s' are not of the same family; rule skipped.", rule.fromBrushName, brushTarget->brushName);
+	CompiledRules CompileRules(const std::vector<ReplacementRule>& rules, bool logWarnings) {
+		CompiledRules compiled;
+		compiled.itemRuleIndex.assign(size_t(std::numeric_limits<uint16_t>::max()) + 1, -1);
+
+		for (size_t i = 0; i < rules.size(); ++i) {
+			const ReplacementRule& rule = rules[i];
+			if (rule.isBrushRule()) {
+				// Pre-resolve the brushes once, outside the tile loop.
+				Brush* from = BrushMappingService::FindBrush(rule.fromBrushName);
+				if (!from) {
+					if (logWarnings) {
+						wxLogWarning("Advanced Replace: source brush '%s' not found; rule skipped.", rule.fromBrushName);
+					}
 					continue;
 				}
-				br.probability = brushTarget->probability > 0 ? brushTarget->probability : 100;
-			} else {
-				// No brush target: only a REMOVE target makes sense here.
-				bool hasTrash = false;
+
+				// A brush rule carries exactly one brush target (enforced by the UI).
+				const ReplacementTarget* brushTarget = nullptr;
 				for (const auto& t : rule.targets) {
-					if (t.kind == SlotKind::Item && t.id == TRASH_ITEM_ID) {
-						hasTrash = true;
-						br.probability = t.probability > 0 ? t.probability : 100;
+					if (t.kind == SlotKind::Brush) {
+						brushTarget = &t;
 						break;
 					}
 				}
-				if (!hasTrash) {
-					continue; // incomplete rule
+
+				BrushRule br;
+				br.ruleIndex = static_cast<int>(i);
+				br.from = from;
+
+				if (brushTarget) {
+					br.to = BrushMappingService::FindBrush(brushTarget->brushName);
+					if (!br.to) {
+						if (logWarnings) {
+							wxLogWarning("Advanced Replace: destination brush '%s' not found; rule skipped.", brushTarget->brushName);
+						}
+						continue;
+					}
+					if (!BrushMappingService::AreCompatible(from, br.to)) {
+						if (logWarnings) {
+							wxLogWarning("Advanced Replace: brushes '%s' and '%s' are not of the same family; rule skipped.", rule.fromBrushName, brushTarget->brushName);
+						}
+						continue;
+					}
+					br.probability = brushTarget->probability > 0 ? brushTarget->probability : 100;
+				} else {
+					// No brush target: only a REMOVE target makes sense here.
+					bool hasTrash = false;
+					for (const auto& t : rule.targets) {
+						if (t.kind == SlotKind::Item && t.id == TRASH_ITEM_ID) {
+							hasTrash = true;
+							br.probability = t.probability > 0 ? t.probability : 100;
+							break;
+						}
+					}
+					if (!hasTrash) {
+						continue; // incomplete rule
+					}
+					br.trash = true;
 				}
-				br.trash = true;
-			}
 
-			brushRules.push_back(br);
-		} else if (rule.fromId != 0) {
-			ruleMap[rule.fromId] = &rule;
+				compiled.brushRules.push_back(br);
+			} else if (rule.fromId != 0) {
+				// A later rule for the same id wins, as it always has.
+				compiled.itemRuleIndex[rule.fromId] = static_cast<int32_t>(i);
+			}
 		}
-	}
 
-	if (ruleMap.empty() && brushRules.empty()) {
-		return;
+		return compiled;
 	}
 
-	const int mapW = editor->map.getWidth();
-	const int mapH = editor->map.getHeight();
+	// Which rule (if any) claims an item. For brush rules the mapping result is
+	// kept so the resolve step does not have to map the item a second time.
+	struct RuleMatch {
+		int ruleIndex = -1;
+		const BrushRule* brushRule = nullptr;
+		BrushMappingService::MapResult mapped;
 
-	// Every tile we touch is deep-copied once and kept here; a single Change is
-	// emitted per position at the end. This is mandatory: two Changes for the
-	// same tile inside one Action would make the second silently overwrite the
-	// first, losing edits.
-	std::map<Position, std::unique_ptr<Tile>> pendingTiles;
+		explicit operator bool() const {
+			return ruleIndex >= 0;
+		}
+	};
 
-	auto acquireTile = [&](const Position& pos, bool createIfMissing) -> Tile* {
-		auto it = pendingTiles.find(pos);
-		if (it != pendingTiles.end()) {
-			return it->second.get();
+	RuleMatch MatchItem(const CompiledRules& compiled, const Item* item, std::mt19937& rng) {
+		RuleMatch match;
+		const int32_t idx = compiled.itemRuleIndex[item->getID()];
+		if (idx >= 0) {
+			match.ruleIndex = idx;
+			return match;
 		}
-		Tile* live = editor->map.getTile(pos);
-		if (!live) {
-			if (!createIfMissing) {
-				return nullptr;
+
+		for (const auto& br : compiled.brushRules) {
+			// A REMOVE target only needs to know whether the item belongs to
+			// the source brush, so map it onto itself.
+			BrushMappingService::MapResult res = BrushMappingService::MapItem(item, br.from, br.trash ? br.from : br.to, rng);
+			if (!res.matched) {
+				continue;
 			}
-			live = editor->map.getOrCreateTile(pos);
-			if (!live) {
-				return nullptr;
+			match.ruleIndex = br.ruleIndex;
+			match.brushRule = &br;
+			match.mapped = res;
+			return match;
+		}
+		return match;
+	}
+
+	// Rolls the probabilities of a matched rule. Returns false when the roll
+	// decides to keep the original item.
+	bool ResolveMatch(const RuleMatch& match, const std::vector<ReplacementRule>& rules, std::mt19937& rng, uint16_t& newId) {
+		if (!match.brushRule) {
+			return ReplacementEngine::ResolveReplacement(newId, rules[match.ruleIndex], rng);
+		}
+
+		const BrushRule& br = *match.brushRule;
+		if (br.probability < 100) {
+			std::uniform_int_distribution<int> dist(1, 100);
+			if (dist(rng) > br.probability) {
+				return false;
 			}
 		}
-		auto copy = TileOperations::deepCopy(live, editor->map);
-		Tile* raw = copy.get();
-		pendingTiles.emplace(pos, std::move(copy));
-		return raw;
+		if (br.trash) {
+			newId = TRASH_ITEM_ID;
+			return true;
+		}
+		if (!match.mapped.resolved) {
+			// Belongs to the brush but has no equivalent: keep the original
+			// item instead of leaving a hole (safe failure).
+			return false;
+		}
+		newId = match.mapped.newId;
+		return true;
+	}
+
+	// One independent unit of work: the tiles of a single grid cell. Seeding the
+	// generator from the cell coordinates (not from the thread that happens to
+	// run it) keeps a run reproducible for a given base seed however the cells
+	// are distributed over the workers.
+	struct WorkUnit {
+		int cx = 0;
+		int cy = 0;
+		const SpatialHashGrid::GridCell* cell = nullptr; // AllMap: walk the whole cell
+		std::vector<Tile*> tiles; // Selection/Viewport: explicit tile list
+	};
+
+	uint64_t MixSeed(uint64_t base, int cx, int cy) {
+		// splitmix64 finalizer over the base seed and packed cell coordinates.
+		uint64_t z = base ^ ((uint64_t(uint32_t(cy)) << 32) | uint32_t(cx));
+		z += 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// A decision taken by a worker against the live map. Workers never copy or
+	// touch tiles: the map's lookup cache and tile allocation are not thread
+	// safe, so the edits are applied on the UI thread once every cell is done.
+	struct ItemEdit {
+		Tile* tile = nullptr;
+		// First entry: -1 for ground, otherwise index into tile->items; the
+		// remaining entries walk nested containers.
+		std::vector<int> path;
+		uint16_t newId = 0; // TRASH_ITEM_ID => clear the item in place
 	};
 
 	// Relocations (offset != 0) must be deferred: we cannot place a new item on a
@@ -168,154 +256,70 @@ void ReplacementEngine::ExecuteReplacement(Editor* editor, const std::vector<Rep
 		Position targetPos;
 		uint16_t newId = 0; // TRASH_ITEM_ID => delete the source only, create nothing
 	};
-	std::vector<PendingMove> pendingMoves;
-
-	// Resolves the replacement id for one item, checking item rules first and
-	// falling back to brush rules. outRule is set so the caller can read offsets.
-	auto resolveForItem = [&](const Item* item, uint16_t& newId, const ReplacementRule*& outRule) -> bool {
-		auto it = ruleMap.find(item->getID());
-		if (it != ruleMap.end()) {
-			const ReplacementRule* rule = it->second;
-			if (!ResolveReplacement(newId, *rule)) {
-				return false;
-			}
-			outRule = rule;
-			return true;
-		}
 
-		for (const auto& br : brushRules) {
-			BrushMappingService::MapResult res;
-			if (br.trash) {
-				// A REMOVE target only needs to know whether the item belongs to
-				// the source brush, so map it onto itself.
-				res = BrushMappingService::MapItem(item, br.from, br.from);
-			} else {
-				res = BrushMappingService::MapItem(item, br.from, br.to);
-			}
-			if (!res.matched) {
-				continue;
-			}
-			if (br.probability < 100) {
-				std::uniform_int_distribution<int> dist(1, 100);
-				if (dist(rng) > br.probability) {
-					return false;
-				}
-			}
-			if (br.trash) {
-				newId = TRASH_ITEM_ID;
-				outRule = br.rule;
-				return true;
-			}
-			if (!res.resolved) {
-				// Belongs to the brush but has no equivalent: keep the original
-				// item instead of leaving a hole (safe failure).
-				return false;
-			}
-			newId = res.newId;
-			outRule = br.rule;
-			return true;
-		}
+	struct ChunkResult {
+		std::vector<ItemEdit> edits;
+		std::vector<PendingMove> moves;
+		std::vector<uint64_t> matches; // per rule
+		uint64_t tilesMatched = 0;
+	};
 
-		return false;
+	struct ScanContext {
+		const std::vector<ReplacementRule>& rules;
+		const CompiledRules& compiled;
+		int mapW;
+		int mapH;
+		uint64_t baseSeed;
+		bool dryRun;
 	};
 
-	auto tileProcessor = [&](Tile* liveTile) {
-		if (!liveTile) {
-			return;
-		}
+	void ProcessTile(const ScanContext& ctx, Tile* liveTile, std::mt19937& rng, ChunkResult& out) {
 		const Position tilePos = liveTile->getPosition();
-
-		// First pass over the live tile: decide what changes, and whether a copy
-		// is needed at all. We only deep-copy tiles that actually change.
-		Tile* work = nullptr;
-		auto ensureWork = [&]() -> Tile* {
-			if (!work) {
-				work = acquireTile(tilePos, false);
-			}
-			return work;
-		};
+		bool tileMatched = false;
 
 		// Applies a rule to a single item. relocatable is false for items nested
 		// inside containers, which can only be replaced in place.
-		// itemIndex: -1 for ground, otherwise index into tile->items.
-		auto apply = [&](const Item* liveItem, int itemIndex, bool relocatable) -> void {
+		auto apply = [&](const Item* liveItem, std::vector<int> path, bool relocatable) {
+			const RuleMatch match = MatchItem(ctx.compiled, liveItem, rng);
+			if (!match) {
+				return;
+			}
+			++out.matches[match.ruleIndex];
+			tileMatched = true;
+			if (ctx.dryRun) {
+				return;
+			}
+
 			uint16_t newId = 0;
-			const ReplacementRule* rule = nullptr;
-			if (!resolveForItem(liveItem, newId, rule)) {
+			if (!ResolveMatch(match, ctx.rules, rng, newId)) {
 				return;
 			}
 
-			const bool hasOffset = (rule->offsetX != 0 || rule->offsetY != 0);
+			const ReplacementRule& rule = ctx.rules[match.ruleIndex];
+			const bool hasOffset = (rule.offsetX != 0 || rule.offsetY != 0);
 			if (hasOffset && relocatable) {
-				Position target = tilePos + Position(rule->offsetX, rule->offsetY, 0);
-				const bool targetOk = target.isValid() && target.x >= 0 && target.y >= 0 && target.x < mapW && target.y < mapH;
+				Position target = tilePos + Position(rule.offsetX, rule.offsetY, 0);
+				const bool targetOk = target.isValid() && target.x >= 0 && target.y >= 0 && target.x < ctx.mapW && target.y < ctx.mapH;
 				if (targetOk) {
 					// Move: the source is removed and the item recreated at the
 					// offset target in a later phase. Nothing is touched now, so
 					// the recorded index stays valid.
-					pendingMoves.push_back({ tilePos, itemIndex, target, newId });
+					out.moves.push_back({ tilePos, path[0], target, newId });
 					return;
 				}
 				// Out-of-bounds target: fall through to in-place so nothing is lost.
 			}
 
-			// In-place replacement on the working copy.
-			Tile* w = ensureWork();
-			if (!w) {
-				return;
-			}
-			Item* target = nullptr;
-			if (itemIndex < 0) {
-				target = w->ground.get();
-			} else if (itemIndex < (int)w->items.size()) {
-				target = w->items[itemIndex].get();
-			}
-			if (target) {
-				target->setID(newId == TRASH_ITEM_ID ? 0 : newId);
-			}
-		};
-
-		// Nested container items can only be replaced in place. We resolve them
-		// against the live tile but must edit the copy, so they are walked in
-		// lockstep by index path.
-		auto applyNested = [&](const Item* liveItem, const std::vector<int>& path) -> void {
-			uint16_t newId = 0;
-			const ReplacementRule* rule = nullptr;
-			if (!resolveForItem(liveItem, newId, rule)) {
-				return;
-			}
-			Tile* w = ensureWork();
-			if (!w) {
-				return;
-			}
-			// Walk the same index path on the copy.
-			if (path.empty() || path[0] >= (int)w->items.size()) {
-				return;
-			}
-			Item* cur = w->items[path[0]].get();
-			for (size_t p = 1; p < path.size() && cur; ++p) {
-				Container* c = cur->asContainer();
-				if (!c) {
-					return;
-				}
-				auto& v = c->getVector();
-				if (path[p] >= (int)v.size()) {
-					return;
-				}
-				cur = v[path[p]].get();
-			}
-			if (cur) {
-				cur->setID(newId == TRASH_ITEM_ID ? 0 : newId);
-			}
+			out.edits.push_back({ liveTile, std::move(path), newId });
 		};
 
 		if (liveTile->ground) {
-			apply(liveTile->ground.get(), -1, true);
+			apply(liveTile->ground.get(), { -1 }, true);
 		}
 
 		for (size_t i = 0; i < liveTile->items.size(); ++i) {
 			Item* item = liveTile->items[i].get();
-			apply(item, (int)i, true);
+			apply(item, { (int)i }, true);
 
 			Container* container = item->asContainer();
 			if (!container) {
@@ -335,28 +339,225 @@ void ReplacementEngine::ExecuteReplacement(Editor* editor, const std::vector<Rep
 				for (size_t k = 0; k < v.size(); ++k) {
 					std::vector<int> childPath = frame.path;
 					childPath.push_back((int)k);
-					applyNested(v[k].get(), childPath);
 					if (Container* c = v[k]->asContainer()) {
 						stack.push_back({ c, childPath });
 					}
+					apply(v[k].get(), std::move(childPath), false);
 				}
 			}
 		}
-	};
 
-	if (scope == ReplaceScope::Viewport && posVec) {
-		for (const auto& pos : *posVec) {
-			tileProcessor(editor->map.getTile(pos));
+		if (tileMatched) {
+			++out.tilesMatched;
+		}
+	}
+
+	ChunkResult ProcessUnits(const ScanContext& ctx, const std::vector<WorkUnit>& units, size_t start_idx, size_t end_idx) {
+		ChunkResult out;
+		out.matches.assign(ctx.rules.size(), 0);
+
+		for (size_t i = start_idx; i < end_idx; ++i) {
+			const WorkUnit& unit = units[i];
+			std::mt19937 rng(static_cast<std::mt19937::result_type>(MixSeed(ctx.baseSeed, unit.cx, unit.cy)));
+
+			if (!unit.cell) {
+				for (Tile* tile : unit.tiles) {
+					ProcessTile(ctx, tile, rng, out);
+				}
+				continue;
+			}
+
+			for (const auto& node_ptr : unit.cell->nodes) {
+				MapNode* node = node_ptr.get();
+				if (!node) {
+					continue;
+				}
+				for (int z = 0; z <= MAP_MAX_LAYER; ++z) {
+					Floor* floor = node->getFloor(z);
+					if (!floor) {
+						continue;
+					}
+					for (TileLocation& loc : floor->locs) {
+						if (Tile* tile = loc.get()) {
+							ProcessTile(ctx, tile, rng, out);
+						}
+					}
+				}
+			}
 		}
-	} else if (scope == ReplaceScope::Selection && !editor->selection.empty()) {
-		for (Tile* tile : editor->selection.getTiles()) {
-			tileProcessor(tile);
+		return out;
+	}
+
+	std::vector<WorkUnit> BuildWorkUnits(Editor* editor, const std::vector<ReplacementRule>& rules, const CompiledRules& compiled, ReplaceScope scope, const std::vector<Position>* posVec) {
+		std::vector<WorkUnit> units;
+
+		if (scope == ReplaceScope::AllMap && compiled.brushRules.empty()) {
+			// Item rules only: the map index knows which cells hold any source
+			// id, the rest of the map cannot match and is never visited.
+			std::vector<MapIndex::CellKey> keys;
+			for (const auto& rule : rules) {
+				if (!rule.isBrushRule() && rule.fromId != 0) {
+					const auto& cells = editor->map.index.cellsContaining(rule.fromId);
+					keys.insert(keys.end(), cells.begin(), cells.end());
+				}
+			}
+			std::ranges::sort(keys);
+			keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+			const SpatialHashGrid& grid = editor->map.getGrid();
+			for (MapIndex::CellKey key : keys) {
+				WorkUnit unit;
+				SpatialHashGrid::getCellCoordsFromKey(key, unit.cx, unit.cy);
+				unit.cell = grid.findCell(key);
+				if (unit.cell) {
+					units.push_back(std::move(unit));
+				}
+			}
+			return units;
+		}
+
+		if (scope == ReplaceScope::AllMap) {
+			for (const auto& sorted : editor->map.getGrid().getSortedCells()) {
+				units.push_back({ sorted.cx, sorted.cy, sorted.cell, {} });
+			}
+			return units;
+		}
+
+		// Explicit tile lists are resolved here, on the calling thread, and
+		// bucketed by cell so they seed exactly like the whole-map scan does.
+		std::vector<Tile*> tiles;
+		if (scope == ReplaceScope::Viewport && posVec) {
+			tiles.reserve(posVec->size());
+			for (const auto& pos : *posVec) {
+				if (Tile* tile = editor->map.getTile(pos)) {
+					tiles.push_back(tile);
+				}
+			}
+		} else if (scope == ReplaceScope::Selection && !editor->selection.empty()) {
+			tiles = editor->selection.getTiles();
 		}
-	} else if (scope == ReplaceScope::AllMap) {
-		auto allMapTileProcessor = [&tileProcessor](Map&, Tile* tile, long long) {
-			tileProcessor(tile);
+
+		auto cellOf = [](const Tile* tile) {
+			const Position pos = tile->getPosition();
+			return std::pair<int, int>(pos.x >> SpatialHashGrid::CELL_SHIFT, pos.y >> SpatialHashGrid::CELL_SHIFT);
 		};
-		foreach_TileOnMap(editor->map, allMapTileProcessor);
+		std::ranges::stable_sort(tiles, [&](const Tile* a, const Tile* b) {
+			const auto ca = cellOf(a);
+			const auto cb = cellOf(b);
+			return std::tie(ca.second, ca.first) < std::tie(cb.second, cb.first);
+		});
+
+		for (Tile* tile : tiles) {
+			const auto [cx, cy] = cellOf(tile);
+			if (units.empty() || units.back().cx != cx || units.back().cy != cy) {
+				units.push_back({ cx, cy, nullptr, {} });
+			}
+			units.back().tiles.push_back(tile);
+		}
+		return units;
+	}
+
+	std::vector<ChunkResult> RunScan(const ScanContext& ctx, const std::vector<WorkUnit>& units) {
+		// Chunks are contiguous ranges of cells and come back in order, which
+		// keeps the edits in scan order. A handful of cells stays on one thread.
+		return parallelFor(0, units.size(), 8, [&ctx, &units](size_t start, size_t end) {
+			return ProcessUnits(ctx, units, start, end);
+		});
+	}
+}
+
+ReplacementPreview ReplacementEngine::PreviewReplacement(Editor* editor, const std::vector<ReplacementRule>& rules, ReplaceScope scope, const std::vector<Position>* posVec) {
+	ReplacementPreview preview;
+	preview.matchesPerRule.assign(rules.size(), 0);
+	if (rules.empty() || !editor) {
+		return preview;
+	}
+
+	const CompiledRules compiled = CompileRules(rules, false);
+	if (compiled.empty()) {
+		return preview;
+	}
+
+	const ScanContext ctx { rules, compiled, editor->map.getWidth(), editor->map.getHeight(), 0, true };
+	for (const ChunkResult& chunk : RunScan(ctx, BuildWorkUnits(editor, rules, compiled, scope, posVec))) {
+		for (size_t i = 0; i < chunk.matches.size(); ++i) {
+			preview.matchesPerRule[i] += chunk.matches[i];
+			preview.totalMatches += chunk.matches[i];
+		}
+		preview.tilesMatched += chunk.tilesMatched;
+	}
+	return preview;
+}
+
+void ReplacementEngine::ExecuteReplacement(Editor* editor, const std::vector<ReplacementRule>& rules, ReplaceScope scope, const std::vector<Position>* posVec) {
+	if (rules.empty() || !editor) {
+		return;
+	}
+
+	const CompiledRules compiled = CompileRules(rules, true);
+	if (compiled.empty()) {
+		return;
+	}
+
+	// One draw from the engine generator per run; every cell derives its own
+	// generator from it.
+	const ScanContext ctx { rules, compiled, editor->map.getWidth(), editor->map.getHeight(), (uint64_t(rng()) << 32) | rng(), false };
+	std::vector<ChunkResult> chunks = RunScan(ctx, BuildWorkUnits(editor, rules, compiled, scope, posVec));
+
+	// Every tile we touch is deep-copied once and kept here; a single Change is
+	// emitted per position at the end. This is mandatory: two Changes for the
+	// same tile inside one Action would make the second silently overwrite the
+	// first, losing edits.
+	std::map<Position, std::unique_ptr<Tile>> pendingTiles;
+
+	auto acquireTile = [&](const Position& pos, bool createIfMissing) -> Tile* {
+		auto it = pendingTiles.find(pos);
+		if (it != pendingTiles.end()) {
+			return it->second.get();
+		}
+		Tile* live = editor->map.getTile(pos);
+		if (!live) {
+			if (!createIfMissing) {
+				return nullptr;
+			}
+			live = editor->map.getOrCreateTile(pos);
+			if (!live) {
+				return nullptr;
+			}
+		}
+		auto copy = TileOperations::deepCopy(live, editor->map);
+		Tile* raw = copy.get();
+		pendingTiles.emplace(pos, std::move(copy));
+		return raw;
+	};
+
+	// In-place replacements: the workers resolved them against the live tile,
+	// the same index path is walked on the copy.
+	for (const ChunkResult& chunk : chunks) {
+		for (const ItemEdit& edit : chunk.edits) {
+			Tile* w = acquireTile(edit.tile->getPosition(), false);
+			if (!w || edit.path.empty()) {
+				continue;
+			}
+			Item* cur = nullptr;
+			if (edit.path[0] < 0) {
+				cur = w->ground.get();
+			} else if (edit.path[0] < (int)w->items.size()) {
+				cur = w->items[edit.path[0]].get();
+			}
+			for (size_t p = 1; p < edit.path.size() && cur; ++p) {
+				Container* c = cur->asContainer();
+				if (!c) {
+					cur = nullptr;
+					break;
+				}
+				auto& v = c->getVector();
+				cur = edit.path[p] < (int)v.size() ? v[edit.path[p]].get() : nullptr;
+			}
+			if (cur) {
+				cur->setID(edit.newId == TRASH_ITEM_ID ? 0 : edit.newId);
+			}
+		}
 	}
 
 	// Apply deferred relocations. Remove every source first (descending index per
@@ -365,8 +566,10 @@ void ReplacementEngine::ExecuteReplacement(Editor* editor, const std::vector<Rep
 	// is both a source and a target still yields a single Change.
 	{
 		std::map<Position, std::vector<int>> removalsByPos;
-		for (const auto& mv : pendingMoves) {
-			removalsByPos[mv.sourcePos].push_back(mv.sourceIndex);
+		for (const ChunkResult& chunk : chunks) {
+			for (const auto& mv : chunk.moves) {
+				removalsByPos[mv.sourcePos].push_back(mv.sourceIndex);
+			}
 		}
 		for (auto& [pos, indices] : removalsByPos) {
 			Tile* w = acquireTile(pos, false);
@@ -383,13 +586,15 @@ void ReplacementEngine::ExecuteReplacement(Editor* editor, const std::vector<Rep
 			}
 		}
 	}
-	for (const auto& mv : pendingMoves) {
-		if (mv.newId == TRASH_ITEM_ID) {
-			continue; // delete-only, no item to create
-		}
-		Tile* w = acquireTile(mv.targetPos, true);
-		if (w) {
-			w->addItem(Item::Create(mv.newId));
+	for (const ChunkResult& chunk : chunks) {
+		for (const auto& mv : chunk.moves) {
+			if (mv.newId == TRASH_ITEM_ID) {
+				continue; // delete-only, no item to create
+			}
+			Tile* w = acquireTile(mv.targetPos, true);
+			if (w) {
+				w->addItem(Item::Create(mv.newId));
+			}
 		}
 	}
 
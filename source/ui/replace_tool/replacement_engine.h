@@ -4,6 +4,7 @@
 #include "app/main.h"
 #include "rule_manager.h"
 #include "map/position.h"
+#include <cstdint>
 #include <random>
 #include <vector>
 
@@ -13,6 +14,15 @@ enum class ReplaceScope {
 	AllMap
 };
 
+// Result of a dry run: how many items each rule's source matches in the scope.
+// Probabilities are not rolled, so this is the upper bound of what an execution
+// would touch.
+struct ReplacementPreview {
+	std::vector<uint64_t> matchesPerRule; // parallel to the rules passed in
+	uint64_t totalMatches = 0;
+	uint64_t tilesMatched = 0;
+};
+
 class ReplacementEngine {
 public:
 	ReplacementEngine();
@@ -20,11 +30,19 @@ public:
 	// Resolve the 1:N probability rule
 	// Returns true if a replacement should happen, resultId contains the new ID
 	bool ResolveReplacement(uint16_t& resultId, const ReplacementRule& rule);
+	// Same, drawing from the given generator (used by the per-cell workers).
+	static bool ResolveReplacement(uint16_t& resultId, const ReplacementRule& rule, std::mt19937& rng);
 
 	// Execute the replacement on the map
 	// If scope is Viewport, posVec must contain the tiles to process.
+	// The scope is evaluated per SpatialHashGrid cell in parallel, each cell with
+	// its own generator seeded from the cell coordinates, and the result lands
+	// as a single undoable batch.
 	void ExecuteReplacement(class Editor* editor, const std::vector<ReplacementRule>& rules, ReplaceScope scope, const std::vector<Position>* posVec = nullptr);
 
+	// Dry run: counts matches per rule without copying or changing any tile.
+	ReplacementPreview PreviewReplacement(class Editor* editor, const std::vector<ReplacementRule>& rules, ReplaceScope scope, const std::vector<Position>* posVec = nullptr);
+
 private:
 	std::mt19937 rng;
 };
@@ -155,6 +155,13 @@ int random(int low, int high) {
 	return uniform_random(low, high);
 }
 
+int random(std::mt19937& rng, int low, int high) {
+	if (low > high) {
+		std::swap(low, high);
+	}
+	return std::uniform_int_distribution<int>(low, high)(rng);
+}
+
 int random(int high) {
 	return random(0, high);
 }
@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <cmath>
+#include <random>
 #include <iomanip>
 #include <string>
 #include <string_view>
@@ -81,6 +82,10 @@ bool isTrueString(const std::string& str);
 // Swaps low and high if low > high for a more intuitive behavior.
 int random(int high);
 int random(int low, int high);
+// Same, drawing from the given generator instead of the thread's own one.
+int random(std::mt19937& rng, int low, int high);
+// The calling thread's generator, used by the overloads above.
+std::mt19937& getRandomGenerator();
 
 // Unicode conversions
 std::wstring string2wstring(const std::string& utf8string);
@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////
+// This file is part of Remere's Map Editor
+//////////////////////////////////////////////////////////////////////
+// Remere's Map Editor is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Remere's Map Editor is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef RME_PARALLEL_H_
+#define RME_PARALLEL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Runs fn(start, end) over [first, last) split into contiguous chunks, one per
+// worker thread (as many as the hardware has, at most 16). Every chunk holds
+// at least min_chunk elements, so short ranges use fewer threads and ranges
+// shorter than two chunks run on the calling thread. If fn returns a value,
+// parallelFor returns those values in chunk order.
+template <typename Fn>
+auto parallelFor(size_t first, size_t last, size_t min_chunk, Fn&& fn) {
+	using Result = std::invoke_result_t<Fn&, size_t, size_t>;
+
+	const size_t count = last > first ? last - first : 0;
+	size_t num_threads = std::thread::hardware_concurrency();
+	if (num_threads == 0) {
+		num_threads = 2;
+	}
+	num_threads = std::clamp<size_t>(count / std::max<size_t>(min_chunk, 1), 1, std::min<size_t>(num_threads, 16));
+	const size_t chunk_size = (count + num_threads - 1) / num_threads;
+
+	std::vector<std::future<Result>> futures;
+	if (count != 0 && num_threads > 1) {
+		futures.reserve(num_threads);
+		for (size_t start = first; start < last; start += chunk_size) {
+			const size_t end = std::min(start + chunk_size, last);
+			futures.push_back(std::async(std::launch::async, [&fn, start, end]() {
+				return fn(start, end);
+			}));
+		}
+	}
+
+	if constexpr (std::is_void_v<Result>) {
+		if (count != 0 && num_threads == 1) {
+			fn(first, last);
+		}
+		for (auto& future : futures) {
+			future.get();
+		}
+	} else {
+		std::vector<Result> results;
+		if (count != 0 && num_threads == 1) {
+			results.push_back(fn(first, last));
+		}
+		for (auto& future : futures) {
+			results.push_back(future.get());
+		}
+		return results;
+	}
+}
+
+#endif